@@ -0,0 +1,75 @@
+/* Copyright 2020, Ekumen
+ * Binary serialization benchmark
+ * Author: Steven Desvars, 2020
+ *
+ * Compares passing poses through round trip text against the binary
+ * encoding and an in-place view.
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include <isometry/binary.hpp>
+#include <isometry/format.hpp>
+
+namespace {
+
+using ekumen::math::FormatMode;
+using ekumen::math::Isometry;
+using ekumen::math::IsometryView;
+using ekumen::math::Vector3;
+using ekumen::math::binarySize;
+using ekumen::math::kFormatBufferSize;
+
+const int kPoses{1000};
+const int kRepetitions{200};
+
+double elapsedSeconds(const std::chrono::steady_clock::time_point& start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                       start)
+      .count();
+}
+
+void report(const char* name, const double seconds) {
+  std::printf("%-22s %8.3f Mposes/s\n", name,
+              kPoses * kRepetitions / seconds * 1e-6);
+}
+
+}  // namespace
+
+int main() {
+  std::vector<Isometry> poses;
+  for (int i = 0; i < kPoses; ++i) {
+    poses.push_back(
+        Isometry::fromTranslation(Vector3(std::sin(i), 0.01 * i, 1.5)) *
+        Isometry::fromEulerAngles(0.001 * i, 0.2, -0.003 * i));
+  }
+  double total{0.};
+
+  char text[kFormatBufferSize];
+  Isometry parsed;
+  auto start = std::chrono::steady_clock::now();
+  for (int r = 0; r < kRepetitions; ++r) {
+    for (const Isometry& pose : poses) {
+      const std::size_t length =
+          format(pose, text, kFormatBufferSize, FormatMode::kRoundTrip);
+      parse(text, length, &parsed);
+      total += parsed.translation().x();
+    }
+  }
+  report("text round trip", elapsedSeconds(start));
+
+  std::vector<unsigned char> buffer(binarySize<Isometry>(kPoses));
+  start = std::chrono::steady_clock::now();
+  for (int r = 0; r < kRepetitions; ++r) {
+    encode(poses.data(), poses.size(), buffer.data(), buffer.size());
+    const IsometryView view{buffer.data(), buffer.size()};
+    for (std::size_t i = 0; i < view.size(); ++i) {
+      total += view[i].translation().x();
+    }
+  }
+  report("binary round trip", elapsedSeconds(start));
+  return total == 0.;
+}
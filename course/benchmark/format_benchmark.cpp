@@ -0,0 +1,87 @@
+/* Copyright 2020, Ekumen
+ * Text formatting benchmark
+ * Author: Steven Desvars, 2020
+ *
+ * Compares printing poses with operator<< into a std::stringstream against
+ * format() into a fixed buffer, and parsing them back.
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <isometry/format.hpp>
+
+namespace {
+
+using ekumen::math::FormatMode;
+using ekumen::math::Isometry;
+using ekumen::math::Vector3;
+using ekumen::math::kFormatBufferSize;
+
+const int kPoses{1000};
+const int kRepetitions{100};
+
+double elapsedSeconds(const std::chrono::steady_clock::time_point& start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                       start)
+      .count();
+}
+
+void report(const char* name, const double seconds) {
+  std::printf("%-22s %8.3f Mposes/s\n", name,
+              kPoses * kRepetitions / seconds * 1e-6);
+}
+
+}  // namespace
+
+int main() {
+  std::vector<Isometry> poses;
+  for (int i = 0; i < kPoses; ++i) {
+    poses.push_back(
+        Isometry::fromTranslation(Vector3(std::sin(i), 0.01 * i, 1.5)) *
+        Isometry::fromEulerAngles(0.001 * i, 0.2, -0.003 * i));
+  }
+  std::size_t total{0};
+
+  auto start = std::chrono::steady_clock::now();
+  for (int r = 0; r < kRepetitions; ++r) {
+    for (const Isometry& pose : poses) {
+      std::stringstream ss;
+      ss << pose;
+      total += ss.str().size();
+    }
+  }
+  report("operator<<", elapsedSeconds(start));
+
+  char buffer[kFormatBufferSize];
+  for (const FormatMode mode : {FormatMode::kLegacy, FormatMode::kRoundTrip}) {
+    start = std::chrono::steady_clock::now();
+    for (int r = 0; r < kRepetitions; ++r) {
+      for (const Isometry& pose : poses) {
+        total += format(pose, buffer, kFormatBufferSize, mode);
+      }
+    }
+    report(mode == FormatMode::kLegacy ? "format legacy" : "format round trip",
+           elapsedSeconds(start));
+  }
+
+  std::vector<std::string> texts;
+  for (const Isometry& pose : poses) {
+    const std::size_t length =
+        format(pose, buffer, kFormatBufferSize, FormatMode::kRoundTrip);
+    texts.emplace_back(buffer, length);
+  }
+  Isometry parsed;
+  start = std::chrono::steady_clock::now();
+  for (int r = 0; r < kRepetitions; ++r) {
+    for (const std::string& text : texts) {
+      total += parse(text.data(), text.size(), &parsed);
+    }
+  }
+  report("parse", elapsedSeconds(start));
+  return total == 0;
+}
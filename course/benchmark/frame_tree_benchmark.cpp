@@ -0,0 +1,134 @@
+/* Copyright 2020, Ekumen
+ * Frame tree contention benchmark
+ * Author: Steven Desvars, 2020
+ *
+ * Compares lookup throughput of a mutex-protected FrameTree against the
+ * epoch-based ConcurrentFrameTree, queried by name and by FrameId handle,
+ * from 1 to 64 reader threads, while a writer updates a pose at 200 Hz.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <isometry/concurrent_frame_tree.hpp>
+
+namespace {
+
+using ekumen::math::ConcurrentFrameTree;
+using ekumen::math::FrameId;
+using ekumen::math::FrameTree;
+using ekumen::math::Isometry;
+using ekumen::math::Vector3;
+
+const std::chrono::milliseconds kDuration{300};
+const std::chrono::milliseconds kWriterPeriod{5};
+const int kFrames{32};
+
+FrameTree makeTree() {
+  FrameTree tree{"map"};
+  tree.addFrame("odom", "map", Isometry());
+  tree.addFrame("base", "odom", Isometry());
+  for (int i = 0; i < kFrames; ++i) {
+    tree.addFrame("sensor_" + std::to_string(i), "base",
+                  Isometry::fromTranslation(Vector3(0.1 * i, 0., 1.)));
+  }
+  return tree;
+}
+
+Isometry pose(const int i) {
+  return Isometry::fromTranslation(Vector3(0.01 * i, 0., 0.)) *
+         Isometry::rotateAround(Vector3::kUnitZ, 0.001 * i);
+}
+
+// Runs the readers and a 200 Hz writer, returns lookups per second.
+template <class Read, class Write>
+double run(const int readers, Read read, Write write) {
+  std::atomic<bool> done{false};
+  std::atomic<long> lookups{0};
+  std::vector<std::thread> threads;
+  for (int i = 0; i < readers; ++i) {
+    threads.emplace_back([&, i]() {
+      const std::string source = "sensor_" + std::to_string(i % kFrames);
+      long count = 0;
+      read(source, &done, &count);
+      lookups += count;
+    });
+  }
+  std::thread writer([&]() {
+    for (int i = 0; !done.load(); ++i) {
+      write(pose(i));
+      std::this_thread::sleep_for(kWriterPeriod);
+    }
+  });
+  std::this_thread::sleep_for(kDuration);
+  done.store(true);
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  writer.join();
+  return lookups.load() / std::chrono::duration<double>(kDuration).count();
+}
+
+}  // namespace
+
+int main() {
+  std::printf("%8s %16s %16s %16s\n", "readers", "mutex lookups/s",
+              "rcu lookups/s", "rcu id lookups/s");
+  for (int readers = 1; readers <= 64; readers *= 2) {
+    FrameTree locked_tree{makeTree()};
+    std::mutex mutex;
+    const double locked = run(
+        readers,
+        [&](const std::string& source, std::atomic<bool>* done,
+            long* count) {
+          while (!done->load(std::memory_order_relaxed)) {
+            std::lock_guard<std::mutex> lock{mutex};
+            locked_tree.lookup("map", source);
+            ++*count;
+          }
+        },
+        [&](const Isometry& r_pose) {
+          std::lock_guard<std::mutex> lock{mutex};
+          locked_tree.setTransform("base", r_pose);
+          locked_tree.updateWorldPoses();
+        });
+
+    ConcurrentFrameTree rcu_tree{makeTree()};
+    const double rcu = run(
+        readers,
+        [&](const std::string& source, std::atomic<bool>* done,
+            long* count) {
+          ConcurrentFrameTree::Reader reader{rcu_tree.reader()};
+          while (!done->load(std::memory_order_relaxed)) {
+            reader.lookup("map", source);
+            ++*count;
+          }
+        },
+        [&](const Isometry& r_pose) {
+          rcu_tree.setTransform("base", r_pose);
+        });
+
+    ConcurrentFrameTree id_tree{makeTree()};
+    const FrameId base{id_tree.reader().id("base")};
+    const double ids = run(
+        readers,
+        [&](const std::string& source, std::atomic<bool>* done,
+            long* count) {
+          ConcurrentFrameTree::Reader reader{id_tree.reader()};
+          const FrameId map{reader.id("map")};
+          const FrameId sensor{reader.id(source)};
+          while (!done->load(std::memory_order_relaxed)) {
+            reader.lookup(map, sensor);
+            ++*count;
+          }
+        },
+        [&](const Isometry& r_pose) { id_tree.setTransform(base, r_pose); });
+    std::printf("%8d %16.3g %16.3g %16.3g\n", readers, locked, rcu, ids);
+  }
+  return 0;
+}
@@ -0,0 +1,86 @@
+/* Copyright 2020, Ekumen
+ * Inverse kinematics benchmark
+ * Author: Steven Desvars, 2020
+ *
+ * Solves random reachable targets of a 7-DOF arm, from a fixed seed and
+ * warm started from the previous solution along a trajectory, and reports
+ * solves and iterations per second.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include <isometry/ik_solver.hpp>
+
+namespace {
+
+using ekumen::math::IkResult;
+using ekumen::math::IkSolver;
+using ekumen::math::Isometry;
+using ekumen::math::JointType;
+using ekumen::math::KinematicChain;
+
+const std::size_t kTargets{20000};
+const std::size_t kDof{7};
+
+const double kA[kDof]{0., 0., 0.0825, -0.0825, 0., 0.088, 0.};
+const double kAlpha[kDof]{-M_PI / 2., M_PI / 2., M_PI / 2., -M_PI / 2.,
+                          M_PI / 2., M_PI / 2., 0.};
+const double kD[kDof]{0.333, 0., 0.316, 0., 0.384, 0., 0.107};
+const double kSeed[kDof]{0., 0., 0., -1.5, 0., 1.5, 0.};
+
+double elapsedSeconds(const std::chrono::steady_clock::time_point& start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                       start)
+      .count();
+}
+
+void run(const char* name, IkSolver* solver,
+         const std::vector<Isometry>& targets, const bool warm_start) {
+  double q[kDof];
+  std::copy(kSeed, kSeed + kDof, q);
+  std::size_t iterations{0};
+  std::size_t converged{0};
+  const auto start = std::chrono::steady_clock::now();
+  for (const Isometry& target : targets) {
+    if (!warm_start) {
+      std::copy(kSeed, kSeed + kDof, q);
+    }
+    const IkResult result{solver->solve(target, q)};
+    iterations += result.iterations;
+    converged += result.converged ? 1 : 0;
+  }
+  const double seconds = elapsedSeconds(start);
+  std::printf("%-6s %5.1f%% converged %6.2f it/solve %9.0f solves/s "
+              "%10.0f it/s\n",
+              name, 100. * converged / targets.size(),
+              static_cast<double>(iterations) / targets.size(),
+              targets.size() / seconds, iterations / seconds);
+}
+
+}  // namespace
+
+int main() {
+  KinematicChain arm;
+  for (std::size_t j = 0; j < kDof; ++j) {
+    arm.addDHJoint(JointType::kRevolute, kA[j], kAlpha[j], kD[j], 0.);
+  }
+  IkSolver solver{arm};
+
+  // Targets along a smooth joint-space trajectory, so consecutive ones are
+  // close, as when tracking a path.
+  std::vector<Isometry> targets(kTargets);
+  double q[kDof];
+  for (std::size_t i = 0; i < kTargets; ++i) {
+    for (std::size_t j = 0; j < kDof; ++j) {
+      q[j] = kSeed[j] + 0.6 * std::sin(1e-3 * i * (j + 1) + j);
+    }
+    targets[i] = arm.endEffector(q);
+  }
+  run("cold", &solver, targets, false);
+  run("warm", &solver, targets, true);
+  return 0;
+}
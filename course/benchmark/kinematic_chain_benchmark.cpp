@@ -0,0 +1,97 @@
+/* Copyright 2020, Ekumen
+ * Kinematic chain benchmark
+ * Author: Steven Desvars, 2020
+ *
+ * Compares forward kinematics of a 7-DOF arm evaluated by chaining
+ * rotateAround() and fromTranslation() against the precomputed chain, one
+ * configuration at a time and batched.
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include <isometry/kinematic_chain.hpp>
+
+namespace {
+
+using ekumen::math::Isometry;
+using ekumen::math::JointType;
+using ekumen::math::KinematicChain;
+using ekumen::math::SinCosAccuracy;
+using ekumen::math::Vector3;
+
+const std::size_t kConfigurations{1 << 16};
+const std::size_t kDof{7};
+const int kRepetitions{10};
+
+const double kA[kDof]{0., 0., 0.0825, -0.0825, 0., 0.088, 0.};
+const double kAlpha[kDof]{0., -M_PI / 2., M_PI / 2., M_PI / 2., -M_PI / 2.,
+                          M_PI / 2., M_PI / 2.};
+const double kD[kDof]{0.333, 0., 0.316, 0., 0.384, 0., 0.107};
+
+double elapsedSeconds(const std::chrono::steady_clock::time_point& start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                       start)
+      .count();
+}
+
+void report(const char* name, const double seconds) {
+  std::printf("%-14s %8.2f Mposes/s\n", name,
+              kConfigurations * kRepetitions / seconds * 1e-6);
+}
+
+Isometry naive(const double* q) {
+  Isometry pose;
+  for (std::size_t j = 0; j < kDof; ++j) {
+    pose *= Isometry::rotateAround(Vector3::kUnitZ, q[j]) *
+            Isometry::fromTranslation(Vector3(kA[j], 0., kD[j])) *
+            Isometry::rotateAround(Vector3::kUnitX, kAlpha[j]);
+  }
+  return pose;
+}
+
+}  // namespace
+
+int main() {
+  KinematicChain chain;
+  for (std::size_t j = 0; j < kDof; ++j) {
+    chain.addDHJoint(JointType::kRevolute, kA[j], kAlpha[j], kD[j], 0.);
+  }
+  std::vector<double> configurations(kConfigurations * kDof);
+  for (std::size_t i = 0; i < configurations.size(); ++i) {
+    configurations[i] = std::sin(0.61 * i) * M_PI;
+  }
+  std::vector<Isometry> poses(kConfigurations);
+
+  auto start = std::chrono::steady_clock::now();
+  for (int r = 0; r < kRepetitions; ++r) {
+    for (std::size_t i = 0; i < kConfigurations; ++i) {
+      poses[i] = naive(&configurations[i * kDof]);
+    }
+  }
+  report("naive", elapsedSeconds(start));
+
+  start = std::chrono::steady_clock::now();
+  for (int r = 0; r < kRepetitions; ++r) {
+    for (std::size_t i = 0; i < kConfigurations; ++i) {
+      poses[i] = chain.endEffector(&configurations[i * kDof]);
+    }
+  }
+  report("chain", elapsedSeconds(start));
+
+  start = std::chrono::steady_clock::now();
+  for (int r = 0; r < kRepetitions; ++r) {
+    chain.endEffectors(configurations.data(), kConfigurations, poses.data());
+  }
+  report("batched", elapsedSeconds(start));
+
+  start = std::chrono::steady_clock::now();
+  for (int r = 0; r < kRepetitions; ++r) {
+    chain.endEffectors(configurations.data(), kConfigurations, poses.data(),
+                       SinCosAccuracy::kFast);
+  }
+  report("batched fast", elapsedSeconds(start));
+  return 0;
+}
@@ -0,0 +1,86 @@
+/* Copyright 2020, Ekumen
+ * Point cloud streaming benchmark
+ * Author: Steven Desvars, 2020
+ *
+ * Compares transforming an XYZ point cloud file by loading it whole into a
+ * std::vector<Vector3> against streaming it with transformCloud().
+ */
+
+#include <unistd.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <isometry/point_cloud_stream.hpp>
+
+namespace {
+
+using ekumen::math::Isometry;
+using ekumen::math::Vector3;
+
+const std::size_t kPoints{4000000};
+
+double elapsedSeconds(const std::chrono::steady_clock::time_point& start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                       start)
+      .count();
+}
+
+void report(const char* name, const double seconds, const double megabytes) {
+  std::printf("%-22s %8.3f Mpoints/s %8.1f MB\n", name,
+              kPoints / seconds * 1e-6, megabytes);
+}
+
+}  // namespace
+
+int main() {
+  const std::string input{"/tmp/cloud_benchmark_in_" +
+                          std::to_string(::getpid())};
+  const std::string output{"/tmp/cloud_benchmark_out_" +
+                           std::to_string(::getpid())};
+  {
+    std::vector<float> xyz(3 * kPoints);
+    for (std::size_t i = 0; i < xyz.size(); ++i) {
+      xyz[i] = static_cast<float>(std::sin(0.001 * i));
+    }
+    std::ofstream file{input, std::ios::binary};
+    file.write(reinterpret_cast<const char*>(xyz.data()),
+               xyz.size() * sizeof(float));
+  }
+  const Isometry isometry{Isometry::fromTranslation(Vector3(1., 2., 3.)) *
+                          Isometry::fromEulerAngles(0.1, 0.2, 0.3)};
+
+  auto start = std::chrono::steady_clock::now();
+  {
+    std::ifstream in{input, std::ios::binary};
+    std::vector<Vector3> points;
+    float xyz[3];
+    while (in.read(reinterpret_cast<char*>(xyz), sizeof(xyz))) {
+      points.emplace_back(xyz[0], xyz[1], xyz[2]);
+    }
+    std::ofstream out{output, std::ios::binary};
+    for (const Vector3& point : points) {
+      const Vector3 transformed{isometry * point};
+      const float values[]{static_cast<float>(transformed.x()),
+                           static_cast<float>(transformed.y()),
+                           static_cast<float>(transformed.z())};
+      out.write(reinterpret_cast<const char*>(values), sizeof(values));
+    }
+  }
+  report("load whole", elapsedSeconds(start),
+         kPoints * sizeof(Vector3) * 1e-6);
+
+  start = std::chrono::steady_clock::now();
+  transformCloud(input, output, isometry);
+  report("stream", elapsedSeconds(start),
+         ekumen::math::kDefaultCloudChunkPoints *
+             (2 * 3 * sizeof(float) + sizeof(Vector3)) * 1e-6);
+
+  std::remove(input.c_str());
+  std::remove(output.c_str());
+  return 0;
+}
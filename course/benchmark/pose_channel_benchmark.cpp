@@ -0,0 +1,107 @@
+/* Copyright 2020, Ekumen
+ * Pose channel benchmark
+ * Author: Steven Desvars, 2020
+ *
+ * Compares handing poses to a reader as round trip text through a local
+ * socket against publishing them in a shared memory pose channel.
+ */
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <string>
+
+#include <isometry/format.hpp>
+#include <isometry/pose_channel.hpp>
+
+namespace {
+
+using ekumen::math::FormatMode;
+using ekumen::math::Isometry;
+using ekumen::math::PoseChannelReader;
+using ekumen::math::PoseChannelWriter;
+using ekumen::math::Vector3;
+using ekumen::math::kFormatBufferSize;
+
+const int kPoses{200000};
+
+double elapsedSeconds(const std::chrono::steady_clock::time_point& start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                       start)
+      .count();
+}
+
+void report(const char* name, const double seconds) {
+  std::printf("%-22s %10.1f ns/pose\n", name, seconds / kPoses * 1e9);
+}
+
+Isometry pose(const double time) {
+  return Isometry::fromTranslation(
+             Vector3(std::sin(time), 0.1 * time, 1.5)) *
+         Isometry::fromEulerAngles(0.01 * time, 0.2, -0.03 * time);
+}
+
+}  // namespace
+
+int main() {
+  Isometry poses[1024];
+  for (int i = 0; i < 1024; ++i) {
+    poses[i] = pose(i * 1e-3);
+  }
+  double total{0.};
+
+  int sockets[2];
+  if (::socketpair(AF_UNIX, SOCK_SEQPACKET, 0, sockets) != 0) {
+    std::perror("socketpair");
+    return 1;
+  }
+  char text[kFormatBufferSize];
+  Isometry parsed;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < kPoses; ++i) {
+    const std::size_t length = format(poses[i % 1024], text,
+                                      kFormatBufferSize,
+                                      FormatMode::kRoundTrip);
+    if (::write(sockets[0], text, length) !=
+        static_cast<ssize_t>(length)) {
+      std::perror("write");
+      return 1;
+    }
+    const ssize_t received = ::read(sockets[1], text, kFormatBufferSize);
+    if (received <= 0) {
+      std::perror("read");
+      return 1;
+    }
+    parse(text, static_cast<std::size_t>(received), &parsed);
+    total += parsed.translation().x();
+  }
+  report("text over socket", elapsedSeconds(start));
+  ::close(sockets[0]);
+  ::close(sockets[1]);
+
+  const std::string name{"/ekumen_pose_channel_benchmark_" +
+                         std::to_string(::getpid())};
+  PoseChannelWriter writer{name};
+  const PoseChannelReader reader{name};
+  double timestamp;
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < kPoses; ++i) {
+    writer.publish(i * 1e-3, poses[i % 1024]);
+    reader.latest(&timestamp, &parsed);
+    total += parsed.translation().x();
+  }
+  report("shared memory channel", elapsedSeconds(start));
+
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < kPoses; ++i) {
+    reader.latest(&timestamp, &parsed);
+    total += parsed.translation().x();
+  }
+  report("channel latest only", elapsedSeconds(start));
+
+  std::printf("checksum %f\n", total);
+  return 0;
+}
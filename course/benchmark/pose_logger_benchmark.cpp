@@ -0,0 +1,94 @@
+/* Copyright 2020, Ekumen
+ * Pose logger benchmark
+ * Author: Steven Desvars, 2020
+ *
+ * Compares the time a control loop spends logging a pose with operator<<
+ * into a file stream against handing it to the asynchronous PoseLogger,
+ * on average and in the worst case.
+ */
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include <isometry/pose_logger.hpp>
+
+namespace {
+
+using ekumen::math::Isometry;
+using ekumen::math::PoseLogFormat;
+using ekumen::math::PoseLogger;
+using ekumen::math::PoseLoggerOptions;
+using ekumen::math::PoseLoggerStats;
+using ekumen::math::Vector3;
+
+// The logger queue holds a whole run, so log() never waits for the disk.
+const int kRecords{200000};
+
+double elapsedSeconds(const std::chrono::steady_clock::time_point& start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                       start)
+      .count();
+}
+
+void report(const char* name, const double mean_ns, const double max_ns) {
+  std::printf("%-22s %10.1f ns/pose mean %12.0f ns worst\n", name, mean_ns,
+              max_ns);
+}
+
+Isometry pose(const double time) {
+  return Isometry::fromTranslation(
+             Vector3(std::sin(time), 0.1 * time, 1.5)) *
+         Isometry::fromEulerAngles(0.01 * time, 0.2, -0.03 * time);
+}
+
+void benchmarkLogger(const char* name, const std::string& r_path,
+                     const PoseLogFormat format, const Isometry* poses) {
+  PoseLoggerOptions options;
+  options.capacity = 262144;
+  options.format = format;
+  PoseLogger logger{r_path, options};
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < kRecords; ++i) {
+    logger.log(i * 1e-3, poses[i % 1024]);
+  }
+  const double seconds = elapsedSeconds(start);
+  logger.close();
+  const PoseLoggerStats stats{logger.stats()};
+  report(name, seconds / kRecords * 1e9,
+         static_cast<double>(stats.max_enqueue_ns));
+}
+
+}  // namespace
+
+int main() {
+  const std::string path{"/tmp/pose_logger_benchmark_" +
+                         std::to_string(::getpid()) + ".log"};
+  Isometry poses[1024];
+  for (int i = 0; i < 1024; ++i) {
+    poses[i] = pose(i * 1e-3);
+  }
+
+  {
+    std::ofstream stream{path};
+    double worst{0.};
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kRecords; ++i) {
+      const auto call = std::chrono::steady_clock::now();
+      stream << i * 1e-3 << ' ' << poses[i % 1024] << std::endl;
+      worst = std::max(worst, elapsedSeconds(call));
+    }
+    report("operator<<", elapsedSeconds(start) / kRecords * 1e9,
+           worst * 1e9);
+  }
+
+  benchmarkLogger("logger text", path, PoseLogFormat::kText, poses);
+  benchmarkLogger("logger binary", path, PoseLogFormat::kBinary, poses);
+  std::remove(path.c_str());
+  return 0;
+}
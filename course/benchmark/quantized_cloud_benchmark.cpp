@@ -0,0 +1,96 @@
+/* Copyright 2020, Ekumen
+ * Quantized point cloud benchmark
+ * Author: Steven Desvars, 2020
+ *
+ * Compares transforming a map held as Vector3s against the fused
+ * dequantize and transform kernel of 16 and 32-bit quantized clouds.
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include <isometry/quantized_cloud.hpp>
+
+namespace {
+
+using ekumen::math::Isometry;
+using ekumen::math::QuantizedCloud16;
+using ekumen::math::QuantizedCloud32;
+using ekumen::math::Vector3;
+
+// Large enough not to fit in the caches, in whole tiles.
+const std::size_t kTile{65536};
+const std::size_t kPoints{64 * kTile};
+const int kRepetitions{5};
+
+double elapsedSeconds(const std::chrono::steady_clock::time_point& start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                       start)
+      .count();
+}
+
+void report(const char* name, const double seconds, const std::size_t bytes) {
+  std::printf("%-22s %8.1f Mpoints/s %8.1f MB\n", name,
+              kPoints * kRepetitions / seconds * 1e-6, bytes * 1e-6);
+}
+
+// Transforms the whole map, one tile at a time into a reused buffer.
+template <class Transform>
+double run(const Transform& r_transform, std::vector<Vector3>* r_tile) {
+  double total{0.};
+  for (int r = 0; r < kRepetitions; ++r) {
+    for (std::size_t first = 0; first < kPoints; first += kTile) {
+      r_transform(first, r_tile->data());
+      total += (*r_tile)[0].x();
+    }
+  }
+  return total;
+}
+
+}  // namespace
+
+int main() {
+  std::vector<Vector3> points;
+  points.reserve(kPoints);
+  for (std::size_t i = 0; i < kPoints; ++i) {
+    const double t = 1e-4 * i;
+    points.emplace_back(4000. + 100. * std::cos(t), -2500. + 100. * std::sin(t),
+                        12. + std::sin(37. * t));
+  }
+  const Isometry pose{Isometry::fromTranslation(Vector3(-4000., 2500., 1.)) *
+                      Isometry::fromEulerAngles(0.1, -0.2, 2.5)};
+  const QuantizedCloud16 cloud16{points.data(), points.size()};
+  const QuantizedCloud32 cloud32{points.data(), points.size()};
+  std::vector<Vector3> tile(kTile);
+  double total{0.};
+
+  auto start = std::chrono::steady_clock::now();
+  total += run(
+      [&](const std::size_t first, Vector3* r_out) {
+        pose.transform(points.data() + first, kTile, r_out);
+      },
+      &tile);
+  report("Vector3", elapsedSeconds(start), points.size() * sizeof(Vector3));
+
+  start = std::chrono::steady_clock::now();
+  total += run(
+      [&](const std::size_t first, Vector3* r_out) {
+        cloud32.transform(pose, first, kTile, r_out);
+      },
+      &tile);
+  report("int32 fused", elapsedSeconds(start), cloud32.memory());
+
+  start = std::chrono::steady_clock::now();
+  total += run(
+      [&](const std::size_t first, Vector3* r_out) {
+        cloud16.transform(pose, first, kTile, r_out);
+      },
+      &tile);
+  report("int16 fused", elapsedSeconds(start), cloud16.memory());
+
+  std::printf("int16 max error %g, int32 max error %g, checksum %f\n",
+              cloud16.maxError(), cloud32.maxError(), total);
+  return 0;
+}
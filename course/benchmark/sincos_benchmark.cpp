@@ -0,0 +1,75 @@
+/* Copyright 2020, Ekumen
+ * Sine and cosine kernels benchmark
+ * Author: Steven Desvars, 2020
+ *
+ * Reports the maximum absolute error against libm and the throughput of
+ * each accuracy tier of the batch sincos kernel.
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include <isometry/internal/sincos.hpp>
+
+namespace {
+
+using ekumen::math::SinCosAccuracy;
+
+const std::size_t kSamples{1 << 20};
+const int kRepetitions{20};
+
+double elapsedSeconds(const std::chrono::steady_clock::time_point& start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                       start)
+      .count();
+}
+
+void report(const char* name, const double error, const double seconds) {
+  std::printf("%-8s max error %-10.3g %8.1f Msincos/s\n", name, error,
+              kSamples * kRepetitions / seconds * 1e-6);
+}
+
+void benchmarkTier(const char* name, const SinCosAccuracy accuracy,
+                   const std::vector<double>& angles) {
+  std::vector<double> sines(angles.size());
+  std::vector<double> cosines(angles.size());
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < kRepetitions; ++i) {
+    ekumen::math::internal::sincos(angles.data(), angles.size(), sines.data(),
+                                   cosines.data(), accuracy);
+  }
+  const double seconds = elapsedSeconds(start);
+  double error{0.};
+  for (std::size_t i = 0; i < angles.size(); ++i) {
+    error = std::fmax(error, std::fabs(sines[i] - std::sin(angles[i])));
+    error = std::fmax(error, std::fabs(cosines[i] - std::cos(angles[i])));
+  }
+  report(name, error, seconds);
+}
+
+}  // namespace
+
+int main() {
+  std::vector<double> angles(kSamples);
+  for (std::size_t i = 0; i < kSamples; ++i) {
+    angles[i] = -100. + 200. * static_cast<double>(i) / kSamples;
+  }
+
+  std::vector<double> sines(kSamples);
+  std::vector<double> cosines(kSamples);
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < kRepetitions; ++i) {
+    for (std::size_t j = 0; j < kSamples; ++j) {
+      sines[j] = std::sin(angles[j]);
+      cosines[j] = std::cos(angles[j]);
+    }
+  }
+  report("libm", 0., elapsedSeconds(start));
+
+  benchmarkTier("full", SinCosAccuracy::kFull, angles);
+  benchmarkTier("high", SinCosAccuracy::kHigh, angles);
+  benchmarkTier("fast", SinCosAccuracy::kFast, angles);
+  return 0;
+}
@@ -0,0 +1,73 @@
+/* Copyright 2020, Ekumen
+ * Trajectory codec benchmark
+ * Author: Steven Desvars, 2020
+ *
+ * Measures the size of encoded trajectories against raw records, and the
+ * encoding and decoding rates.
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include <isometry/trajectory_codec.hpp>
+
+namespace {
+
+using ekumen::math::Isometry;
+using ekumen::math::TrajectoryDecoder;
+using ekumen::math::Vector3;
+
+// An hour and a half at 200 Hz.
+const std::size_t kPoses{1000000};
+const std::size_t kBatch{1024};
+const int kRepetitions{5};
+
+double elapsedSeconds(const std::chrono::steady_clock::time_point& start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                       start)
+      .count();
+}
+
+}  // namespace
+
+int main() {
+  std::vector<Isometry> poses;
+  std::vector<double> timestamps;
+  for (std::size_t i = 0; i < kPoses; ++i) {
+    const double t = 5e-3 * i;
+    poses.push_back(Isometry::fromTranslation(
+                        Vector3(20. * std::sin(0.01 * t), t, 0.1)) *
+                    Isometry::fromEulerAngles(0.05 * std::sin(t), 0.02,
+                                              0.01 * t));
+    timestamps.push_back(1.6e9 + t);
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  const std::vector<std::uint8_t> encoded{
+      encodeTrajectory(poses.data(), timestamps.data(), poses.size())};
+  const double encode_seconds = elapsedSeconds(start);
+  std::printf("%-22s %8.2f bytes/pose (raw %zu)\n", "size",
+              static_cast<double>(encoded.size()) / kPoses,
+              sizeof(double) * 13);
+  std::printf("%-22s %8.2f Mposes/s\n", "encode",
+              kPoses / encode_seconds * 1e-6);
+
+  std::vector<Isometry> decoded(kBatch);
+  std::vector<double> decoded_timestamps(kBatch);
+  double total{0.};
+  start = std::chrono::steady_clock::now();
+  for (int r = 0; r < kRepetitions; ++r) {
+    TrajectoryDecoder decoder{encoded.data(), encoded.size()};
+    while (decoder.remaining() > 0) {
+      const std::size_t count = decoder.decode(kBatch, decoded.data(),
+                                               decoded_timestamps.data());
+      total += decoded[count - 1].translation().x() +
+               decoded_timestamps[count - 1];
+    }
+  }
+  std::printf("%-22s %8.2f Mposes/s\n", "decode",
+              kPoses * kRepetitions / elapsedSeconds(start) * 1e-6);
+  return total == 0.;
+}
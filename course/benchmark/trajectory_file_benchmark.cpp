@@ -0,0 +1,116 @@
+/* Copyright 2020, Ekumen
+ * Trajectory file benchmark
+ * Author: Steven Desvars, 2020
+ *
+ * Compares loading a recorded trajectory from text against opening it as a
+ * memory-mapped trajectory file, and measures random access and seeking.
+ */
+
+#include <unistd.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <isometry/format.hpp>
+#include <isometry/trajectory_file.hpp>
+
+namespace {
+
+using ekumen::math::FormatMode;
+using ekumen::math::Isometry;
+using ekumen::math::TrajectoryReader;
+using ekumen::math::TrajectoryWriter;
+using ekumen::math::Vector3;
+using ekumen::math::kFormatBufferSize;
+
+// Five minutes at 1 kHz.
+const int kRecords{300000};
+const int kQueries{1000000};
+
+double elapsedSeconds(const std::chrono::steady_clock::time_point& start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                       start)
+      .count();
+}
+
+void report(const char* name, const double rate, const char* unit) {
+  std::printf("%-22s %10.3f %s\n", name, rate, unit);
+}
+
+Isometry pose(const double time) {
+  return Isometry::fromTranslation(
+             Vector3(std::sin(time), 0.1 * time, 1.5)) *
+         Isometry::fromEulerAngles(0.01 * time, 0.2, -0.03 * time);
+}
+
+}  // namespace
+
+int main() {
+  const std::string text_path{"/tmp/trajectory_benchmark_" +
+                              std::to_string(::getpid()) + ".txt"};
+  const std::string file_path{"/tmp/trajectory_benchmark_" +
+                              std::to_string(::getpid()) + ".trj"};
+  double total{0.};
+
+  auto start = std::chrono::steady_clock::now();
+  {
+    TrajectoryWriter writer{file_path};
+    for (int i = 0; i < kRecords; ++i) {
+      writer.append(i * 1e-3, pose(i * 1e-3));
+    }
+  }
+  report("file append", kRecords / elapsedSeconds(start) * 1e-6, "Mrecords/s");
+
+  {
+    std::ofstream text{text_path};
+    char buffer[kFormatBufferSize];
+    for (int i = 0; i < kRecords; ++i) {
+      format(pose(i * 1e-3), buffer, kFormatBufferSize,
+             FormatMode::kRoundTrip);
+      text << i * 1e-3 << ' ' << buffer << '\n';
+    }
+  }
+
+  start = std::chrono::steady_clock::now();
+  {
+    std::ifstream text{text_path};
+    std::string line;
+    std::vector<Isometry> poses;
+    while (std::getline(text, line)) {
+      const std::size_t space = line.find(' ');
+      total += std::stod(line.substr(0, space));
+      poses.emplace_back();
+      parse(line.data() + space + 1, line.size() - space - 1, &poses.back());
+    }
+    total += poses.size();
+  }
+  report("text load", elapsedSeconds(start) * 1e3, "ms");
+
+  start = std::chrono::steady_clock::now();
+  const TrajectoryReader reader{file_path};
+  report("file open", elapsedSeconds(start) * 1e3, "ms");
+
+  start = std::chrono::steady_clock::now();
+  std::size_t index{12345};
+  for (int i = 0; i < kQueries; ++i) {
+    index = (index * 1103515245 + 12345) % reader.size();
+    total += reader.pose(index).translation().x();
+  }
+  report("random access", kQueries / elapsedSeconds(start) * 1e-6,
+         "Mrecords/s");
+
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < kQueries; ++i) {
+    index = (index * 1103515245 + 12345) % reader.size();
+    total += reader.seek(index * 1e-3 + 2e-4);
+  }
+  report("seek", kQueries / elapsedSeconds(start) * 1e-6, "Mseeks/s");
+
+  std::remove(text_path.c_str());
+  std::remove(file_path.c_str());
+  return total == 0.;
+}
@@ -0,0 +1,118 @@
+/* Copyright 2020, Ekumen
+ * Text trajectory benchmark
+ * Author: Steven Desvars, 2020
+ *
+ * Compares loading TUM and KITTI trajectory files with std::stringstream
+ * against the mapped parallel loader, and measures the writer.
+ */
+
+#include <unistd.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <isometry/trajectory_text.hpp>
+
+namespace {
+
+using ekumen::math::Isometry;
+using ekumen::math::Matrix3;
+using ekumen::math::TextTrajectory;
+using ekumen::math::TrajectoryTextFormat;
+using ekumen::math::Vector3;
+using ekumen::math::loadTrajectoryText;
+using ekumen::math::saveTrajectoryText;
+
+const std::size_t kPoses{500000};
+
+double elapsedSeconds(const std::chrono::steady_clock::time_point& start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                       start)
+      .count();
+}
+
+void report(const char* name, const double seconds) {
+  std::printf("%-22s %8.3f Mposes/s\n", name, kPoses / seconds * 1e-6);
+}
+
+Isometry pose(const double time) {
+  return Isometry::fromTranslation(
+             Vector3(std::sin(time), 0.1 * time, 1.5)) *
+         Isometry::fromEulerAngles(0.01 * time, 0.2, -0.03 * time);
+}
+
+// The line-by-line parsing being replaced.
+std::vector<Isometry> loadKittiWithStreams(const std::string& r_path) {
+  std::ifstream file{r_path};
+  std::vector<Isometry> poses;
+  std::string line;
+  while (std::getline(file, line)) {
+    std::stringstream stream{line};
+    double m[12];
+    for (double& r_value : m) {
+      stream >> r_value;
+    }
+    poses.push_back(Isometry{Vector3(m[3], m[7], m[11]),
+                             Matrix3{Vector3(m[0], m[1], m[2]),
+                                     Vector3(m[4], m[5], m[6]),
+                                     Vector3(m[8], m[9], m[10])}});
+  }
+  return poses;
+}
+
+}  // namespace
+
+int main() {
+  const std::string path{"/tmp/trajectory_text_benchmark_" +
+                         std::to_string(::getpid()) + ".txt"};
+  std::vector<Isometry> poses;
+  std::vector<double> timestamps;
+  for (std::size_t i = 0; i < kPoses; ++i) {
+    timestamps.push_back(1305031102.175304 + 1e-3 * i);
+    poses.push_back(pose(1e-3 * i));
+  }
+  double total{0.};
+
+  auto start = std::chrono::steady_clock::now();
+  saveTrajectoryText(path, TrajectoryTextFormat::kKitti, poses.data(),
+                     nullptr, kPoses);
+  report("save KITTI", elapsedSeconds(start));
+
+  start = std::chrono::steady_clock::now();
+  total += loadKittiWithStreams(path).back().translation().x();
+  report("load KITTI streams", elapsedSeconds(start));
+
+  start = std::chrono::steady_clock::now();
+  total += loadTrajectoryText(path, TrajectoryTextFormat::kKitti, 1)
+               .poses.back()
+               .translation()
+               .x();
+  report("load KITTI 1 thread", elapsedSeconds(start));
+
+  start = std::chrono::steady_clock::now();
+  total += loadTrajectoryText(path, TrajectoryTextFormat::kKitti)
+               .poses.back()
+               .translation()
+               .x();
+  report("load KITTI auto", elapsedSeconds(start));
+
+  start = std::chrono::steady_clock::now();
+  saveTrajectoryText(path, TrajectoryTextFormat::kTum, poses.data(),
+                     timestamps.data(), kPoses);
+  report("save TUM", elapsedSeconds(start));
+
+  start = std::chrono::steady_clock::now();
+  const TextTrajectory trajectory{
+      loadTrajectoryText(path, TrajectoryTextFormat::kTum)};
+  report("load TUM auto", elapsedSeconds(start));
+
+  total += trajectory.poses.back().translation().x();
+  std::printf("checksum %f\n", total);
+  std::remove(path.c_str());
+  return 0;
+}
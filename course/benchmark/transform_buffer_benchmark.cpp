@@ -0,0 +1,74 @@
+/* Copyright 2020, Ekumen
+ * Transform buffer batch lookup benchmark
+ * Author: Steven Desvars, 2020
+ *
+ * Deskews a lidar scan: looks up the transform at every point time of a
+ * 100 ms scan, in a buffer of 200 Hz odometry, one lookup at a time and as
+ * a single sorted batch.
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include <isometry/transform_buffer.hpp>
+
+namespace {
+
+using ekumen::math::Isometry;
+using ekumen::math::SinCosAccuracy;
+using ekumen::math::TransformBuffer;
+using ekumen::math::Vector3;
+
+const std::size_t kPoints{20000};
+const int kScans{200};
+
+double elapsedSeconds(const std::chrono::steady_clock::time_point& start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                       start)
+      .count();
+}
+
+void report(const char* name, const double seconds) {
+  std::printf("%-12s %8.2f Mlookups/s\n", name,
+              kPoints * kScans / seconds * 1e-6);
+}
+
+}  // namespace
+
+int main() {
+  TransformBuffer buffer{400};
+  for (int i = 0; i < 400; ++i) {
+    const double time = 0.005 * i;
+    buffer.insert(time, Isometry::fromTranslation(Vector3(time, 0., 0.)) *
+                            Isometry::rotateAround(Vector3(0., 0.6, 0.8),
+                                                   0.5 * time));
+  }
+  std::vector<double> times(kPoints);
+  for (std::size_t i = 0; i < kPoints; ++i) {
+    times[i] = 1. + 0.1 * static_cast<double>(i) / kPoints;
+  }
+  std::vector<Isometry> poses(kPoints);
+
+  auto start = std::chrono::steady_clock::now();
+  for (int scan = 0; scan < kScans; ++scan) {
+    for (std::size_t i = 0; i < kPoints; ++i) {
+      poses[i] = buffer.lookup(times[i]);
+    }
+  }
+  report("single", elapsedSeconds(start));
+
+  start = std::chrono::steady_clock::now();
+  for (int scan = 0; scan < kScans; ++scan) {
+    buffer.lookup(times.data(), kPoints, poses.data());
+  }
+  report("batch", elapsedSeconds(start));
+
+  start = std::chrono::steady_clock::now();
+  for (int scan = 0; scan < kScans; ++scan) {
+    buffer.lookup(times.data(), kPoints, poses.data(), SinCosAccuracy::kFast);
+  }
+  report("batch fast", elapsedSeconds(start));
+  return 0;
+}
@@ -0,0 +1,119 @@
+/* Copyright 2020, Ekumen
+ * Transform snapshot benchmark
+ * Author: Steven Desvars, 2020
+ *
+ * Compares rebuilding a transform state from a text configuration of
+ * translations and Euler angles against restoring it from a snapshot.
+ */
+
+#include <unistd.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <isometry/transform_snapshot.hpp>
+
+namespace {
+
+using ekumen::math::FrameTree;
+using ekumen::math::Isometry;
+using ekumen::math::SnapshotBuffer;
+using ekumen::math::TransformBuffer;
+using ekumen::math::TransformSnapshot;
+using ekumen::math::Vector3;
+using ekumen::math::loadTransformSnapshot;
+using ekumen::math::saveTransformSnapshot;
+
+const int kFrames{5000};
+const int kBuffers{100};
+const int kSamples{1000};
+
+double elapsedSeconds(const std::chrono::steady_clock::time_point& start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                       start)
+      .count();
+}
+
+void report(const char* name, const double seconds) {
+  std::printf("%-22s %10.3f ms\n", name, seconds * 1e3);
+}
+
+// One "name parent x y z roll pitch yaw" line per frame, then one
+// "buffer t x y z roll pitch yaw" line per sample.
+std::string configuration() {
+  std::ostringstream text;
+  text.precision(17);
+  for (int i = 1; i < kFrames; ++i) {
+    text << "frame" << i << " frame" << (i - 1) / 4 << ' ' << std::sin(i)
+         << ' ' << 0.01 * i << " 0.5 " << 0.001 * i << " 0.2 "
+         << -0.003 * i << '\n';
+  }
+  for (int b = 0; b < kBuffers; ++b) {
+    for (int s = 0; s < kSamples; ++s) {
+      text << "buffer" << b << ' ' << 0.01 * s << ' ' << 0.1 * s
+           << " 0 0 0 0 " << 0.001 * s << '\n';
+    }
+  }
+  return text.str();
+}
+
+void rebuild(const std::string& r_text, FrameTree* r_tree,
+             std::vector<TransformBuffer>* r_buffers) {
+  std::istringstream text{r_text};
+  std::string name;
+  std::string parent;
+  double x, y, z, roll, pitch, yaw;
+  for (int i = 1; i < kFrames; ++i) {
+    text >> name >> parent >> x >> y >> z >> roll >> pitch >> yaw;
+    r_tree->addFrame(name, parent,
+                     Isometry::fromTranslation(Vector3(x, y, z)) *
+                         Isometry::fromEulerAngles(roll, pitch, yaw));
+  }
+  for (int b = 0; b < kBuffers; ++b) {
+    r_buffers->emplace_back(kSamples);
+    for (int s = 0; s < kSamples; ++s) {
+      double t;
+      text >> name >> t >> x >> y >> z >> roll >> pitch >> yaw;
+      r_buffers->back().insert(
+          t, Isometry::fromTranslation(Vector3(x, y, z)) *
+                 Isometry::fromEulerAngles(roll, pitch, yaw));
+    }
+  }
+}
+
+}  // namespace
+
+int main() {
+  const std::string path{"/tmp/transform_snapshot_benchmark_" +
+                         std::to_string(::getpid()) + ".snap"};
+  const std::string text{configuration()};
+
+  auto start = std::chrono::steady_clock::now();
+  FrameTree tree{"frame0"};
+  std::vector<TransformBuffer> buffers;
+  rebuild(text, &tree, &buffers);
+  report("rebuild from text", elapsedSeconds(start));
+
+  std::vector<SnapshotBuffer> saved;
+  for (int b = 0; b < kBuffers; ++b) {
+    saved.push_back(SnapshotBuffer{"buffer" + std::to_string(b), &buffers[b]});
+  }
+  start = std::chrono::steady_clock::now();
+  saveTransformSnapshot(path, tree, saved);
+  report("save snapshot", elapsedSeconds(start));
+
+  start = std::chrono::steady_clock::now();
+  const TransformSnapshot snapshot{loadTransformSnapshot(path)};
+  report("restore snapshot", elapsedSeconds(start));
+
+  std::printf("checksum %f\n",
+              snapshot.tree.lookup("frame4999", "frame1").translation().x() +
+                  snapshot.buffers.back().lookup(5.).translation().x());
+  std::remove(path.c_str());
+  return 0;
+}
@@ -0,0 +1,66 @@
+/*
+ * Atomic isometry library
+ * Author: Steven Desvars, 2020
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <isometry/internal/seqlock.hpp>
+#include <isometry/isometry.hpp>
+
+namespace ekumen {
+
+namespace math {
+
+/// Vector3 published by one writer thread to many reader threads, without
+/// locks nor heap allocations. Stores never wait; loads retry while a store
+/// is in progress and never observe a partially written value.
+class AtomicVector3 {
+ public:
+  AtomicVector3() = default;
+
+  /// Constructs an AtomicVector3 at version 0.
+  /// @param r_vector Initial value.
+  explicit AtomicVector3(const Vector3& r_vector);
+
+  /// Publishes a new value. Only one thread may store at a time.
+  /// @param r_vector Value to publish.
+  void store(const Vector3& r_vector);
+
+  Vector3 load() const;
+
+  /// Outputs the number of stores so far.
+  std::uint64_t version() const { return lock_.version(); }
+
+ private:
+  internal::SeqLock<3> lock_;
+};
+
+/// Isometry published by one writer thread to many reader threads, without
+/// locks nor heap allocations. Stores never wait; loads retry while a store
+/// is in progress and never observe a partially written value.
+class AtomicIsometry {
+ public:
+  AtomicIsometry() : AtomicIsometry(Isometry()) {}
+
+  /// Constructs an AtomicIsometry at version 0.
+  /// @param r_isometry Initial value.
+  explicit AtomicIsometry(const Isometry& r_isometry);
+
+  /// Publishes a new value. Only one thread may store at a time.
+  /// @param r_isometry Value to publish.
+  void store(const Isometry& r_isometry);
+
+  Isometry load() const;
+
+  /// Outputs the number of stores so far.
+  std::uint64_t version() const { return lock_.version(); }
+
+ private:
+  internal::SeqLock<12> lock_;
+};
+
+}  // namespace math
+
+}  // namespace ekumen
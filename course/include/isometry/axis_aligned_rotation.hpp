@@ -0,0 +1,74 @@
+/*
+ * Axis-aligned rotation library
+ * Author: Steven Desvars, 2020
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <iostream>
+#include <isometry/matrix3.hpp>
+
+namespace ekumen {
+
+namespace math {
+
+/// Rotation by a multiple of 90 degrees around coordinate axes, stored as a
+/// signed permutation. Row i of the equivalent matrix has a single non-zero
+/// entry, sign(i), in column axis(i). Composing and transforming only shuffle
+/// and negate components, so results are exact.
+class AxisAlignedRotation {
+ public:
+  /// Constructs the identity rotation.
+  constexpr AxisAlignedRotation() : axes_{0, 1, 2}, signs_{1, 1, 1} {};
+
+  /// Detects a rotation of an exact multiple of pi / 2 around a coordinate
+  /// axis.
+  /// @param r_vector Unitary Vector to rotate around.
+  /// @param angle Value of the angle of rotation.
+  /// @param r_out Output rotation, only written on success.
+  /// @returns True if the rotation is axis-aligned.
+  static bool fromAxisAngle(const Vector3& r_vector, const double& angle,
+                            AxisAlignedRotation* r_out);
+
+  /// Detects a rotation matrix that is a signed permutation.
+  /// @param r_matrix Rotation matrix to inspect.
+  /// @param r_out Output rotation, only written on success.
+  /// @returns True if the matrix is an axis-aligned rotation.
+  static bool fromMatrix(const Matrix3& r_matrix, AxisAlignedRotation* r_out);
+
+  int axis(const int i) const { return axes_[i]; }
+  int sign(const int i) const { return signs_[i]; }
+
+  Vector3 transform(const Vector3& r_vector) const;
+
+  AxisAlignedRotation inverse() const;
+
+  /// Composes this rotation with another one, this * r_rotation.
+  AxisAlignedRotation compose(const AxisAlignedRotation& r_rotation) const;
+
+  /// Outputs this * r_matrix, by shuffling the rows of r_matrix.
+  Matrix3 product(const Matrix3& r_matrix) const;
+
+  /// Outputs r_matrix * this, by shuffling the columns of r_matrix.
+  Matrix3 rightProduct(const Matrix3& r_matrix) const;
+
+  Matrix3 toMatrix() const;
+
+  bool operator==(const AxisAlignedRotation& r_rotation) const;
+  bool operator!=(const AxisAlignedRotation& r_rotation) const;
+
+  Vector3 operator*(const Vector3& r_vector) const;
+  AxisAlignedRotation operator*(const AxisAlignedRotation& r_rotation) const;
+
+ private:
+  std::int8_t axes_[3];
+  std::int8_t signs_[3];
+};
+
+std::ostream& operator<<(std::ostream& os,
+                         const AxisAlignedRotation& r_rotation);
+
+}  // namespace math
+
+}  // namespace ekumen
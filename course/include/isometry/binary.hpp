@@ -0,0 +1,238 @@
+/*
+ * Binary serialization library
+ * Author: Steven Desvars, 2020
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <isometry/isometry.hpp>
+#include <limits>
+#include <stdexcept>
+
+namespace ekumen {
+
+namespace math {
+
+/// Kind of the elements of an encoded buffer.
+enum class BinaryType : std::uint16_t {
+  kVector3 = 1,
+  kMatrix3 = 2,
+  kIsometry = 3,
+};
+
+/// Version written by encode() and the only one views accept.
+const std::uint16_t kBinaryVersion{1};
+
+/// Size of the header in front of every encoded buffer:
+///  - bytes 0 to 3, the "EKIS" magic,
+///  - bytes 4 and 5, the version,
+///  - bytes 6 and 7, the BinaryType,
+///  - bytes 8 to 15, the element count,
+/// all integers little-endian. The elements follow as little-endian IEEE 754
+/// doubles, Vector3 as x, y, z, Matrix3 row by row and Isometry as its
+/// translation and then its rotation. Being a multiple of 8, the header keeps
+/// the elements of an aligned buffer aligned.
+const std::size_t kBinaryHeaderSize{16};
+
+namespace internal {
+
+/// Number of doubles of an encoded element.
+template <class T>
+struct BinaryLayout;
+
+template <>
+struct BinaryLayout<Vector3> {
+  static constexpr BinaryType kType{BinaryType::kVector3};
+  static constexpr std::size_t kDoubles{3};
+};
+
+template <>
+struct BinaryLayout<Matrix3> {
+  static constexpr BinaryType kType{BinaryType::kMatrix3};
+  static constexpr std::size_t kDoubles{9};
+};
+
+template <>
+struct BinaryLayout<Isometry> {
+  static constexpr BinaryType kType{BinaryType::kIsometry};
+  static constexpr std::size_t kDoubles{12};
+};
+
+inline bool isLittleEndian() {
+  const std::uint16_t probe{1};
+  unsigned char first;
+  std::memcpy(&first, &probe, 1);
+  return first == 1;
+}
+
+/// Reads consecutive little-endian doubles from a possibly unaligned buffer.
+inline void loadDoubles(const unsigned char* bytes, const std::size_t count,
+                        double* r_out) {
+  if (isLittleEndian()) {
+    std::memcpy(r_out, bytes, count * sizeof(double));
+    return;
+  }
+  for (std::size_t i = 0; i < count; ++i) {
+    unsigned char swapped[sizeof(double)];
+    for (std::size_t j = 0; j < sizeof(double); ++j) {
+      swapped[j] = bytes[i * sizeof(double) + sizeof(double) - 1 - j];
+    }
+    std::memcpy(r_out + i, swapped, sizeof(double));
+  }
+}
+
+inline void load(const unsigned char* bytes, Vector3* r_out) {
+  double values[3];
+  loadDoubles(bytes, 3, values);
+  *r_out = Vector3(values[0], values[1], values[2]);
+}
+
+inline void load(const unsigned char* bytes, Matrix3* r_out) {
+  double values[9];
+  loadDoubles(bytes, 9, values);
+  *r_out = Matrix3{Vector3(values[0], values[1], values[2]),
+                   Vector3(values[3], values[4], values[5]),
+                   Vector3(values[6], values[7], values[8])};
+}
+
+inline void load(const unsigned char* bytes, Isometry* r_out) {
+  double values[12];
+  loadDoubles(bytes, 12, values);
+  *r_out = Isometry{Vector3(values[0], values[1], values[2]),
+                    Matrix3{Vector3(values[3], values[4], values[5]),
+                            Vector3(values[6], values[7], values[8]),
+                            Vector3(values[9], values[10], values[11])}};
+}
+
+/// Writes the low bytes of an unsigned integer, little-endian.
+void storeInteger(std::uint64_t value, const std::size_t bytes,
+                  unsigned char* r_out);
+
+/// Reads a little-endian unsigned integer of a number of bytes.
+std::uint64_t loadInteger(const unsigned char* bytes, const std::size_t size);
+
+/// Writes consecutive little-endian doubles to a possibly unaligned buffer.
+void storeDoubles(const double* values, const std::size_t count,
+                  unsigned char* r_out);
+
+/// Writes elements in the layout read by load().
+void store(const Vector3& r_vector, unsigned char* r_out);
+void store(const Matrix3& r_matrix, unsigned char* r_out);
+void store(const Isometry& r_isometry, unsigned char* r_out);
+
+/// Validates the header of an encoded buffer.
+/// @returns Number of elements.
+/// @throws std::invalid_argument If the buffer is truncated, or its magic,
+/// version or type do not match.
+std::size_t checkBinaryHeader(const unsigned char* bytes,
+                              const std::size_t size, const BinaryType type,
+                              const std::size_t element_size);
+
+}  // namespace internal
+
+/// Gets the size of the encoding of a number of elements.
+/// @param count Number of elements.
+template <class T>
+constexpr std::size_t binarySize(const std::size_t count) {
+  return kBinaryHeaderSize +
+         count * internal::BinaryLayout<T>::kDoubles * sizeof(double);
+}
+
+static_assert(std::numeric_limits<double>::is_iec559 && sizeof(double) == 8,
+              "The encoding stores IEEE 754 binary64 doubles");
+static_assert(kBinaryHeaderSize % alignof(double) == 0,
+              "The header must keep the elements aligned");
+static_assert(binarySize<Vector3>(1) == kBinaryHeaderSize + 24 &&
+                  binarySize<Matrix3>(1) == kBinaryHeaderSize + 72 &&
+                  binarySize<Isometry>(1) == kBinaryHeaderSize + 96,
+              "Encoded element sizes are part of the format");
+
+/// Encodes Vector3s into a caller-provided buffer.
+/// @param r_values Elements to encode.
+/// @param count Number of elements.
+/// @param buffer Output buffer, it needs no alignment.
+/// @param size Size of the buffer.
+/// @returns Number of bytes written, binarySize<Vector3>(count).
+/// @throws std::length_error If the buffer is too small.
+std::size_t encode(const Vector3* r_values, const std::size_t count,
+                   void* buffer, const std::size_t size);
+
+/// Encodes Matrix3s, see
+/// encode(const Vector3*, const std::size_t, void*, const std::size_t).
+std::size_t encode(const Matrix3* r_values, const std::size_t count,
+                   void* buffer, const std::size_t size);
+
+/// Encodes Isometries, see
+/// encode(const Vector3*, const std::size_t, void*, const std::size_t).
+std::size_t encode(const Isometry* r_values, const std::size_t count,
+                   void* buffer, const std::size_t size);
+
+/// Read-only view of an encoded buffer of Vector3, Matrix3 or Isometry. The
+/// header is validated once, then elements are read in place from the
+/// buffer, which must outlive the view. Nothing is parsed nor copied up
+/// front, and on little-endian hosts reading an element is a plain load.
+template <class T>
+class BinaryView {
+ public:
+  /// Constructs a view.
+  /// @param buffer Encoded buffer, it needs no alignment.
+  /// @param size Size of the buffer, it may hold trailing data.
+  /// @throws std::invalid_argument If the buffer is not an encoding of T.
+  BinaryView(const void* buffer, const std::size_t size);
+
+  std::size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  /// Size of the encoding, where trailing data starts.
+  std::size_t bytes() const { return binarySize<T>(size_); }
+
+  T operator[](const std::size_t i) const {
+    T value;
+    internal::load(elements_ + i * kElementSize, &value);
+    return value;
+  }
+
+  /// @throws std::out_of_range If i is not below size().
+  T at(const std::size_t i) const {
+    if (i >= size_) {
+      throw std::out_of_range("Binary view index out of range");
+    }
+    return (*this)[i];
+  }
+
+  /// Decodes a range of elements.
+  /// @param first Index of the first element.
+  /// @param count Number of elements.
+  /// @param r_out Output elements.
+  /// @throws std::out_of_range If the range goes past size().
+  void copy(const std::size_t first, const std::size_t count,
+            T* r_out) const {
+    if (first > size_ || count > size_ - first) {
+      throw std::out_of_range("Binary view range out of range");
+    }
+    for (std::size_t i = 0; i < count; ++i) {
+      r_out[i] = (*this)[first + i];
+    }
+  }
+
+ private:
+  static constexpr std::size_t kElementSize{
+      internal::BinaryLayout<T>::kDoubles * sizeof(double)};
+
+  const unsigned char* elements_;
+  std::size_t size_;
+};
+
+template <class T>
+constexpr std::size_t BinaryView<T>::kElementSize;
+
+using Vector3View = BinaryView<Vector3>;
+using Matrix3View = BinaryView<Matrix3>;
+using IsometryView = BinaryView<Isometry>;
+
+}  // namespace math
+
+}  // namespace ekumen
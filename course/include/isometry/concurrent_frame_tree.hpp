@@ -0,0 +1,142 @@
+/*
+ * Concurrent frame tree library
+ * Author: Steven Desvars, 2020
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <isometry/frame_tree.hpp>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ekumen {
+
+namespace math {
+
+/// FrameTree shared between many reader threads and a few writers. Writers
+/// copy the current tree, modify the copy and publish it as a new immutable
+/// snapshot. Readers never lock nor block: they announce the epoch they
+/// entered at, and old snapshots are only reclaimed once no reader that may
+/// still see them is active (epoch-based reclamation).
+class ConcurrentFrameTree {
+ public:
+  /// Default number of reader slots.
+  static const std::size_t kDefaultMaxReaders;
+
+  /// Constructs a ConcurrentFrameTree.
+  /// @param r_tree Initial tree.
+  /// @param max_readers Maximum number of simultaneous Reader objects.
+  explicit ConcurrentFrameTree(const FrameTree& r_tree,
+                               const std::size_t max_readers =
+                                   kDefaultMaxReaders);
+
+  ConcurrentFrameTree(const ConcurrentFrameTree&) = delete;
+  ConcurrentFrameTree& operator=(const ConcurrentFrameTree&) = delete;
+
+  /// All Reader objects must be destroyed before the tree.
+  ~ConcurrentFrameTree();
+
+  /// Per-thread handle to read the tree. It owns one reader slot until it
+  /// is destroyed. A Reader must not be used by two threads at once.
+  class Reader {
+   public:
+    Reader(Reader&& r_reader);
+    Reader(const Reader&) = delete;
+    Reader& operator=(const Reader&) = delete;
+    ~Reader();
+
+    /// Same as FrameTree::lookup(), on the latest published snapshot.
+    Isometry lookup(const std::string& target,
+                    const std::string& source) const;
+    Isometry lookup(const FrameId target, const FrameId source) const;
+
+    /// Same as FrameTree::id(). Handles never change once assigned, so they
+    /// can be resolved once and used on any later snapshot.
+    FrameId id(const std::string& name) const;
+
+    /// Runs a function on the latest published snapshot. The snapshot stays
+    /// valid until the function returns.
+    /// @param r_function Function to call with the snapshot.
+    void read(const std::function<void(const FrameTree&)>& r_function) const;
+
+   private:
+    friend class ConcurrentFrameTree;
+
+    Reader(ConcurrentFrameTree* owner, const std::size_t slot)
+        : owner_{owner}, slot_{slot} {};
+
+    ConcurrentFrameTree* owner_;
+    std::size_t slot_;
+  };
+
+  /// Gets a Reader, claiming a free reader slot without locking.
+  /// @throws std::runtime_error If all the slots are in use.
+  Reader reader();
+
+  /// Applies a set of modifications and publishes them atomically, readers
+  /// see either none or all of them. World poses are brought up to date
+  /// before publishing. Writers are serialized.
+  /// @param r_update Function that modifies a private copy of the tree.
+  void update(const std::function<void(FrameTree*)>& r_update);
+
+  /// Same as FrameTree::addFrame(), published on its own.
+  FrameId addFrame(const std::string& name, const std::string& parent,
+                   const Isometry& r_transform);
+  FrameId addFrame(const std::string& name, const FrameId parent,
+                   const Isometry& r_transform);
+
+  /// Same as FrameTree::setTransform(), published on its own.
+  void setTransform(const std::string& name, const Isometry& r_transform);
+  void setTransform(const FrameId frame, const Isometry& r_transform);
+
+  /// Outputs the number of replaced snapshots not reclaimed yet.
+  std::size_t retiredCount() const;
+
+ private:
+  // One cache line per slot, so readers don't share lines with each other.
+  // The global operator new only honours the alignment from C++17 on, the
+  // slots bring their own.
+  struct alignas(64) ReaderSlot {
+    static void* operator new[](const std::size_t size);
+    static void operator delete[](void* memory);
+
+    std::atomic<std::uint64_t> epoch;
+    std::atomic<bool> in_use;
+  };
+
+  // Pins the current epoch in a slot while a snapshot is in use.
+  class Guard {
+   public:
+    Guard(ConcurrentFrameTree* owner, const std::size_t slot);
+    ~Guard();
+    const FrameTree& tree() const { return *tree_; }
+
+   private:
+    ReaderSlot* slot_;
+    const FrameTree* tree_;
+  };
+
+  void releaseSlot(const std::size_t slot);
+
+  // Deletes retired snapshots no active reader can still see. Requires the
+  // writer mutex.
+  void reclaim();
+
+  std::atomic<const FrameTree*> current_;
+  std::atomic<std::uint64_t> epoch_;
+  std::size_t max_readers_;
+  std::unique_ptr<ReaderSlot[]> slots_;
+  mutable std::mutex writer_mutex_;
+  std::vector<std::pair<std::uint64_t, const FrameTree*>> retired_;
+};
+
+}  // namespace math
+
+}  // namespace ekumen
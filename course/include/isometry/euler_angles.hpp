@@ -0,0 +1,68 @@
+/*
+ * Euler angles library
+ * Author: Steven Desvars, 2020
+ */
+
+#pragma once
+
+#include <isometry/matrix3.hpp>
+
+namespace ekumen {
+
+namespace math {
+
+/// Axis sequences of Euler angles. Angles are always given in the order of
+/// the sequence, e.g. kZYX takes (yaw, pitch, roll).
+enum class EulerSequence {
+  // Tait-Bryan angles.
+  kXYZ,
+  kXZY,
+  kYXZ,
+  kYZX,
+  kZXY,
+  kZYX,
+  // Proper Euler angles.
+  kXYX,
+  kXZX,
+  kYXY,
+  kYZY,
+  kZXZ,
+  kZYZ,
+};
+
+/// Whether each rotation of a sequence is applied around the axes of the
+/// rotating frame (intrinsic) or of the fixed frame (extrinsic). Intrinsic
+/// XYZ is Rx * Ry * Rz, extrinsic XYZ is Rz * Ry * Rx.
+enum class EulerFrame {
+  kIntrinsic,
+  kExtrinsic,
+};
+
+/// Gets the rotation matrix of a set of Euler angles, given the sine and
+/// cosine of each angle.
+/// @param sines Sines of the angles, in sequence order.
+/// @param cosines Cosines of the angles, in sequence order.
+/// @param sequence Axis sequence.
+/// @param frame Intrinsic or extrinsic rotations.
+Matrix3 eulerRotation(const double* sines, const double* cosines,
+                      const EulerSequence sequence, const EulerFrame frame);
+
+/// Extracts Euler angles from a rotation matrix. The middle angle lies in
+/// [-pi / 2, pi / 2] for Tait-Bryan sequences and in [0, pi] for proper Euler
+/// sequences. At gimbal lock, for both frames, the third angle is set to zero
+/// and the first one absorbs the whole rotation around the locked axis.
+/// @param r_matrix Rotation matrix.
+/// @param sequence Axis sequence.
+/// @param frame Intrinsic or extrinsic rotations.
+/// @returns The angles, in sequence order.
+Vector3 eulerAngles(const Matrix3& r_matrix, const EulerSequence sequence,
+                    const EulerFrame frame);
+
+/// Gets the unitary vector of the i-th rotation axis of a sequence.
+/// @param sequence Axis sequence.
+/// @param i Position in the sequence, from 0 to 2.
+Vector3 eulerAxis(const EulerSequence sequence, const int i);
+
+}  // namespace math
+
+}  // namespace ekumen
@@ -0,0 +1,29 @@
+/*
+ * Text formatting library
+ * Author: Steven Desvars, 2020
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <isometry/isometry.hpp>
+#include <isometry/matrix3_format.hpp>
+
+namespace ekumen {
+
+namespace math {
+
+/// Formats an Isometry as "[T: (x: 1, y: 2, z: 3), R:[[1, 0, 0], [0, 1, 0],
+/// [0, 0, 1]]]", see
+/// format(const Vector3&, char*, const std::size_t, const FormatMode).
+std::size_t format(const Isometry& r_isometry, char* buffer,
+                   const std::size_t size,
+                   const FormatMode mode = FormatMode::kLegacy);
+
+/// Parses an Isometry in the format() layout, see
+/// parse(const char*, const std::size_t, Vector3*).
+std::size_t parse(const char* text, const std::size_t size, Isometry* r_out);
+
+}  // namespace math
+
+}  // namespace ekumen
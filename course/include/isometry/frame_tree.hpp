@@ -0,0 +1,158 @@
+/*
+ * Frame tree library
+ * Author: Steven Desvars, 2020
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <isometry/isometry.hpp>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ekumen {
+
+namespace math {
+
+/// Dense integer handle of a frame, its position in insertion order. Names
+/// are interned once, when the frame is added, and handle-based queries do
+/// no string work. Handles stay valid for the life of the tree and of its
+/// copies. It is a type of its own, so that handles don't mix with counts
+/// or other indices, and overloads on it don't collide with size_t ones.
+class FrameId {
+ public:
+  /// Constructs the handle of the frame at a position.
+  /// @param index Position of the frame in insertion order.
+  constexpr explicit FrameId(const std::size_t index) : index_{index} {}
+
+  /// Outputs the position of the frame in insertion order.
+  constexpr std::size_t index() const { return index_; }
+
+  constexpr bool operator==(const FrameId& r_other) const {
+    return index_ == r_other.index_;
+  }
+
+  constexpr bool operator!=(const FrameId& r_other) const {
+    return index_ != r_other.index_;
+  }
+
+ private:
+  std::size_t index_;
+};
+
+std::ostream& operator<<(std::ostream& r_os, const FrameId& r_frame);
+
+/// Tree of named coordinate frames. Each frame stores its transform relative
+/// to its parent, i.e. the Isometry that maps points from the frame to its
+/// parent, together with a cached transform relative to the root (its world
+/// pose).
+///
+/// Frames live in flat arrays in topological order, parents always before
+/// their children. setTransform() only flags the frame as dirty, and
+/// updateWorldPoses() refreshes the world poses of the dirty subtrees in a
+/// single linear pass. Lookups stay valid in between, they compose the
+/// stale part of the paths on demand.
+///
+/// Every query is offered on FrameId handles, the string versions resolve
+/// the names and forward to them.
+class FrameTree {
+ public:
+  /// Work done by an updateWorldPoses() call.
+  struct UpdateStats {
+    /// World poses recomputed, one composition each.
+    std::size_t recomputed;
+    /// World poses left untouched, i.e. compositions saved compared to
+    /// recomputing every frame.
+    std::size_t saved;
+  };
+
+  /// Constructs a FrameTree with a single root frame.
+  /// @param root Name of the root frame.
+  explicit FrameTree(const std::string& root);
+
+  /// Adds a frame to the tree.
+  /// @param name Name of the new frame.
+  /// @param parent Name of an existing frame.
+  /// @param r_transform Transform from the new frame to its parent.
+  /// @returns Handle of the new frame.
+  FrameId addFrame(const std::string& name, const std::string& parent,
+                   const Isometry& r_transform);
+  FrameId addFrame(const std::string& name, const FrameId parent,
+                   const Isometry& r_transform);
+
+  /// Updates the transform of a frame relative to its parent. The cached
+  /// world poses of its subtree become stale until updateWorldPoses() is
+  /// called, and lookups on them get slower.
+  /// @param name Name of the frame, it can't be the root.
+  /// @param r_transform Transform from the frame to its parent.
+  void setTransform(const std::string& name, const Isometry& r_transform);
+  void setTransform(const FrameId frame, const Isometry& r_transform);
+
+  /// Recomputes the world poses invalidated since the last call.
+  /// @returns How many poses were recomputed and how many were saved.
+  UpdateStats updateWorldPoses();
+
+  /// Whether some world poses are stale.
+  bool stale() const { return stale_; }
+
+  bool hasFrame(const std::string& name) const;
+
+  std::size_t size() const { return names_.size(); }
+
+  /// Handle of the root frame.
+  FrameId root() const { return FrameId(0); }
+
+  /// Resolves a frame name into its handle.
+  /// @param name Name of the frame.
+  /// @throws std::invalid_argument If there is no such frame.
+  FrameId id(const std::string& name) const;
+
+  /// Outputs the name of a frame.
+  /// @param frame Handle of the frame.
+  const std::string& name(const FrameId frame) const;
+
+  /// Outputs the name of the parent of a frame.
+  /// @param name Name of the frame, it can't be the root.
+  const std::string& parent(const std::string& name) const;
+  FrameId parent(const FrameId frame) const;
+
+  /// Outputs the transform of a frame relative to its parent.
+  /// @param name Name of the frame.
+  Isometry transform(const std::string& name) const;
+  Isometry transform(const FrameId frame) const;
+
+  /// Gets the Isometry that maps points from the source frame to the target
+  /// frame. Both cached root-relative transforms are combined, the part of
+  /// the paths above the lowest common ancestor cancels out, so a query
+  /// costs one inverse and one composition regardless of the depth. Frames
+  /// under one moved since the last updateWorldPoses() also compose their
+  /// path up to it.
+  /// @param target Name of the target frame.
+  /// @param source Name of the source frame.
+  Isometry lookup(const std::string& target, const std::string& source) const;
+  Isometry lookup(const FrameId target, const FrameId source) const;
+
+ private:
+  /// @throws std::out_of_range If the handle is not a frame of the tree.
+  void check(const FrameId frame) const;
+
+  /// Transform from the frame at an index to the root, cached unless it is
+  /// stale.
+  Isometry worldPose(const std::size_t frame) const;
+
+  // Indexed by FrameId::index(), as are the other arrays.
+  std::vector<std::string> names_;
+  std::vector<std::size_t> parents_;
+  std::vector<Isometry> transforms_;
+  std::vector<Isometry> world_poses_;
+  std::vector<std::uint8_t> dirty_;
+  bool stale_;
+  std::unordered_map<std::string, FrameId> indices_;
+};
+
+}  // namespace math
+
+}  // namespace ekumen
@@ -0,0 +1,94 @@
+/*
+ * Inverse kinematics library
+ * Author: Steven Desvars, 2020
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <isometry/isometry.hpp>
+#include <isometry/kinematic_chain.hpp>
+#include <vector>
+
+namespace ekumen {
+
+namespace math {
+
+/// Options of an IkSolver.
+struct IkOptions {
+  /// Damping factor lambda, it trades accuracy for stability close to
+  /// singular configurations.
+  double damping{0.05};
+  /// Largest change of any joint in a single iteration.
+  double max_step{0.5};
+  /// Position error to stop at, in the units of the chain.
+  double position_tolerance{1e-6};
+  /// Orientation error to stop at, in radians.
+  double orientation_tolerance{1e-6};
+  std::size_t max_iterations{100};
+};
+
+/// Outcome of an IkSolver::solve() call.
+struct IkResult {
+  bool converged;
+  /// Iterations taken, zero when the seed is already a solution.
+  std::size_t iterations;
+  /// Final distance between the end effector and the target.
+  double position_error;
+  /// Final angle between the end effector and the target orientations.
+  double orientation_error;
+};
+
+/// Damped least squares inverse kinematics for a KinematicChain. Each
+/// iteration evaluates the link poses, builds the geometric Jacobian from
+/// the joint axes, and takes the step J^T (J J^T + lambda^2 I)^-1 e, with e
+/// the position and orientation error of the end effector. The 6x6 system
+/// is solved by Cholesky. All the workspace is sized at construction, so
+/// solving never allocates.
+class IkSolver {
+ public:
+  /// Constructs an IkSolver without joint limits.
+  /// @param r_chain Chain to solve for, it is copied.
+  /// @param r_options Solver options.
+  /// @throws std::invalid_argument If the chain has no joints or the
+  /// options are not positive.
+  explicit IkSolver(const KinematicChain& r_chain,
+                    const IkOptions& r_options = IkOptions());
+
+  const KinematicChain& chain() const { return chain_; }
+  const IkOptions& options() const { return options_; }
+
+  /// Sets the limits of every joint, solutions are clamped to them.
+  /// @param lower Lower limits, dof() of them.
+  /// @param upper Upper limits, dof() of them.
+  /// @throws std::invalid_argument If a lower limit exceeds its upper one.
+  void setJointLimits(const double* lower, const double* upper);
+
+  /// Solves for the joint values that place the end effector at a target.
+  /// @param r_target Target pose of the end effector in the base frame.
+  /// @param r_q Joint values, the seed on input, warm starting from a
+  /// previous solution, and the solution on output.
+  IkResult solve(const Isometry& r_target, double* r_q);
+
+ private:
+  /// Computes the error of the end effector at the current link poses.
+  /// @param r_target Target pose.
+  /// @param r_error Output error, position then orientation.
+  void computeError(const Isometry& r_target, double* r_error) const;
+
+  void clamp(double* r_q) const;
+
+  KinematicChain chain_;
+  IkOptions options_;
+  std::vector<double> lower_;
+  std::vector<double> upper_;
+  /// Workspace: link poses, the 6 x dof Jacobian, row-major, and the joint
+  /// step.
+  std::vector<Isometry> poses_;
+  std::vector<double> jacobian_;
+  std::vector<double> step_;
+};
+
+}  // namespace math
+
+}  // namespace ekumen
@@ -0,0 +1,121 @@
+/*
+ * Bounded queue
+ * Author: Steven Desvars, 2020
+ *
+ * Library-internal lock-free multi-producer multi-consumer queue, used to
+ * hand records off to background threads.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+namespace ekumen {
+
+namespace math {
+
+namespace internal {
+
+/// Fixed-capacity queue after Dmitry Vyukov's bounded MPMC queue. Every
+/// cell carries a sequence number telling whether it is free for the
+/// producer of a given position or full for its consumer, so pushing and
+/// popping take one compare-and-swap on the shared position and never
+/// lock. Storage is allocated once, at construction.
+template <class T>
+class BoundedQueue {
+ public:
+  /// Constructs a BoundedQueue.
+  /// @param capacity Number of cells, a power of two of at least 2.
+  /// @throws std::invalid_argument If the capacity is not a power of two.
+  explicit BoundedQueue(const std::size_t capacity)
+      : cells_(capacity), mask_{capacity - 1}, tail_{0}, head_{0} {
+    if (capacity < 2 || (capacity & (capacity - 1)) != 0) {
+      throw std::invalid_argument("Queue capacity must be a power of two");
+    }
+    for (std::size_t i = 0; i < capacity; ++i) {
+      cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  BoundedQueue(const BoundedQueue&) = delete;
+  BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+  std::size_t capacity() const { return cells_.size(); }
+
+  /// Pushes a value, if there is room.
+  /// @param r_value Value to push.
+  /// @returns Whether it was pushed, false if the queue is full.
+  bool tryPush(const T& r_value) {
+    std::size_t position = tail_.load(std::memory_order_relaxed);
+    for (;;) {
+      Cell& r_cell = cells_[position & mask_];
+      const std::size_t sequence =
+          r_cell.sequence.load(std::memory_order_acquire);
+      const std::ptrdiff_t difference = static_cast<std::ptrdiff_t>(
+          sequence - position);
+      if (difference == 0) {
+        if (tail_.compare_exchange_weak(position, position + 1,
+                                        std::memory_order_relaxed)) {
+          r_cell.value = r_value;
+          r_cell.sequence.store(position + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (difference < 0) {
+        return false;
+      } else {
+        position = tail_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /// Pops the oldest value, if there is one.
+  /// @param r_value Output value.
+  /// @returns Whether a value was popped, false if the queue is empty.
+  bool tryPop(T* r_value) {
+    std::size_t position = head_.load(std::memory_order_relaxed);
+    for (;;) {
+      Cell& r_cell = cells_[position & mask_];
+      const std::size_t sequence =
+          r_cell.sequence.load(std::memory_order_acquire);
+      const std::ptrdiff_t difference = static_cast<std::ptrdiff_t>(
+          sequence - (position + 1));
+      if (difference == 0) {
+        if (head_.compare_exchange_weak(position, position + 1,
+                                        std::memory_order_relaxed)) {
+          *r_value = r_cell.value;
+          r_cell.sequence.store(position + mask_ + 1,
+                                std::memory_order_release);
+          return true;
+        }
+      } else if (difference < 0) {
+        return false;
+      } else {
+        position = head_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+ private:
+  struct Cell {
+    std::atomic<std::size_t> sequence;
+    T value;
+  };
+
+  // Producers and consumers work on separate cache lines.
+  static constexpr std::size_t kCacheLine{64};
+
+  std::vector<Cell> cells_;
+  const std::size_t mask_;
+  alignas(kCacheLine) std::atomic<std::size_t> tail_;
+  alignas(kCacheLine) std::atomic<std::size_t> head_;
+};
+
+}  // namespace internal
+
+}  // namespace math
+
+}  // namespace ekumen
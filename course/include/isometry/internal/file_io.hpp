@@ -0,0 +1,76 @@
+/*
+ * File input and output
+ * Author: Steven Desvars, 2020
+ *
+ * Library-internal POSIX file helpers shared by the readers and writers.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <system_error>
+
+namespace ekumen {
+
+namespace math {
+
+namespace internal {
+
+/// Builds the exception for a failed system call from errno.
+/// @param r_what Message of the exception.
+/// @returns The exception, to be thrown by the caller.
+std::system_error systemError(const std::string& r_what);
+
+/// Writes all the bytes at the current position of a file, retrying
+/// interrupted and partial writes.
+/// @param fd File descriptor.
+/// @param bytes Bytes to write.
+/// @param size Number of bytes.
+/// @param r_what Message of the exception.
+/// @throws std::system_error If a write fails.
+void writeAll(const int fd, const void* bytes, const std::size_t size,
+              const std::string& r_what);
+
+/// Writes all the bytes at an offset of a file, leaving its position alone,
+/// retrying interrupted and partial writes.
+/// @param fd File descriptor.
+/// @param bytes Bytes to write.
+/// @param size Number of bytes.
+/// @param offset Offset of the first byte in the file.
+/// @param r_what Message of the exception.
+/// @throws std::system_error If a write fails.
+void writeAllAt(const int fd, const void* bytes, const std::size_t size,
+                const std::size_t offset, const std::string& r_what);
+
+/// Read-only mapping of a whole file, unmapped on destruction. Empty files
+/// are not mapped and have a null data().
+class FileMapping {
+ public:
+  /// Maps a file.
+  /// @param r_path Path of the file.
+  /// @throws std::system_error If the file can't be opened or mapped.
+  explicit FileMapping(const std::string& r_path);
+
+  FileMapping(const FileMapping&) = delete;
+  FileMapping& operator=(const FileMapping&) = delete;
+
+  ~FileMapping();
+
+  /// Tells the kernel the mapping will be read front to back, so it reads
+  /// ahead aggressively.
+  void adviseSequential() const;
+
+  const unsigned char* data() const { return data_; }
+  std::size_t size() const { return size_; }
+
+ private:
+  const unsigned char* data_;
+  std::size_t size_;
+};
+
+}  // namespace internal
+
+}  // namespace math
+
+}  // namespace ekumen
@@ -0,0 +1,34 @@
+/*
+ * Number formatting library
+ * Author: Steven Desvars, 2020
+ */
+
+#pragma once
+
+#include <cstddef>
+
+namespace ekumen {
+
+namespace math {
+
+namespace internal {
+
+/// Buffer size that fits any number written by formatShortest().
+const std::size_t kShortestDoubleSize{32};
+
+/// Writes the shortest decimal text that parses back to the same double,
+/// in the notation, fixed or scientific, that is shorter. Digits come from
+/// the Grisu2 algorithm, integer arithmetic only, so it neither allocates
+/// nor goes through printf(). Grisu2 always round trips, and very rarely
+/// outputs one digit more than strictly needed.
+/// @param value Number to write.
+/// @param buffer Output buffer of at least kShortestDoubleSize characters,
+/// the text is null terminated.
+/// @returns Length of the text, without the terminating null.
+std::size_t formatShortest(const double value, char* buffer);
+
+}  // namespace internal
+
+}  // namespace math
+
+}  // namespace ekumen
@@ -0,0 +1,33 @@
+/*
+ * Number parsing library
+ * Author: Steven Desvars, 2020
+ */
+
+#pragma once
+
+namespace ekumen {
+
+namespace math {
+
+namespace internal {
+
+/// Parses a decimal floating point number, [+-]digits[.digits][e[+-]digits]
+/// or inf / nan, from a range that needs not be null terminated. It never
+/// allocates. Written as an integer mantissa times a power of ten, with the
+/// fraction digits folded into the mantissa, a number with at most 19
+/// significant digits, a mantissa of at most 2^53 and an exponent within
+/// [-22, 22] is converted exactly with a single multiplication or division
+/// (Clinger's fast path). The rest is handed to strtod() through a copy on
+/// the stack, and rejected if longer than 1023 characters.
+/// @param begin First character.
+/// @param end One past the last character that may be read.
+/// @param r_value Output value, only written on success.
+/// @returns One past the last character of the number, or nullptr if the
+/// range doesn't start with a number.
+const char* parseDouble(const char* begin, const char* end, double* r_value);
+
+}  // namespace internal
+
+}  // namespace math
+
+}  // namespace ekumen
@@ -0,0 +1,40 @@
+/*
+ * Quaternion conversions
+ * Author: Steven Desvars, 2020
+ *
+ * Library-internal conversions between rotation matrices and unit
+ * quaternions, shared by the trajectory codec and the text trajectory
+ * formats.
+ */
+
+#pragma once
+
+#include <isometry/matrix3.hpp>
+
+namespace ekumen {
+
+namespace math {
+
+namespace internal {
+
+/// Unit quaternion of a rotation matrix, by Shepperd's method.
+/// @param r_rotation Rotation matrix.
+/// @param r_q Output components w, x, y and z.
+void toQuaternion(const Matrix3& r_rotation, double* r_q);
+
+/// Rotation matrix of a unit quaternion.
+inline Matrix3 fromQuaternion(const double w, const double x, const double y,
+                              const double z) {
+  return Matrix3{Vector3(1. - 2. * (y * y + z * z), 2. * (x * y - w * z),
+                         2. * (x * z + w * y)),
+                 Vector3(2. * (x * y + w * z), 1. - 2. * (x * x + z * z),
+                         2. * (y * z - w * x)),
+                 Vector3(2. * (x * z - w * y), 2. * (y * z + w * x),
+                         1. - 2. * (x * x + y * y))};
+}
+
+}  // namespace internal
+
+}  // namespace math
+
+}  // namespace ekumen
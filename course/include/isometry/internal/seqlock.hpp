@@ -0,0 +1,103 @@
+/*
+ * Sequence lock
+ * Author: Steven Desvars, 2020
+ *
+ * Library-internal fixed-size sequence lock for arrays of doubles, shared
+ * by the atomic types and the shared memory channel.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace ekumen {
+
+namespace math {
+
+namespace internal {
+
+/// Array of doubles published by a single writer to any number of readers.
+/// Writes are wait-free, reads retry until they see a version that was not
+/// modified while being copied. It holds no pointers and is lock-free, so it
+/// may also live in memory shared between processes.
+template <std::size_t kSize>
+class SeqLock {
+ public:
+  SeqLock() : sequence_{0} {
+    for (std::size_t i = 0; i < kSize; ++i) {
+      values_[i].store(0., std::memory_order_relaxed);
+    }
+  }
+
+  /// Constructs a SeqLock holding initial values, at version 0.
+  /// @param values Initial values.
+  explicit SeqLock(const double* values) : sequence_{0} {
+    for (std::size_t i = 0; i < kSize; ++i) {
+      values_[i].store(values[i], std::memory_order_relaxed);
+    }
+  }
+
+  SeqLock(const SeqLock&) = delete;
+  SeqLock& operator=(const SeqLock&) = delete;
+
+  /// Publishes new values. Only one thread may write at a time.
+  /// @param values Values to publish.
+  void store(const double* values) {
+    const std::uint64_t sequence = sequence_.load(std::memory_order_relaxed);
+    sequence_.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (std::size_t i = 0; i < kSize; ++i) {
+      values_[i].store(values[i], std::memory_order_relaxed);
+    }
+    sequence_.store(sequence + 2, std::memory_order_release);
+  }
+
+  /// Copies a consistent version of the values.
+  /// @param values Output values.
+  /// @returns The version that was read, it grows by one on every store.
+  std::uint64_t load(double* values) const {
+    std::uint64_t version;
+    while (!tryLoad(values, &version)) {
+    }
+    return version;
+  }
+
+  /// Makes a single attempt at copying a consistent version of the values,
+  /// so it takes a bounded time whatever the writer does.
+  /// @param values Output values, meaningless on failure.
+  /// @param r_version Output version that was read.
+  /// @returns Whether the copy is consistent, false if a store was in
+  /// progress.
+  bool tryLoad(double* values, std::uint64_t* r_version) const {
+    const std::uint64_t before = sequence_.load(std::memory_order_acquire);
+    if (before & 1) {
+      return false;
+    }
+    for (std::size_t i = 0; i < kSize; ++i) {
+      values[i] = values_[i].load(std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (sequence_.load(std::memory_order_relaxed) != before) {
+      return false;
+    }
+    *r_version = before / 2;
+    return true;
+  }
+
+  /// Outputs the number of stores so far.
+  std::uint64_t version() const {
+    return sequence_.load(std::memory_order_acquire) / 2;
+  }
+
+ private:
+  std::atomic<std::uint64_t> sequence_;
+  std::atomic<double> values_[kSize];
+};
+
+}  // namespace internal
+
+}  // namespace math
+
+}  // namespace ekumen
@@ -0,0 +1,51 @@
+/*
+ * Sine and cosine kernels
+ * Author: Steven Desvars, 2020
+ *
+ * Library-internal polynomial sincos used by the batch rotation builders.
+ * Not part of the public Isometry API.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+namespace ekumen {
+
+namespace math {
+
+/// Accuracy tiers of the polynomial sine and cosine kernels.
+enum class SinCosAccuracy {
+  /// Close to full double precision, a couple of ulp.
+  kFull,
+  /// Absolute error below 1e-9.
+  kHigh,
+  /// Absolute error below 1e-6.
+  kFast,
+};
+
+namespace internal {
+
+/// Computes the sine and cosine of an angle.
+/// @param angle Angle, in radians.
+/// @param sine Output sine.
+/// @param cosine Output cosine.
+/// @param accuracy Polynomial accuracy tier.
+void sincos(const double angle, double* sine, double* cosine,
+            const SinCosAccuracy accuracy);
+
+/// Computes the sine and cosine of a batch of angles. The inner loop is
+/// branch free so the compiler can vectorize it.
+/// @param angles Angles, in radians.
+/// @param count Number of angles.
+/// @param sines Output sines.
+/// @param cosines Output cosines.
+/// @param accuracy Polynomial accuracy tier.
+void sincos(const double* angles, const std::size_t count, double* sines,
+            double* cosines, const SinCosAccuracy accuracy);
+
+}  // namespace internal
+
+}  // namespace math
+
+}  // namespace ekumen
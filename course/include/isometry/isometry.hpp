@@ -7,8 +7,12 @@
 #pragma once
 
 #include <cmath>
+#include <cstddef>
 #include <initializer_list>
 #include <iostream>
+#include <isometry/axis_aligned_rotation.hpp>
+#include <isometry/euler_angles.hpp>
+#include <isometry/internal/sincos.hpp>
 #include <isometry/matrix3.hpp>
 #include <sstream>
 #include <string>
@@ -21,13 +25,27 @@ namespace math {
 class Isometry {
  public:
   /// Constructs an Isometry with default values.
-  Isometry() : rotation_matrix_{Matrix3::kIdentity} {};
+  Isometry() : rotation_matrix_{Matrix3::kIdentity}, axis_aligned_{true} {};
 
-  /// Constructs an Isometry.
+  /// Constructs an Isometry. It is constexpr for static_transform, so it
+  /// does not inspect the matrix: the result is never axis-aligned, even for
+  /// a signed permutation. Callers that decode such rotations keep the fast
+  /// path with AxisAlignedRotation::fromMatrix() and the constructor below.
   /// @param r_vector Initial value of the translation vector.
   /// @param r_matrix Initial value of the rotation matrix.
-  Isometry(const Vector3& r_vector, const Matrix3& r_matrix)
-      : translation_vector_{r_vector}, rotation_matrix_{r_matrix}{};
+  constexpr Isometry(const Vector3& r_vector, const Matrix3& r_matrix)
+      : translation_vector_{r_vector},
+        rotation_matrix_{r_matrix},
+        axis_aligned_{false} {};
+
+  /// Constructs an Isometry with an axis-aligned rotation.
+  /// @param r_vector Initial value of the translation vector.
+  /// @param r_rotation Initial value of the rotation.
+  Isometry(const Vector3& r_vector, const AxisAlignedRotation& r_rotation)
+      : translation_vector_{r_vector},
+        rotation_matrix_{r_rotation.toMatrix()},
+        permutation_{r_rotation},
+        axis_aligned_{true} {};
 
   /// Gets the Isometry matrix from a vector
   /// @param r_vector Value of the translation vector.
@@ -40,19 +58,130 @@ class Isometry {
   static Isometry fromEulerAngles(const double& roll, const double& pitch,
                                   const double& yaw);
 
-  Vector3 translation() const;
+  /// Gets the Isometry matrices from batches of Euler angles
+  /// @param rolls Values of the roll angles.
+  /// @param pitches Values of the pitch angles.
+  /// @param yaws Values of the yaw angles.
+  /// @param count Number of angle triplets.
+  /// @param r_out Output isometries.
+  /// @param accuracy Accuracy tier of the sine and cosine evaluation.
+  static void fromEulerAngles(
+      const double* rolls, const double* pitches, const double* yaws,
+      const std::size_t count, Isometry* r_out,
+      const SinCosAccuracy accuracy = SinCosAccuracy::kFull);
+
+  /// Gets the Isometry matrix from Euler angles in any convention
+  /// @param angles Values of the angles, in sequence order.
+  /// @param sequence Axis sequence.
+  /// @param frame Intrinsic or extrinsic rotations.
+  static Isometry fromEulerAngles(
+      const Vector3& angles, const EulerSequence sequence,
+      const EulerFrame frame = EulerFrame::kIntrinsic);
+
+  /// Gets the Isometry matrices from a batch of Euler angles in any
+  /// convention
+  /// @param angles Values of the angles, in sequence order.
+  /// @param count Number of angle triplets.
+  /// @param r_out Output isometries.
+  /// @param sequence Axis sequence.
+  /// @param frame Intrinsic or extrinsic rotations.
+  /// @param accuracy Accuracy tier of the sine and cosine evaluation.
+  static void fromEulerAngles(
+      const Vector3* angles, const std::size_t count, Isometry* r_out,
+      const EulerSequence sequence,
+      const EulerFrame frame = EulerFrame::kIntrinsic,
+      const SinCosAccuracy accuracy = SinCosAccuracy::kFull);
+
+  /// Extracts the Euler angles of the rotation. See eulerAngles() for the
+  /// ranges of the angles and the gimbal lock handling.
+  /// @param sequence Axis sequence.
+  /// @param frame Intrinsic or extrinsic rotations.
+  /// @returns The angles, in sequence order.
+  Vector3 toEulerAngles(
+      const EulerSequence sequence = EulerSequence::kXYZ,
+      const EulerFrame frame = EulerFrame::kIntrinsic) const;
+
+  /// Extracts the Euler angles of a batch of isometries.
+  /// @param isometries Isometries to convert.
+  /// @param count Number of isometries.
+  /// @param r_out Output angles, in sequence order.
+  /// @param sequence Axis sequence.
+  /// @param frame Intrinsic or extrinsic rotations.
+  static void toEulerAngles(const Isometry* isometries,
+                            const std::size_t count, Vector3* r_out,
+                            const EulerSequence sequence,
+                            const EulerFrame frame = EulerFrame::kIntrinsic);
+
+  constexpr Vector3 translation() const { return translation_vector_; }
 
   Vector3 transform(const Vector3& r_vector) const;
 
+  /// Transforms a batch of points. The rotation and translation are loaded
+  /// once and the loop has no branches, so the compiler can vectorize it.
+  /// @param r_points Points to transform.
+  /// @param count Number of points.
+  /// @param r_out Output points, it may alias r_points.
+  void transform(const Vector3* r_points, const std::size_t count,
+                 Vector3* r_out) const;
+
   Isometry inverse() const;
 
-  Matrix3 rotation() const;
+  constexpr Matrix3 rotation() const { return rotation_matrix_; }
+
+  /// Whether the rotation is a known multiple of 90 degrees around the
+  /// coordinate axes. Such isometries compose and transform points without
+  /// multiplications. Only the identity, fromTranslation(), rotateAround(),
+  /// fromEulerAngles() and the AxisAlignedRotation constructor tag them, and
+  /// compositions of them keep it.
+  bool isAxisAligned() const { return axis_aligned_; }
 
   /// Gets the Isometry matrix from rotation a certain angle around a given direction unitary-vector
   /// @param r_vector Unitary Vector to rotate around.
   /// @param angle Value of the angle of rotation.
   static Isometry rotateAround(const Vector3& r_vector, const double& angle);
 
+  /// Gets the Isometry matrices of rotations around a given direction
+  /// unitary-vector for a batch of angles
+  /// @param r_vector Unitary Vector to rotate around.
+  /// @param angles Values of the angles of rotation.
+  /// @param count Number of angles.
+  /// @param r_out Output isometries.
+  /// @param accuracy Accuracy tier of the sine and cosine evaluation.
+  static void rotateAround(
+      const Vector3& r_vector, const double* angles, const std::size_t count,
+      Isometry* r_out, const SinCosAccuracy accuracy = SinCosAccuracy::kFull);
+
+  /// Gets the Isometry matrix of a rotation given as a rotation vector
+  /// @param r_vector Rotation axis scaled by the angle of rotation.
+  static Isometry fromRotationVector(const Vector3& r_vector);
+
+  /// Outputs the rotation as a rotation vector, the rotation axis scaled by
+  /// the angle of rotation in [0, pi].
+  Vector3 toRotationVector() const;
+
+  /// Interpolates between two isometries. The translation is interpolated
+  /// linearly and the rotation at constant angular velocity (slerp).
+  /// Fractions outside [0, 1] extrapolate.
+  /// @param r_from Isometry at fraction 0.
+  /// @param r_to Isometry at fraction 1.
+  /// @param fraction Interpolation parameter.
+  static Isometry interpolate(const Isometry& r_from, const Isometry& r_to,
+                              const double& fraction);
+
+  /// Interpolates between two isometries at a batch of fractions. The
+  /// relative rotation is extracted once, and the sines and cosines of the
+  /// scaled angles go through the batch kernel.
+  /// @param r_from Isometry at fraction 0.
+  /// @param r_to Isometry at fraction 1.
+  /// @param fractions Interpolation parameters.
+  /// @param count Number of fractions.
+  /// @param r_out Output isometries.
+  /// @param accuracy Accuracy tier of the sine and cosine evaluation.
+  static void interpolate(
+      const Isometry& r_from, const Isometry& r_to, const double* fractions,
+      const std::size_t count, Isometry* r_out,
+      const SinCosAccuracy accuracy = SinCosAccuracy::kFull);
+
   /// Gets the Isometry matrix of the result of a composed movement with a given Isometry Matrix
   /// @param r_isometry Isometry matrix of the given movement.
   Isometry compose(const Isometry& r_isometry) const;
@@ -67,8 +196,10 @@ class Isometry {
   Isometry& operator*=(const Isometry& r_isometry);
 
  private:
-  Vector3 translation_vector_; 
+  Vector3 translation_vector_;
   Matrix3 rotation_matrix_;
+  AxisAlignedRotation permutation_;
+  bool axis_aligned_;
 };
 
 std::ostream& operator<<(std::ostream& os, const Isometry& r_isometry);
@@ -0,0 +1,90 @@
+/*
+ * Planar isometry library
+ * Author: Steven Desvars, 2020
+ */
+
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <iostream>
+#include <isometry/isometry.hpp>
+
+namespace ekumen {
+
+namespace math {
+
+/// Rigid transformation in the XY plane (SE(2)). It keeps the cosine and
+/// sine of the heading cached, so composing and transforming never calls
+/// into trigonometric functions.
+class Isometry2 {
+ public:
+  /// Constructs an identity Isometry2.
+  Isometry2() : x_{0}, y_{0}, theta_{0}, cos_{1}, sin_{0} {};
+
+  /// Constructs an Isometry2.
+  /// @param x Translation along the x axis.
+  /// @param y Translation along the y axis.
+  /// @param theta Rotation around the z axis, in radians.
+  Isometry2(const double x, const double y, const double theta);
+
+  /// Gets the Isometry2 from a planar translation.
+  /// @param x Translation along the x axis.
+  /// @param y Translation along the y axis.
+  static Isometry2 fromTranslation(const double x, const double y);
+
+  /// Gets the Isometry2 from a rotation around the z axis.
+  /// @param theta Rotation angle, in radians.
+  static Isometry2 fromRotation(const double theta);
+
+  double x() const { return x_; }
+  double y() const { return y_; }
+  /// Heading, normalized to (-pi, pi].
+  double theta() const { return theta_; }
+
+  /// Transforms a point. The z coordinate is passed through untouched.
+  /// @param r_vector Point to transform.
+  Vector3 transform(const Vector3& r_vector) const;
+
+  /// Transforms a batch of points. The z coordinates are passed through.
+  /// @param r_points Points to transform.
+  /// @param count Number of points.
+  /// @param r_out Output points, it may alias r_points.
+  void transform(const Vector3* r_points, const std::size_t count,
+                 Vector3* r_out) const;
+
+  Isometry2 inverse() const;
+
+  /// Gets the Isometry2 of the composed movement with a given Isometry2.
+  /// @param r_isometry Isometry2 of the given movement.
+  Isometry2 compose(const Isometry2& r_isometry) const;
+
+  /// Lifts the planar transformation into a 3D Isometry.
+  Isometry toIsometry() const;
+
+  bool operator==(const Isometry2& r_isometry) const;
+  bool operator!=(const Isometry2& r_isometry) const;
+
+  Vector3 operator*(const Vector3& r_vector) const;
+
+  Isometry2 operator*(const Isometry2& r_isometry) const;
+
+  Isometry2& operator*=(const Isometry2& r_isometry);
+
+ private:
+  Isometry2(const double x, const double y, const double theta,
+            const double cos_theta, const double sin_theta)
+      : x_{x}, y_{y}, theta_{theta}, cos_{cos_theta}, sin_{sin_theta} {};
+
+  double x_;
+  double y_;
+  double theta_;
+  double cos_;
+  double sin_;
+};
+
+std::ostream& operator<<(std::ostream& os, const Isometry2& r_isometry);
+
+}  // namespace math
+
+}  // namespace ekumen
@@ -0,0 +1,135 @@
+/*
+ * Kinematic chain library
+ * Author: Steven Desvars, 2020
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <isometry/internal/sincos.hpp>
+#include <isometry/isometry.hpp>
+#include <vector>
+
+namespace ekumen {
+
+namespace math {
+
+enum class JointType {
+  /// Rotation around the joint axis, the joint value is an angle.
+  kRevolute,
+  /// Translation along the joint axis, the joint value is a distance.
+  kPrismatic,
+};
+
+/// Serial chain of single degree of freedom joints. Each link transform is
+/// split into a fixed origin and the joint motion, and everything that does
+/// not depend on the joint value is precomputed when the joint is added, so
+/// evaluating a link costs one sincos and a handful of multiply-adds.
+class KinematicChain {
+ public:
+  /// Constructs an empty chain, its end effector is the base frame.
+  KinematicChain();
+
+  /// Appends a joint, URDF style.
+  /// @param type Joint type.
+  /// @param r_origin Transform from the previous link to the joint frame at
+  /// the zero position.
+  /// @param r_axis Joint axis in the joint frame, it gets normalized.
+  /// @throws std::invalid_argument If the axis is null.
+  void addJoint(const JointType type, const Isometry& r_origin,
+                const Vector3& r_axis);
+
+  /// Appends a joint from its classic Denavit-Hartenberg parameters, the
+  /// link transform being Rz(theta) * Tz(d) * Tx(a) * Rx(alpha). The joint
+  /// value is added to theta for revolute joints and to d for prismatic
+  /// ones.
+  /// @param type Joint type.
+  /// @param a Link length.
+  /// @param alpha Link twist.
+  /// @param d Link offset.
+  /// @param theta Joint angle.
+  void addDHJoint(const JointType type, const double a, const double alpha,
+                  const double d, const double theta);
+
+  /// Appends a fixed transform after the last joint, e.g. a tool.
+  /// @param r_tip Transform from the last link to the appended frame.
+  void addTip(const Isometry& r_tip);
+
+  /// Number of joints.
+  std::size_t dof() const { return joints_.size(); }
+
+  /// Outputs the type of a joint.
+  /// @param joint Joint index.
+  JointType type(const std::size_t joint) const {
+    return joints_.at(joint).type;
+  }
+
+  /// Outputs the unit axis of a joint in its own frame. It is left
+  /// unchanged by the joint motion, so the link pose maps it to the base
+  /// frame.
+  /// @param joint Joint index.
+  const Vector3& axis(const std::size_t joint) const {
+    return joints_.at(joint).axis;
+  }
+
+  /// Fixed transform from the last link to the end effector.
+  const Isometry& tip() const { return tip_; }
+
+  /// Gets the pose of each link in the base frame, i.e. the joint frames
+  /// after their motion.
+  /// @param q Joint values, dof() of them.
+  /// @param r_poses Output poses, dof() of them.
+  void forwardKinematics(const double* q, Isometry* r_poses) const;
+
+  /// Gets the pose of the end effector in the base frame.
+  /// @param q Joint values, dof() of them.
+  Isometry endEffector(const double* q) const;
+
+  /// Gets the end effector poses of a batch of configurations. Joint sines
+  /// and cosines are evaluated with the batch kernel in fixed-size chunks,
+  /// so it never allocates.
+  /// @param configurations Joint values, count rows of dof() values.
+  /// @param count Number of configurations.
+  /// @param r_out Output end effector poses.
+  /// @param accuracy Accuracy tier of the sine and cosine evaluation.
+  void endEffectors(
+      const double* configurations, const std::size_t count, Isometry* r_out,
+      const SinCosAccuracy accuracy = SinCosAccuracy::kFull) const;
+
+ private:
+  /// Fixed parts of a link transform. Rotations are stored row-major.
+  struct Joint {
+    JointType type;
+    /// Joint axis in the joint frame.
+    Vector3 axis;
+    /// Translation of the origin.
+    double translation[3];
+    /// Origin translation direction, the rotated axis of a prismatic joint.
+    double direction[3];
+    /// Rotation of the origin, R.
+    double rotation[9];
+    /// R * k * k^T, the term scaled by 1 - cos(q) in Rodrigues' formula.
+    double outer[9];
+    /// R * [k]x, the term scaled by sin(q) in Rodrigues' formula.
+    double skew[9];
+  };
+
+  /// Composes a pose, a row-major rotation followed by a translation, with
+  /// the link transform of a revolute joint.
+  static void advance(const Joint& r_joint, const double cosine,
+                      const double sine, double* r_pose);
+  /// Composes a pose with the link transform of a prismatic joint.
+  static void advance(const Joint& r_joint, const double value,
+                      double* r_pose);
+
+  std::vector<Joint> joints_;
+  /// Fixed transform after the last joint. It is folded into the origin of
+  /// the next joint added.
+  Isometry tip_;
+  /// tip_ as a pose, see advance().
+  double tip_pose_[12];
+};
+
+}  // namespace math
+
+}  // namespace ekumen
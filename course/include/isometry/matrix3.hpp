@@ -20,10 +20,25 @@ class Matrix3 {
   /// @param values List of values to construct the matrix3.
   explicit Matrix3(const std::initializer_list<double>& values);
 
-  /// Constructs a zero Matrix3.
-  Matrix3() : row_0_{0, 0, 0}, row_1_{0, 0, 0}, row_2_{0, 0, 0} {};
+  /// Constructs a Matrix3 from its rows.
+  /// @param r_row_0 First row.
+  /// @param r_row_1 Second row.
+  /// @param r_row_2 Third row.
+  constexpr Matrix3(const Vector3& r_row_0, const Vector3& r_row_1,
+                    const Vector3& r_row_2)
+      : row_0_{r_row_0}, row_1_{r_row_1}, row_2_{r_row_2} {};
 
-  Vector3 operator[](const int i) const;
+  /// Constructs a zero Matrix3.
+  constexpr Matrix3()
+      : row_0_{Vector3()}, row_1_{Vector3()}, row_2_{Vector3()} {};
+
+  constexpr Vector3 operator[](const int i) const {
+    return i == 0 ? row_0_
+                  : i == 1 ? row_1_
+                           : i == 2 ? row_2_
+                                    : throw std::out_of_range(
+                                          "Operator out of range");
+  }
   Vector3& operator[](const int i);
 
   static Matrix3 kIdentity;
@@ -35,7 +50,7 @@ class Matrix3 {
 
   /// Outputs a specific row of the Matrix.
   /// @param value The number of the row you want to reach.
-  Vector3 row(const int& value) const;
+  constexpr Vector3 row(const int& value) const { return (*this)[value]; }
 
   /// Outputs a specific column of the Matrix.
   /// @param value The number of the column you want to reach.
@@ -0,0 +1,64 @@
+/*
+ * Vector and matrix formatting library
+ * Author: Steven Desvars, 2020
+ *
+ * Text formatting of the types below Isometry, kept apart from format.hpp
+ * so that they don't depend on isometry.hpp.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <isometry/matrix3.hpp>
+
+namespace ekumen {
+
+namespace math {
+
+/// How numbers are written by format().
+enum class FormatMode {
+  /// Same text as operator<<: 6 significant digits for vectors and 9 for
+  /// matrices.
+  kLegacy,
+  /// Shortest text, up to 17 significant digits, that parses back to the
+  /// very same double.
+  kRoundTrip,
+};
+
+/// Buffer size that fits any formatted Isometry, Matrix3 or Vector3.
+const std::size_t kFormatBufferSize{512};
+
+/// Formats a Vector3 as "(x: 1, y: 2, z: 3)" into a caller-provided buffer,
+/// without allocating.
+/// @param r_vector Vector to format.
+/// @param buffer Output buffer, the text is null terminated.
+/// @param size Size of the buffer.
+/// @param mode How numbers are written.
+/// @returns Length of the text, without the terminating null.
+/// @throws std::length_error If the buffer is too small.
+std::size_t format(const Vector3& r_vector, char* buffer,
+                   const std::size_t size,
+                   const FormatMode mode = FormatMode::kLegacy);
+
+/// Formats a Matrix3 as "[[1, 2, 3], [4, 5, 6], [7, 8, 9]]", see
+/// format(const Vector3&, char*, const std::size_t, const FormatMode).
+std::size_t format(const Matrix3& r_matrix, char* buffer,
+                   const std::size_t size,
+                   const FormatMode mode = FormatMode::kLegacy);
+
+/// Parses a Vector3 in the format() layout, without allocating. Spaces
+/// between tokens are optional.
+/// @param text Text to parse, it needs not be null terminated.
+/// @param size Length of the text.
+/// @param r_out Output vector.
+/// @returns Number of characters consumed.
+/// @throws std::invalid_argument If the text is malformed.
+std::size_t parse(const char* text, const std::size_t size, Vector3* r_out);
+
+/// Parses a Matrix3 in the format() layout, see
+/// parse(const char*, const std::size_t, Vector3*).
+std::size_t parse(const char* text, const std::size_t size, Matrix3* r_out);
+
+}  // namespace math
+
+}  // namespace ekumen
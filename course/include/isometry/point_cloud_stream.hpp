@@ -0,0 +1,53 @@
+/*
+ * Point cloud streaming library
+ * Author: Steven Desvars, 2020
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <isometry/isometry.hpp>
+#include <string>
+
+namespace ekumen {
+
+namespace math {
+
+/// Default number of points per chunk of transformCloud().
+const std::size_t kDefaultCloudChunkPoints{65536};
+
+/// Outcome of transformCloud().
+struct CloudTransformStats {
+  /// Number of points transformed.
+  std::size_t points;
+  /// Number of chunks the points went through.
+  std::size_t chunks;
+};
+
+/// Transforms every point of a binary point cloud file into a new file,
+/// streaming it in chunks. A reader thread fills one chunk while the other
+/// one is transformed and written (double buffering), so memory stays
+/// bounded by two chunks and a scratch of chunk_points Vector3s whatever
+/// the file size. Two formats are supported, told apart by their first
+/// bytes:
+///  - PLY with format binary_little_endian 1.0 and vertex as its first
+///    element. x, y and z may be float or double, the other vertex
+///    properties and any later element are copied untouched, as is the
+///    header.
+///  - XYZ, packed little-endian float x, y and z triplets with no header.
+/// @param r_input Path of the input file.
+/// @param r_output Path of the output file, it is overwritten.
+/// @param r_isometry Transform applied to the points.
+/// @param chunk_points Number of points per chunk.
+/// @returns Counters of the run.
+/// @throws std::invalid_argument If the input is malformed or truncated,
+/// the output is the input file, or chunk_points is 0.
+/// @throws std::system_error If a file cannot be opened, read or written.
+CloudTransformStats transformCloud(
+    const std::string& r_input, const std::string& r_output,
+    const Isometry& r_isometry,
+    const std::size_t chunk_points = kDefaultCloudChunkPoints);
+
+}  // namespace math
+
+}  // namespace ekumen
@@ -0,0 +1,125 @@
+/*
+ * Pose channel library
+ * Author: Steven Desvars, 2020
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <isometry/isometry.hpp>
+#include <string>
+
+namespace ekumen {
+
+namespace math {
+
+/// Default number of poses a channel keeps in its history.
+const std::size_t kDefaultPoseChannelHistory{1024};
+
+namespace internal {
+
+struct PoseChannelSegment;
+
+}  // namespace internal
+
+/// Publishing end of a pose channel: a POSIX shared memory object holding
+/// the latest timestamped pose and a ring with the most recent ones, each
+/// guarded by a sequence lock. Publishing never waits for readers and
+/// readers never write to the shared memory, so any number of processes
+/// on the host may read while a single thread of this one publishes.
+class PoseChannelWriter {
+ public:
+  /// Creates a channel, replacing any previous one with the same name.
+  /// @param r_name Name of the channel, a slash followed by up to 254
+  /// characters other than slashes, e.g. "/robot_pose".
+  /// @param history Number of poses kept in the history ring.
+  /// @throws std::invalid_argument If the name is invalid or history is 0.
+  /// @throws std::system_error If the shared memory cannot be created.
+  explicit PoseChannelWriter(
+      const std::string& r_name,
+      const std::size_t history = kDefaultPoseChannelHistory);
+
+  PoseChannelWriter(const PoseChannelWriter&) = delete;
+  PoseChannelWriter& operator=(const PoseChannelWriter&) = delete;
+
+  /// Unmaps and removes the channel. Readers that already opened it keep
+  /// reading the last published poses.
+  ~PoseChannelWriter();
+
+  /// Publishes a pose as the latest one and appends it to the history.
+  /// @param timestamp Time of the pose.
+  /// @param r_pose Pose to publish.
+  void publish(const double timestamp, const Isometry& r_pose);
+
+  /// Number of poses published so far.
+  std::uint64_t published() const { return published_; }
+
+ private:
+  std::string name_;
+  internal::PoseChannelSegment* segment_;
+  std::size_t size_;
+  std::uint64_t published_;
+};
+
+/// Reading end of a pose channel, see PoseChannelWriter. The shared memory
+/// is mapped read-only and read in place, without decoding. Every read
+/// makes a bounded number of attempts and reports failure instead of
+/// waiting for the writer, so readers keep a bounded latency even if the
+/// writing process stalls or dies in the middle of a publication.
+class PoseChannelReader {
+ public:
+  /// Opens a channel.
+  /// @param r_name Name of the channel, see PoseChannelWriter.
+  /// @throws std::invalid_argument If the name is invalid or the shared
+  /// memory is not a pose channel.
+  /// @throws std::system_error If the channel does not exist or cannot be
+  /// mapped.
+  explicit PoseChannelReader(const std::string& r_name);
+
+  PoseChannelReader(const PoseChannelReader&) = delete;
+  PoseChannelReader& operator=(const PoseChannelReader&) = delete;
+
+  ~PoseChannelReader();
+
+  /// Number of poses published so far.
+  std::uint64_t published() const;
+
+  /// Number of poses kept in the history ring.
+  std::size_t history() const { return history_; }
+
+  /// Reads the latest pose.
+  /// @param r_timestamp Output time of the pose.
+  /// @param r_pose Output pose.
+  /// @returns Whether a consistent pose was read, false if none was
+  /// published yet or the writer kept interfering.
+  bool latest(double* r_timestamp, Isometry* r_pose) const;
+
+  /// Reads a pose of the history.
+  /// @param index Number of the pose, counting publications from 0.
+  /// @param r_timestamp Output time of the pose.
+  /// @param r_pose Output pose.
+  /// @returns Whether the pose was read, false if it is not published yet,
+  /// it was overwritten or the writer kept interfering.
+  bool at(const std::uint64_t index, double* r_timestamp,
+          Isometry* r_pose) const;
+
+  /// Reads the most recent poses of the history, oldest first. Poses that
+  /// get overwritten during the call are left out, so the output is always
+  /// a run of consecutive publications.
+  /// @param count Maximum number of poses.
+  /// @param r_timestamps Output times.
+  /// @param r_poses Output poses.
+  /// @returns Number of poses read.
+  std::size_t recent(const std::size_t count, double* r_timestamps,
+                     Isometry* r_poses) const;
+
+ private:
+  const internal::PoseChannelSegment* segment_;
+  std::size_t size_;
+  std::size_t history_;
+};
+
+}  // namespace math
+
+}  // namespace ekumen
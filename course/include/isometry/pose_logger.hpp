@@ -0,0 +1,152 @@
+/*
+ * Pose logger library
+ * Author: Steven Desvars, 2020
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <isometry/internal/bounded_queue.hpp>
+#include <isometry/isometry.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ekumen {
+
+namespace math {
+
+/// What PoseLogger::log() does when the queue is full.
+enum class PoseLogOverflow {
+  /// Waits for the writer thread to make room (back-pressure).
+  kBlock,
+  /// Discards the new record.
+  kDropNewest,
+  /// Discards the oldest queued record to make room for the new one.
+  kDropOldest,
+};
+
+/// How PoseLogger writes its records.
+enum class PoseLogFormat {
+  /// One "<timestamp> <channel> <pose>" line per record, numbers in
+  /// FormatMode::kRoundTrip.
+  kText,
+  /// Fixed-size little-endian records: timestamp, channel as a 64-bit
+  /// integer, translation and row-major rotation, see kPoseLogRecordSize.
+  kBinary,
+};
+
+/// Size of a PoseLogFormat::kBinary record.
+const std::size_t kPoseLogRecordSize{112};
+
+/// Configuration of a PoseLogger.
+struct PoseLoggerOptions {
+  /// Number of records the queue holds, a power of two.
+  std::size_t capacity{4096};
+  /// What to do when the queue is full.
+  PoseLogOverflow overflow{PoseLogOverflow::kBlock};
+  /// Output format.
+  PoseLogFormat format{PoseLogFormat::kBinary};
+  /// Maximum number of records per write to the file.
+  std::size_t batch_size{256};
+};
+
+/// Counters of a PoseLogger.
+struct PoseLoggerStats {
+  /// Records queued by log().
+  std::uint64_t logged;
+  /// Records discarded by a drop policy, never written.
+  std::uint64_t dropped;
+  /// Records written to the file.
+  std::uint64_t written;
+  /// Longest time a log() call took, in nanoseconds.
+  std::uint64_t max_enqueue_ns;
+};
+
+/// Asynchronous pose logger. log() copies the record into a lock-free
+/// bounded queue and returns, so threads in a control loop neither wait
+/// for I/O nor allocate; a background thread drains the queue in batches,
+/// formats or serializes them into a preallocated buffer and writes each
+/// batch with a single system call. Any number of threads may log
+/// concurrently.
+class PoseLogger {
+ public:
+  /// Constructs a PoseLogger and starts its writer thread.
+  /// @param r_path Path of the log file, it is overwritten.
+  /// @param r_options Configuration of the logger.
+  /// @throws std::invalid_argument If the capacity is not a power of two or
+  /// the batch size is 0.
+  /// @throws std::system_error If the file cannot be created.
+  explicit PoseLogger(const std::string& r_path,
+                      const PoseLoggerOptions& r_options =
+                          PoseLoggerOptions());
+
+  PoseLogger(const PoseLogger&) = delete;
+  PoseLogger& operator=(const PoseLogger&) = delete;
+
+  /// Writes the queued records and closes the file, errors are ignored,
+  /// see close().
+  ~PoseLogger();
+
+  /// Queues a record.
+  /// @param timestamp Time of the pose.
+  /// @param r_pose Pose to log.
+  /// @param channel Free identifier of the source of the pose.
+  /// @returns Whether the record was queued, false if it was dropped by
+  /// PoseLogOverflow::kDropNewest, the logger is closed or its writer
+  /// thread failed.
+  bool log(const double timestamp, const Isometry& r_pose,
+           const std::uint64_t channel = 0);
+
+  /// Waits until every record queued before the call is written or
+  /// dropped.
+  /// @throws std::system_error If the writer thread failed to write.
+  void flush();
+
+  /// Writes the queued records, stops the writer thread and closes the
+  /// file. Later log() calls return false; calls racing with close() may
+  /// be lost, so the logging threads must be done first.
+  /// @throws std::system_error If the writer thread failed to write or the
+  /// file cannot be closed.
+  void close();
+
+  /// Counters of the logger so far.
+  PoseLoggerStats stats() const;
+
+ private:
+  struct Record {
+    double timestamp;
+    std::uint64_t channel;
+    Isometry pose;
+  };
+
+  // Body of the writer thread.
+  void run();
+  // Appends a record to the batch buffer.
+  void serialize(const Record& r_record);
+  // Writes the batch buffer.
+  void writeBatch();
+
+  PoseLoggerOptions options_;
+  internal::BoundedQueue<Record> queue_;
+  std::vector<char> batch_;
+  std::size_t batch_used_;
+  int fd_;
+  std::atomic<bool> open_;
+  std::atomic<bool> stopping_;
+  std::atomic<std::uint64_t> logged_;
+  std::atomic<std::uint64_t> dropped_;
+  std::atomic<std::uint64_t> evicted_;
+  std::atomic<std::uint64_t> written_;
+  std::atomic<std::uint64_t> max_enqueue_ns_;
+  std::exception_ptr error_;
+  std::atomic<bool> failed_;
+  std::thread writer_;
+};
+
+}  // namespace math
+
+}  // namespace ekumen
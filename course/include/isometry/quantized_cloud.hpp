@@ -0,0 +1,116 @@
+/*
+ * Quantized point cloud library
+ * Author: Steven Desvars, 2020
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <isometry/isometry.hpp>
+#include <vector>
+
+namespace ekumen {
+
+namespace math {
+
+/// Default number of points per block of a QuantizedCloud.
+const std::size_t kDefaultQuantizedBlockPoints{1024};
+
+/// Point cloud stored as integer coordinates, 6 bytes per point with
+/// std::int16_t and 12 with std::int32_t instead of the 24 of a Vector3.
+/// Points are split in blocks of consecutive points; each block has its
+/// own offset, the center of its bounding box, and per-axis scale, so that
+/// the box spans the whole integer range. Spatially coherent clouds, such
+/// as map tiles or scans in acquisition order, get small boxes and thus
+/// fine steps.
+///
+/// The coordinates are only turned back into doubles on the fly, in
+/// decode() and in the fused transform(), which folds each block's scale
+/// and offset into the isometry so a point costs the same nine products
+/// as Isometry::transform().
+///
+/// Instantiated for std::int16_t and std::int32_t.
+template <class Integer>
+class QuantizedCloud {
+ public:
+  /// Constructs an empty QuantizedCloud.
+  QuantizedCloud();
+
+  /// Quantizes points.
+  /// @param r_points Points to quantize.
+  /// @param count Number of points.
+  /// @param block_points Number of points per block.
+  /// @throws std::invalid_argument If block_points is 0 or a coordinate is
+  /// not finite.
+  QuantizedCloud(const Vector3* r_points, const std::size_t count,
+                 const std::size_t block_points = kDefaultQuantizedBlockPoints);
+
+  std::size_t size() const { return values_.size() / 3; }
+  bool empty() const { return values_.empty(); }
+  std::size_t blockPoints() const { return block_points_; }
+  std::size_t blocks() const { return blocks_.size(); }
+
+  /// Bytes taken by the coordinates and the block parameters.
+  std::size_t memory() const;
+
+  /// Bound on the distance between a decoded point and the original one.
+  double maxError() const { return max_error_; }
+
+  /// Decodes a point.
+  /// @param i Index of the point.
+  /// @throws std::out_of_range If i is not below size().
+  Vector3 point(const std::size_t i) const;
+
+  /// Decodes a range of points.
+  /// @param first Index of the first point.
+  /// @param count Number of points.
+  /// @param r_out Output points.
+  /// @throws std::out_of_range If the range goes past size().
+  void decode(const std::size_t first, const std::size_t count,
+              Vector3* r_out) const;
+
+  /// Decodes a range of points and transforms them in the same pass, with
+  /// no full-precision copy of the cloud in between.
+  /// @param r_isometry Transform applied to the points.
+  /// @param first Index of the first point.
+  /// @param count Number of points.
+  /// @param r_out Output points, r_isometry * point(first + i).
+  /// @throws std::out_of_range If the range goes past size().
+  void transform(const Isometry& r_isometry, const std::size_t first,
+                 const std::size_t count, Vector3* r_out) const;
+
+  /// Transforms the whole cloud into a new quantized one, block by block
+  /// through a small stack buffer. The bounds of each new block are those
+  /// of the transformed box of the old one, so no extra pass is needed.
+  /// Requantization adds its own error to the one of this cloud, and the
+  /// new maxError() accounts for both.
+  /// @param r_isometry Transform applied to the points.
+  /// @returns Transformed cloud, with the same blocks.
+  QuantizedCloud transformed(const Isometry& r_isometry) const;
+
+ private:
+  // Points are offset + scale * integer, per axis.
+  struct Block {
+    double offset[3];
+    double scale[3];
+  };
+
+  // Quantizes a block of points with the given bounds.
+  // @returns Bound on the block error.
+  static double quantize(const Vector3* r_points, const std::size_t count,
+                         const double* low, const double* high,
+                         Integer* r_out, Block* r_block);
+
+  std::size_t block_points_;
+  std::vector<Integer> values_;
+  std::vector<Block> blocks_;
+  double max_error_;
+};
+
+using QuantizedCloud16 = QuantizedCloud<std::int16_t>;
+using QuantizedCloud32 = QuantizedCloud<std::int32_t>;
+
+}  // namespace math
+
+}  // namespace ekumen
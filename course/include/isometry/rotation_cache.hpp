@@ -0,0 +1,59 @@
+/*
+ * Rotation cache library
+ * Author: Steven Desvars, 2020
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <isometry/isometry.hpp>
+#include <vector>
+
+namespace ekumen {
+
+namespace math {
+
+/// Table of precomputed rotation matrices for a set of axes, quantized to a
+/// fixed number of steps per revolution. The table is filled on construction
+/// and never modified afterwards, so a single instance can be shared (e.g.
+/// through a std::shared_ptr<const RotationCache>) by any number of reader
+/// threads without locking.
+class RotationCache {
+ public:
+  /// Upper bound on the number of cached matrices, axes times resolution.
+  static const std::size_t kMaxEntries;
+
+  /// Constructs a RotationCache.
+  /// @param axes Unitary vectors to rotate around, addressed by index.
+  /// @param resolution Number of quantization steps per revolution.
+  RotationCache(const std::vector<Vector3>& axes,
+                const std::size_t resolution);
+
+  std::size_t resolution() const { return resolution_; }
+  std::size_t axisCount() const { return axis_count_; }
+
+  /// Outputs the memory used by the table, in bytes.
+  std::size_t memoryFootprint() const;
+
+  /// Gets the rotation matrix for an encoder tick. Ticks wrap around every
+  /// full revolution, so negative values are valid.
+  /// @param axis Index of the axis to rotate around.
+  /// @param tick Quantized angle, in steps of 2 * pi / resolution.
+  const Matrix3& rotation(const std::size_t axis, const long tick) const;
+
+  /// Gets the Isometry of a rotation around a cached axis, with the angle
+  /// rounded to the nearest quantization step.
+  /// @param axis Index of the axis to rotate around.
+  /// @param angle Value of the angle of rotation.
+  /// @throws std::invalid_argument If the angle is not finite.
+  Isometry rotateAround(const std::size_t axis, const double& angle) const;
+
+ private:
+  std::size_t resolution_;
+  std::size_t axis_count_;
+  std::vector<Matrix3> table_;
+};
+
+}  // namespace math
+
+}  // namespace ekumen
@@ -0,0 +1,202 @@
+/*
+ * Static transform library
+ * Author: Steven Desvars, 2020
+ */
+
+#pragma once
+
+#include <isometry/isometry.hpp>
+
+namespace ekumen {
+
+namespace math {
+
+/// Compile-time counterparts of the Isometry builders and operators, for
+/// fixed transforms such as calibrated extrinsics. A chain of them declared
+/// constexpr is folded by the compiler into a single Isometry, so the hot
+/// path only sees the precomputed result:
+///
+///   constexpr Isometry kBaseToSensor{static_transform::chain(
+///       static_transform::fromTranslation(Vector3(0.1, 0., 0.3)),
+///       static_transform::rotateAround(Vector3(0., 0., 1.), M_PI / 4.))};
+///
+/// Everything is written in C++11 constexpr style, a single return
+/// statement per function, and also works at runtime.
+namespace static_transform {
+
+namespace internal {
+
+constexpr double kPi{3.14159265358979323846};
+
+constexpr double abs(const double value) { return value < 0. ? -value : value; }
+
+constexpr double round(const double value) {
+  return value >= 0. ? static_cast<double>(static_cast<long long>(value + .5))
+                     : -static_cast<double>(
+                           static_cast<long long>(-value + .5));
+}
+
+/// Reduces an angle to [-pi, pi]. Fine for the few turns of literal angles,
+/// accuracy degrades with the magnitude.
+constexpr double reduce(const double angle) {
+  return angle - 2. * kPi * round(angle / (2. * kPi));
+}
+
+/// Adds terms of the Taylor series of the sine until they stop
+/// contributing.
+constexpr double sinSeries(const double square, const double term,
+                           const int n, const double sum) {
+  return abs(term) < 1e-18 ? sum
+                           : sinSeries(square,
+                                       -term * square / ((2 * n) * (2 * n + 1)),
+                                       n + 1, sum + term);
+}
+
+/// Sine of an angle in [-pi, pi], folded into [-pi / 2, pi / 2] where the
+/// series converges quickly.
+constexpr double sinReduced(const double angle) {
+  return angle > kPi / 2.
+             ? sinSeries((kPi - angle) * (kPi - angle), kPi - angle, 1, 0.)
+             : angle < -kPi / 2.
+                   ? sinSeries((kPi + angle) * (kPi + angle), -kPi - angle, 1,
+                               0.)
+                   : sinSeries(angle * angle, angle, 1, 0.);
+}
+
+// Accessors are reached through const references, temporaries would pick
+// the non-const overloads, which can't be constexpr in C++11.
+constexpr double entry(const Vector3& r_vector, const int i) {
+  return r_vector[i];
+}
+
+constexpr double dot(const Vector3& r_left, const Vector3& r_right) {
+  return r_left.x() * r_right.x() + r_left.y() * r_right.y() +
+         r_left.z() * r_right.z();
+}
+
+constexpr Vector3 add(const Vector3& r_left, const Vector3& r_right) {
+  return Vector3(r_left.x() + r_right.x(), r_left.y() + r_right.y(),
+                 r_left.z() + r_right.z());
+}
+
+constexpr Vector3 negate(const Vector3& r_vector) {
+  return Vector3(-r_vector.x(), -r_vector.y(), -r_vector.z());
+}
+
+constexpr Vector3 column(const Matrix3& r_matrix, const int j) {
+  return Vector3(entry(r_matrix.row(0), j), entry(r_matrix.row(1), j),
+                 entry(r_matrix.row(2), j));
+}
+
+/// Row of a matrix product, r_row * r_right.
+constexpr Vector3 productRow(const Vector3& r_row, const Matrix3& r_right) {
+  return Vector3(dot(r_row, column(r_right, 0)), dot(r_row, column(r_right, 1)),
+                 dot(r_row, column(r_right, 2)));
+}
+
+/// Rotation matrix from a unit axis and the cosine and sine of the angle.
+constexpr Matrix3 axisRotation(const Vector3& r_axis, const double cosine,
+                               const double sine) {
+  return Matrix3{
+      Vector3(cosine + r_axis.x() * r_axis.x() * (1. - cosine),
+              r_axis.x() * r_axis.y() * (1. - cosine) - r_axis.z() * sine,
+              r_axis.x() * r_axis.z() * (1. - cosine) + r_axis.y() * sine),
+      Vector3(r_axis.y() * r_axis.x() * (1. - cosine) + r_axis.z() * sine,
+              cosine + r_axis.y() * r_axis.y() * (1. - cosine),
+              r_axis.y() * r_axis.z() * (1. - cosine) - r_axis.x() * sine),
+      Vector3(r_axis.z() * r_axis.x() * (1. - cosine) - r_axis.y() * sine,
+              r_axis.z() * r_axis.y() * (1. - cosine) + r_axis.x() * sine,
+              cosine + r_axis.z() * r_axis.z() * (1. - cosine))};
+}
+
+}  // namespace internal
+
+/// Sine of an angle, accurate to a few ulp for literal angles.
+constexpr double sin(const double angle) {
+  return internal::sinReduced(internal::reduce(angle));
+}
+
+/// Cosine of an angle, accurate to a few ulp for literal angles.
+constexpr double cos(const double angle) {
+  return internal::sinReduced(internal::reduce(angle + internal::kPi / 2.));
+}
+
+/// Outputs r_matrix * r_vector.
+constexpr Vector3 rotate(const Matrix3& r_matrix, const Vector3& r_vector) {
+  return Vector3(internal::dot(r_matrix.row(0), r_vector),
+                 internal::dot(r_matrix.row(1), r_vector),
+                 internal::dot(r_matrix.row(2), r_vector));
+}
+
+/// Outputs the matrix product r_left * r_right.
+constexpr Matrix3 multiply(const Matrix3& r_left, const Matrix3& r_right) {
+  return Matrix3{internal::productRow(r_left.row(0), r_right),
+                 internal::productRow(r_left.row(1), r_right),
+                 internal::productRow(r_left.row(2), r_right)};
+}
+
+constexpr Matrix3 transpose(const Matrix3& r_matrix) {
+  return Matrix3{internal::column(r_matrix, 0), internal::column(r_matrix, 1),
+                 internal::column(r_matrix, 2)};
+}
+
+constexpr Isometry identity() {
+  return Isometry{Vector3(), Matrix3{Vector3(1., 0., 0.), Vector3(0., 1., 0.),
+                                     Vector3(0., 0., 1.)}};
+}
+
+/// See Isometry::fromTranslation().
+constexpr Isometry fromTranslation(const Vector3& r_vector) {
+  return Isometry{r_vector, identity().rotation()};
+}
+
+/// See Isometry::rotateAround().
+constexpr Isometry rotateAround(const Vector3& r_vector, const double angle) {
+  return Isometry{Vector3(),
+                  internal::axisRotation(r_vector, cos(angle), sin(angle))};
+}
+
+/// Outputs r_left * r_right.
+constexpr Isometry compose(const Isometry& r_left, const Isometry& r_right) {
+  return Isometry{
+      internal::add(rotate(r_left.rotation(), r_right.translation()),
+                    r_left.translation()),
+      multiply(r_left.rotation(), r_right.rotation())};
+}
+
+/// See Isometry::fromEulerAngles().
+constexpr Isometry fromEulerAngles(const double roll, const double pitch,
+                                   const double yaw) {
+  return compose(compose(rotateAround(Vector3(1., 0., 0.), roll),
+                         rotateAround(Vector3(0., 1., 0.), pitch)),
+                 rotateAround(Vector3(0., 0., 1.), yaw));
+}
+
+/// Inverse of an isometry, the rotation is transposed.
+constexpr Isometry inverse(const Isometry& r_isometry) {
+  return Isometry{internal::negate(rotate(transpose(r_isometry.rotation()),
+                                          r_isometry.translation())),
+                  transpose(r_isometry.rotation())};
+}
+
+/// Transforms a point.
+constexpr Vector3 transform(const Isometry& r_isometry,
+                            const Vector3& r_vector) {
+  return internal::add(rotate(r_isometry.rotation(), r_vector),
+                       r_isometry.translation());
+}
+
+/// Composes a chain of isometries, left to right.
+constexpr Isometry chain(const Isometry& r_isometry) { return r_isometry; }
+
+template <typename... Isometries>
+constexpr Isometry chain(const Isometry& r_first, const Isometry& r_second,
+                         const Isometries&... r_rest) {
+  return chain(compose(r_first, r_second), r_rest...);
+}
+
+}  // namespace static_transform
+
+}  // namespace math
+
+}  // namespace ekumen
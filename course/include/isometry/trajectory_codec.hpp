@@ -0,0 +1,108 @@
+/*
+ * Trajectory codec library
+ * Author: Steven Desvars, 2020
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <isometry/isometry.hpp>
+#include <vector>
+
+namespace ekumen {
+
+namespace math {
+
+/// Precision of encodeTrajectory().
+struct TrajectoryCodecOptions {
+  /// Translation quantization step, in the units of the poses.
+  double translation_resolution{1e-4};
+  /// Bits per quantized quaternion component, from 4 to 20. 16 bits keep
+  /// rotations within 1e-4 radians.
+  int rotation_bits{16};
+  /// Timestamp quantization step, in seconds.
+  double time_resolution{1e-6};
+};
+
+/// Size of the header of an encoded trajectory.
+const std::size_t kTrajectoryCodecHeaderSize{64};
+
+/// Encodes a trajectory in three independent streams, each laid out to be
+/// cheap to decode and to compress further with a general purpose
+/// compressor:
+///  - rotations, quantized unit quaternions in smallest-three form: the
+///    index of the largest component and the other three, all bit-packed
+///    into a fixed-size record,
+///  - translations, zigzag varints of the differences between consecutive
+///    quantized translations, so smooth motion takes a byte or two per
+///    axis and quantization errors do not accumulate,
+///  - timestamps, zigzag varints of the second differences of the
+///    quantized timestamps, a single byte at a steady rate.
+/// @param r_poses Poses to encode.
+/// @param timestamps Times of the poses, in seconds, nullptr for none.
+/// @param count Number of poses.
+/// @param r_options Precision of the encoding.
+/// @returns Encoded trajectory.
+/// @throws std::invalid_argument If the options are out of range, or a
+/// value is not finite or too large for its resolution.
+std::vector<std::uint8_t> encodeTrajectory(
+    const Isometry* r_poses, const double* timestamps,
+    const std::size_t count,
+    const TrajectoryCodecOptions& r_options = TrajectoryCodecOptions());
+
+/// Sequential decoder of an encodeTrajectory() output. The streams are
+/// validated at construction and then decoded in place, in batches of any
+/// size, so replay needs no intermediate buffers.
+class TrajectoryDecoder {
+ public:
+  /// Constructs a decoder.
+  /// @param data Encoded trajectory, it must outlive the decoder.
+  /// @param size Size of the encoded trajectory.
+  /// @throws std::invalid_argument If the data is not an encoded
+  /// trajectory, or it is truncated.
+  TrajectoryDecoder(const void* data, const std::size_t size);
+
+  /// Number of poses in the trajectory.
+  std::size_t size() const { return size_; }
+
+  /// Number of poses not decoded yet.
+  std::size_t remaining() const { return size_ - decoded_; }
+
+  bool hasTimestamps() const { return has_timestamps_; }
+
+  /// Decodes the next poses.
+  /// @param count Number of poses wanted.
+  /// @param r_poses Output poses.
+  /// @param r_timestamps Output times, nullptr to skip them.
+  /// @returns Number of poses decoded, fewer than wanted at the end.
+  /// @throws std::invalid_argument If a stream is corrupt.
+  /// @throws std::logic_error If timestamps are asked for and there are
+  /// none.
+  std::size_t decode(const std::size_t count, Isometry* r_poses,
+                     double* r_timestamps = nullptr);
+
+ private:
+  const std::uint8_t* end_;
+  const std::uint8_t* rotations_;
+  const std::uint8_t* translations_;
+  const std::uint8_t* translations_end_;
+  const std::uint8_t* times_;
+  const std::uint8_t* times_end_;
+  std::size_t size_;
+  std::size_t decoded_;
+  bool has_timestamps_;
+  int rotation_bits_;
+  std::size_t rotation_record_size_;
+  double translation_resolution_;
+  double time_resolution_;
+  // Quantized running sums in two's complement, unsigned so that the
+  // deltas of a corrupt stream wrap around instead of overflowing.
+  std::uint64_t translation_[3];
+  std::uint64_t time_;
+  std::uint64_t time_step_;
+};
+
+}  // namespace math
+
+}  // namespace ekumen
@@ -0,0 +1,153 @@
+/*
+ * Trajectory file library
+ * Author: Steven Desvars, 2020
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <isometry/internal/file_io.hpp>
+#include <isometry/isometry.hpp>
+#include <string>
+#include <vector>
+
+namespace ekumen {
+
+namespace math {
+
+/// Size of the header of a trajectory file:
+///  - bytes 0 to 3, the "EKTR" magic,
+///  - bytes 4 and 5, the version,
+///  - bytes 6 and 7, the record size,
+///  - bytes 8 to 11, the number of records between index entries,
+///  - bytes 16 to 23, the number of committed records,
+///  - bytes 24 to 31, the offset of the time index, 0 if there is none,
+///  - bytes 32 to 39, the number of index entries,
+/// all integers little-endian. Records follow the header, each one a
+/// timestamp and an Isometry encoded as in binary.hpp. The time index, the
+/// timestamp of every n-th record, follows the last record.
+const std::size_t kTrajectoryHeaderSize{64};
+
+/// Size of a trajectory record.
+const std::size_t kTrajectoryRecordSize{13 * sizeof(double)};
+
+/// Streaming writer of trajectory files. Records are batched in memory and
+/// committed by flush(): they are written and synced first, and only then
+/// the record count in the header is updated and synced, so a crash leaves
+/// the file with every record committed up to then and nothing else. The
+/// time index is written by close(), readers rebuild it when it is missing.
+class TrajectoryWriter {
+ public:
+  /// Default number of records batched between automatic flushes.
+  static const std::size_t kDefaultFlushInterval;
+
+  /// Default number of records between time index entries.
+  static const std::size_t kDefaultIndexStride;
+
+  /// Opens a trajectory file for appending, creating it if needed.
+  /// @param r_path Path of the file.
+  /// @param flush_interval Records appended between automatic flushes.
+  /// @param index_stride Records between time index entries, for new files.
+  /// @throws std::system_error If the file cannot be opened or written.
+  /// @throws std::invalid_argument If the file is not a trajectory file, or
+  /// an interval is 0.
+  explicit TrajectoryWriter(
+      const std::string& r_path,
+      const std::size_t flush_interval = kDefaultFlushInterval,
+      const std::size_t index_stride = kDefaultIndexStride);
+
+  TrajectoryWriter(const TrajectoryWriter&) = delete;
+  TrajectoryWriter& operator=(const TrajectoryWriter&) = delete;
+
+  /// Closes the file, see close(). Errors are swallowed.
+  ~TrajectoryWriter();
+
+  /// Appends a record. It does not allocate.
+  /// @param timestamp Time of the record, in seconds. Timestamps must not
+  /// decrease.
+  /// @param r_pose Pose at that time.
+  /// @throws std::invalid_argument If the timestamp decreases or is NaN.
+  /// @throws std::system_error If an automatic flush fails. Pending records
+  /// are kept, and the next call retries the flush before storing its own.
+  /// @throws std::logic_error If the writer is closed.
+  void append(const double timestamp, const Isometry& r_pose);
+
+  /// Commits the appended records to disk.
+  /// @throws std::system_error If writing fails.
+  void flush();
+
+  /// Commits the appended records, writes the time index and closes the
+  /// file. Further calls do nothing.
+  /// @throws std::system_error If writing fails.
+  void close();
+
+  /// Number of records, committed or not.
+  std::size_t size() const { return committed_ + pending_; }
+
+  /// Number of records committed to disk.
+  std::size_t committed() const { return committed_; }
+
+ private:
+  void writeAll(const unsigned char* bytes, const std::size_t size,
+                const std::size_t offset);
+  void sync();
+
+  int fd_;
+  std::size_t index_stride_;
+  std::size_t committed_;
+  std::size_t pending_;
+  double last_timestamp_;
+  std::vector<unsigned char> buffer_;
+};
+
+/// Read-only memory-mapped view of a trajectory file, as of when it is
+/// opened. Records are decoded in place on access.
+class TrajectoryReader {
+ public:
+  /// Opens and maps a trajectory file.
+  /// @param r_path Path of the file.
+  /// @throws std::system_error If the file cannot be opened or mapped.
+  /// @throws std::invalid_argument If it is not a trajectory file, or it is
+  /// truncated.
+  explicit TrajectoryReader(const std::string& r_path);
+
+  TrajectoryReader(const TrajectoryReader&) = delete;
+  TrajectoryReader& operator=(const TrajectoryReader&) = delete;
+
+  std::size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  /// Outputs the i-th record timestamp, in O(1).
+  /// @throws std::out_of_range If i is not below size().
+  double timestamp(const std::size_t i) const;
+
+  /// Outputs the i-th record pose, in O(1).
+  /// @throws std::out_of_range If i is not below size().
+  Isometry pose(const std::size_t i) const;
+
+  /// Finds the first record not older than a given time. The time index
+  /// narrows the search down to one stride, so it is O(log n) and touches a
+  /// handful of pages.
+  /// @param timestamp Query time, in seconds.
+  /// @returns Index of the record, size() if all are older.
+  std::size_t seek(const double timestamp) const;
+
+  /// Gets the pose at a given time, interpolating between the two
+  /// neighboring records, see Isometry::interpolate().
+  /// @param timestamp Query time, in seconds.
+  /// @throws std::out_of_range If the time is outside the recorded span.
+  Isometry lookup(const double timestamp) const;
+
+ private:
+  const unsigned char* record(const std::size_t i) const;
+
+  internal::FileMapping mapping_;
+  const unsigned char* records_;
+  std::size_t size_;
+  std::size_t index_stride_;
+  std::vector<double> index_;
+};
+
+}  // namespace math
+
+}  // namespace ekumen
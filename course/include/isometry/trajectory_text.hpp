@@ -0,0 +1,78 @@
+/*
+ * Text trajectory library
+ * Author: Steven Desvars, 2020
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <isometry/isometry.hpp>
+#include <string>
+#include <vector>
+
+namespace ekumen {
+
+namespace math {
+
+/// Text layouts of trajectory and calibration files. Lines are separated
+/// by "\n" or "\r\n"; blank lines and lines starting with '#' are skipped.
+enum class TrajectoryTextFormat {
+  /// "timestamp tx ty tz qx qy qz qw", separated by spaces or tabs, as in
+  /// the TUM RGB-D benchmark. Quaternions are normalized when read.
+  kTum,
+  /// The TUM fields separated by commas. Lines starting with a letter,
+  /// such as a column header, are skipped.
+  kCsv,
+  /// The 3x4 row-major matrix [R | t], 12 numbers separated by spaces or
+  /// tabs, as in the KITTI odometry ground truth. There are no timestamps.
+  /// A leading label ending in ':', as in KITTI calibration files ("Tr:"),
+  /// is skipped.
+  kKitti,
+};
+
+/// Trajectory read by loadTrajectoryText().
+struct TextTrajectory {
+  /// Times of the poses, empty for TrajectoryTextFormat::kKitti.
+  std::vector<double> timestamps;
+  std::vector<Isometry> poses;
+};
+
+/// Reads a trajectory file. The file is mapped and split in ranges of
+/// whole lines. Threads count the records of their ranges, and then parse
+/// them in place straight into the output arrays, with no stream and no
+/// allocation per line.
+/// @param r_path Path of the file.
+/// @param format Layout of the file.
+/// @param threads Number of threads, 0 to pick one per core for large
+/// files.
+/// @returns Poses of the file, and their times if the format has them.
+/// @throws std::invalid_argument If a line is malformed, the message tells
+/// which one.
+/// @throws std::system_error If the file cannot be opened or mapped.
+TextTrajectory loadTrajectoryText(const std::string& r_path,
+                                  const TrajectoryTextFormat format,
+                                  const std::size_t threads = 0);
+
+/// Writes a trajectory file, numbers in the shortest text that parses back
+/// to the same double, so KITTI files round trip exactly and TUM ones up
+/// to the conversion to quaternions. Lines are formatted by several
+/// threads for large trajectories, and written in order.
+/// @param r_path Path of the file, it is overwritten.
+/// @param format Layout of the file.
+/// @param r_poses Poses to write.
+/// @param timestamps Times of the poses, ignored for
+/// TrajectoryTextFormat::kKitti.
+/// @param count Number of poses.
+/// @param threads Number of threads, 0 to pick one per core.
+/// @throws std::invalid_argument If the format needs timestamps and there
+/// are none.
+/// @throws std::system_error If the file cannot be written.
+void saveTrajectoryText(const std::string& r_path,
+                        const TrajectoryTextFormat format,
+                        const Isometry* r_poses, const double* timestamps,
+                        const std::size_t count,
+                        const std::size_t threads = 0);
+
+}  // namespace math
+
+}  // namespace ekumen
@@ -0,0 +1,101 @@
+/*
+ * Transform buffer library
+ * Author: Steven Desvars, 2020
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <isometry/isometry.hpp>
+#include <vector>
+
+namespace ekumen {
+
+namespace math {
+
+/// Fixed-capacity history of time-stamped transforms for a single frame
+/// edge. Samples are kept in a ring buffer ordered by time, the oldest one
+/// being overwritten when the buffer is full. Nothing is allocated after
+/// construction.
+class TransformBuffer {
+ public:
+  /// Constructs a TransformBuffer.
+  /// @param capacity Maximum number of samples kept.
+  /// @param max_extrapolation How far beyond the oldest and newest samples,
+  /// in seconds, lookups may extrapolate.
+  explicit TransformBuffer(const std::size_t capacity,
+                           const double max_extrapolation = 0.);
+
+  /// Inserts a sample. Timestamps must not decrease, a sample with the same
+  /// timestamp as the newest one replaces it.
+  /// @param timestamp Time of the sample, in seconds.
+  /// @param r_transform Transform at that time.
+  void insert(const double timestamp, const Isometry& r_transform);
+
+  std::size_t size() const { return size_; }
+  std::size_t capacity() const { return samples_.size(); }
+  bool empty() const { return size_ == 0; }
+  double maxExtrapolation() const { return max_extrapolation_; }
+
+  /// Removes all the samples.
+  void clear();
+
+  /// Outputs the timestamp of the oldest sample.
+  double oldestTime() const;
+
+  /// Outputs the timestamp of the newest sample.
+  double newestTime() const;
+
+  /// Outputs the i-th sample timestamp, 0 being the oldest one.
+  double timestamp(const std::size_t i) const;
+
+  /// Outputs the i-th sample transform, 0 being the oldest one.
+  const Isometry& transform(const std::size_t i) const;
+
+  /// Gets the transform at a given time, interpolating between the two
+  /// neighboring samples. Binary search makes it O(log n).
+  /// @param timestamp Query time, in seconds.
+  /// @throws std::out_of_range If the time is beyond the extrapolation
+  /// horizon, or the buffer is empty.
+  Isometry lookup(const double timestamp) const;
+
+  /// Gets the transforms at a batch of times. Sorted times are served in a
+  /// single walk over the buffer, with the relative rotation of each pair
+  /// of samples extracted once and the interpolation done in batches, see
+  /// Isometry::interpolate(). Unsorted times are sorted first, which
+  /// allocates.
+  /// @param timestamps Query times, in seconds.
+  /// @param count Number of query times.
+  /// @param r_out Output transforms, in the order of the query times.
+  /// @param accuracy Accuracy tier of the sine and cosine evaluation.
+  /// @throws std::out_of_range If a time is beyond the extrapolation
+  /// horizon, or the buffer is empty. Nothing is written then.
+  void lookup(const double* timestamps, const std::size_t count,
+              Isometry* r_out,
+              const SinCosAccuracy accuracy = SinCosAccuracy::kFull) const;
+
+ private:
+  struct Sample {
+    double timestamp;
+    Isometry transform;
+  };
+
+  const Sample& at(const std::size_t i) const;
+
+  // Transform at a time between samples i - 1 and i.
+  Isometry interpolate(const std::size_t i, const double timestamp) const;
+
+  // Batch lookup of the times in the given order, nullptr meaning sorted.
+  void lookupInOrder(const double* timestamps, const std::size_t* order,
+                     const std::size_t count, Isometry* r_out,
+                     const SinCosAccuracy accuracy) const;
+
+  std::vector<Sample> samples_;
+  double max_extrapolation_;
+  std::size_t oldest_;
+  std::size_t size_;
+};
+
+}  // namespace math
+
+}  // namespace ekumen
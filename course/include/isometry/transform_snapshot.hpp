@@ -0,0 +1,71 @@
+/*
+ * Transform snapshot library
+ * Author: Steven Desvars, 2020
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <isometry/frame_tree.hpp>
+#include <isometry/transform_buffer.hpp>
+#include <string>
+#include <vector>
+
+namespace ekumen {
+
+namespace math {
+
+/// Size of the header of a transform snapshot file.
+const std::size_t kTransformSnapshotHeaderSize{64};
+
+/// Largest buffer capacity a transform snapshot holds, so a damaged file
+/// can't make loadTransformSnapshot() allocate without bound.
+const std::size_t kMaxSnapshotBufferCapacity{std::size_t{1} << 24};
+
+/// Sample history of a dynamic edge to be saved in a snapshot.
+struct SnapshotBuffer {
+  /// Name of the buffer, usually the child frame of the edge.
+  std::string name;
+  /// Buffer to save, it must outlive the saveTransformSnapshot() call.
+  const TransformBuffer* buffer;
+};
+
+/// Transform state restored by loadTransformSnapshot().
+struct TransformSnapshot {
+  /// Frame tree, with its world poses up to date.
+  FrameTree tree;
+  /// Names of the buffers, in the order they were saved.
+  std::vector<std::string> buffer_names;
+  /// Buffers, with their capacity, extrapolation horizon and samples.
+  std::vector<TransformBuffer> buffers;
+};
+
+/// Saves a transform state to a compact binary file: the frames of a tree
+/// with the transforms to their parents, then the buffers, as fixed-size
+/// little-endian records, then the names. Restoring it copies the
+/// matrices as they are, so nothing is rebuilt from Euler angles or
+/// axis-angle pairs. The file is written aside and renamed over r_path, so
+/// a crash never leaves a partial snapshot behind.
+/// @param r_path Path of the snapshot file.
+/// @param r_tree Frame tree to save, including its static edges.
+/// @param r_buffers Buffers to save.
+/// @throws std::invalid_argument If a buffer is nullptr or its capacity is
+/// above kMaxSnapshotBufferCapacity.
+/// @throws std::length_error If the names add up to more than 4 GiB.
+/// @throws std::system_error If the file cannot be written.
+void saveTransformSnapshot(const std::string& r_path, const FrameTree& r_tree,
+                           const std::vector<SnapshotBuffer>& r_buffers =
+                               std::vector<SnapshotBuffer>());
+
+/// Restores a transform state saved by saveTransformSnapshot(). The file is
+/// mapped once and validated, sizes, buffer capacities, checksum, tree
+/// structure, name ranges and sample order, before anything is built from it.
+/// @param r_path Path of the snapshot file.
+/// @returns Restored state.
+/// @throws std::invalid_argument If the file is not a valid snapshot.
+/// @throws std::system_error If the file cannot be opened or mapped.
+TransformSnapshot loadTransformSnapshot(const std::string& r_path);
+
+}  // namespace math
+
+}  // namespace ekumen
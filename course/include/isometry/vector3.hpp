@@ -11,6 +11,7 @@
 #include <cmath>
 #include <initializer_list>
 #include <iostream>
+#include <limits>
 #include <sstream>
 #include <stdexcept>
 #include <string>
@@ -30,19 +31,25 @@ almost_equal(T x, T y, int ulp) {
 
 class Vector3 {
  public:
-  Vector3(const double x, const double y, const double z)
+  constexpr Vector3(const double x, const double y, const double z)
       : x_{x}, y_{y}, z_{z} {};
   Vector3(const std::initializer_list<double>& list);
-  Vector3() : x_{0}, y_{0}, z_{0} {};
-
-  double operator[](const int i) const;
+  constexpr Vector3() : x_{0}, y_{0}, z_{0} {};
+
+  constexpr double operator[](const int i) const {
+    return i == 0 ? x_
+                  : i == 1 ? y_
+                           : i == 2 ? z_
+                                    : throw std::out_of_range(
+                                          "Operator out of range");
+  }
   double& operator[](const int i);
 
-  double x() const { return x_; }
+  constexpr double x() const { return x_; }
   double& x() { return x_; }
-  double y() const { return y_; }
+  constexpr double y() const { return y_; }
   double& y() { return y_; }
-  double z() const { return z_; }
+  constexpr double z() const { return z_; }
   double& z() { return z_; }
 
   double dot(const Vector3& r_vector) const;
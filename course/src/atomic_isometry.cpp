@@ -0,0 +1,61 @@
+/*
+ * Atomic isometry library
+ * Author: Steven Desvars, 2020
+ * Copyright 2020 Ekumen
+ */
+
+#include <isometry/atomic_isometry.hpp>
+
+#include <array>
+
+namespace ekumen {
+namespace math {
+
+namespace {
+
+std::array<double, 3> toValues(const Vector3& r_vector) {
+  return {{r_vector.x(), r_vector.y(), r_vector.z()}};
+}
+
+// Translation followed by the rotation, row by row.
+std::array<double, 12> toValues(const Isometry& r_isometry) {
+  const Vector3 translation{r_isometry.translation()};
+  const Matrix3 rotation{r_isometry.rotation()};
+  const Vector3 rows[] = {rotation[0], rotation[1], rotation[2]};
+  return {{translation.x(), translation.y(), translation.z(), rows[0].x(),
+           rows[0].y(), rows[0].z(), rows[1].x(), rows[1].y(), rows[1].z(),
+           rows[2].x(), rows[2].y(), rows[2].z()}};
+}
+
+}  // namespace
+
+AtomicVector3::AtomicVector3(const Vector3& r_vector)
+    : lock_{toValues(r_vector).data()} {}
+
+void AtomicVector3::store(const Vector3& r_vector) {
+  lock_.store(toValues(r_vector).data());
+}
+
+Vector3 AtomicVector3::load() const {
+  double values[3];
+  lock_.load(values);
+  return Vector3(values[0], values[1], values[2]);
+}
+
+AtomicIsometry::AtomicIsometry(const Isometry& r_isometry)
+    : lock_{toValues(r_isometry).data()} {}
+
+void AtomicIsometry::store(const Isometry& r_isometry) {
+  lock_.store(toValues(r_isometry).data());
+}
+
+Isometry AtomicIsometry::load() const {
+  double v[12];
+  lock_.load(v);
+  return Isometry{Vector3(v[0], v[1], v[2]),
+                  Matrix3{v[3], v[4], v[5], v[6], v[7], v[8], v[9], v[10],
+                          v[11]}};
+}
+
+}  // namespace math
+}  // namespace ekumen
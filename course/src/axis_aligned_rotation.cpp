@@ -0,0 +1,195 @@
+/*
+ * Axis-aligned rotation library
+ * Author: Steven Desvars, 2020
+ * Copyright 2020 Ekumen
+ */
+
+#include <isometry/axis_aligned_rotation.hpp>
+
+#include <cmath>
+
+namespace ekumen {
+namespace math {
+
+namespace {
+
+double signed_value(const double value, const int sign) {
+  return sign > 0 ? value : -value;
+}
+
+Vector3 signed_vector(const Vector3& r_vector, const int sign) {
+  return sign > 0 ? r_vector
+                  : Vector3(-r_vector.x(), -r_vector.y(), -r_vector.z());
+}
+
+}  // namespace
+
+bool AxisAlignedRotation::fromAxisAngle(const Vector3& r_vector,
+                                        const double& angle,
+                                        AxisAlignedRotation* r_out) {
+  int axis = -1;
+  for (int i = 0; i < 3; ++i) {
+    if (r_vector[i] == 1. || r_vector[i] == -1.) {
+      if (axis != -1) {
+        return false;
+      }
+      axis = i;
+    } else if (r_vector[i] != 0.) {
+      return false;
+    }
+  }
+  // Quantizing would turn infinities into NaN quadrants.
+  if (axis == -1 || !std::isfinite(angle)) {
+    return false;
+  }
+  const double quarters = angle / (M_PI / 2.);
+  const double rounded = std::round(quarters);
+  if (quarters != rounded && !almost_equal(quarters, rounded, 2)) {
+    return false;
+  }
+  const double turns = std::fmod(rounded, 4.);
+  const int quadrant = static_cast<int>(turns < 0. ? turns + 4. : turns);
+  const int cosines[] = {1, 0, -1, 0};
+  const int sines[] = {0, 1, 0, -1};
+  const int c = cosines[quadrant];
+  const int s = sines[quadrant] * static_cast<int>(r_vector[axis]);
+  // Rotation by c, s around the axis: the axis row is fixed and the other
+  // two coordinates rotate within their plane.
+  const int next = (axis + 1) % 3;
+  const int prev = (axis + 2) % 3;
+  AxisAlignedRotation aux;
+  aux.axes_[axis] = static_cast<std::int8_t>(axis);
+  aux.signs_[axis] = 1;
+  if (c != 0) {
+    aux.axes_[next] = static_cast<std::int8_t>(next);
+    aux.signs_[next] = static_cast<std::int8_t>(c);
+    aux.axes_[prev] = static_cast<std::int8_t>(prev);
+    aux.signs_[prev] = static_cast<std::int8_t>(c);
+  } else {
+    aux.axes_[next] = static_cast<std::int8_t>(prev);
+    aux.signs_[next] = static_cast<std::int8_t>(-s);
+    aux.axes_[prev] = static_cast<std::int8_t>(next);
+    aux.signs_[prev] = static_cast<std::int8_t>(s);
+  }
+  *r_out = aux;
+  return true;
+}
+
+bool AxisAlignedRotation::fromMatrix(const Matrix3& r_matrix,
+                                     AxisAlignedRotation* r_out) {
+  AxisAlignedRotation aux;
+  bool used[] = {false, false, false};
+  for (int i = 0; i < 3; ++i) {
+    const Vector3 row{r_matrix[i]};
+    int axis = -1;
+    for (int j = 0; j < 3; ++j) {
+      if (row[j] == 1. || row[j] == -1.) {
+        if (axis != -1) {
+          return false;
+        }
+        axis = j;
+      } else if (row[j] != 0.) {
+        return false;
+      }
+    }
+    if (axis == -1 || used[axis]) {
+      return false;
+    }
+    used[axis] = true;
+    aux.axes_[i] = static_cast<std::int8_t>(axis);
+    aux.signs_[i] = static_cast<std::int8_t>(row[axis]);
+  }
+  // Reflections are signed permutations too, but not rotations.
+  if (aux.toMatrix().det() != 1.) {
+    return false;
+  }
+  *r_out = aux;
+  return true;
+}
+
+Vector3 AxisAlignedRotation::transform(const Vector3& r_vector) const {
+  return (*this) * r_vector;
+}
+
+AxisAlignedRotation AxisAlignedRotation::inverse() const {
+  AxisAlignedRotation aux;
+  for (int i = 0; i < 3; ++i) {
+    aux.axes_[axes_[i]] = static_cast<std::int8_t>(i);
+    aux.signs_[axes_[i]] = signs_[i];
+  }
+  return aux;
+}
+
+AxisAlignedRotation AxisAlignedRotation::compose(
+    const AxisAlignedRotation& r_rotation) const {
+  return (*this) * r_rotation;
+}
+
+Matrix3 AxisAlignedRotation::product(const Matrix3& r_matrix) const {
+  Matrix3 aux;
+  for (int i = 0; i < 3; ++i) {
+    aux[i] = signed_vector(r_matrix[axes_[i]], signs_[i]);
+  }
+  return aux;
+}
+
+Matrix3 AxisAlignedRotation::rightProduct(const Matrix3& r_matrix) const {
+  Matrix3 aux;
+  for (int i = 0; i < 3; ++i) {
+    const Vector3 row{r_matrix[i]};
+    for (int k = 0; k < 3; ++k) {
+      aux[i][axes_[k]] = signed_value(row[k], signs_[k]);
+    }
+  }
+  return aux;
+}
+
+Matrix3 AxisAlignedRotation::toMatrix() const {
+  Matrix3 aux;
+  for (int i = 0; i < 3; ++i) {
+    aux[i][axes_[i]] = signs_[i];
+  }
+  return aux;
+}
+
+bool AxisAlignedRotation::operator==(
+    const AxisAlignedRotation& r_rotation) const {
+  for (int i = 0; i < 3; ++i) {
+    if (axes_[i] != r_rotation.axes_[i] || signs_[i] != r_rotation.signs_[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool AxisAlignedRotation::operator!=(
+    const AxisAlignedRotation& r_rotation) const {
+  return !(*this == r_rotation);
+}
+
+Vector3 AxisAlignedRotation::operator*(const Vector3& r_vector) const {
+  const double values[] = {r_vector.x(), r_vector.y(), r_vector.z()};
+  return Vector3(signed_value(values[axes_[0]], signs_[0]),
+                 signed_value(values[axes_[1]], signs_[1]),
+                 signed_value(values[axes_[2]], signs_[2]));
+}
+
+AxisAlignedRotation AxisAlignedRotation::operator*(
+    const AxisAlignedRotation& r_rotation) const {
+  AxisAlignedRotation aux;
+  for (int i = 0; i < 3; ++i) {
+    aux.axes_[i] = r_rotation.axes_[axes_[i]];
+    aux.signs_[i] =
+        static_cast<std::int8_t>(signs_[i] * r_rotation.signs_[axes_[i]]);
+  }
+  return aux;
+}
+
+std::ostream& operator<<(std::ostream& os,
+                         const AxisAlignedRotation& r_rotation) {
+  os << r_rotation.toMatrix();
+  return os;
+}
+
+}  // namespace math
+}  // namespace ekumen
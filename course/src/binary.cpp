@@ -0,0 +1,140 @@
+/*
+ * Binary serialization library
+ * Author: Steven Desvars, 2020
+ * Copyright 2020 Ekumen
+ */
+
+#include <isometry/binary.hpp>
+
+namespace ekumen {
+namespace math {
+
+namespace {
+
+const unsigned char kMagic[]{'E', 'K', 'I', 'S'};
+
+template <class T>
+std::size_t encodeAll(const T* r_values, const std::size_t count,
+                      void* buffer, const std::size_t size) {
+  const std::size_t kElementSize{internal::BinaryLayout<T>::kDoubles *
+                                 sizeof(double)};
+  if (size < kBinaryHeaderSize ||
+      count > (size - kBinaryHeaderSize) / kElementSize) {
+    throw std::length_error("Binary buffer too small");
+  }
+  unsigned char* bytes = static_cast<unsigned char*>(buffer);
+  std::memcpy(bytes, kMagic, sizeof(kMagic));
+  internal::storeInteger(kBinaryVersion, 2, bytes + 4);
+  internal::storeInteger(
+      static_cast<std::uint16_t>(internal::BinaryLayout<T>::kType), 2,
+      bytes + 6);
+  internal::storeInteger(count, 8, bytes + 8);
+  unsigned char* elements = bytes + kBinaryHeaderSize;
+  for (std::size_t i = 0; i < count; ++i) {
+    internal::store(r_values[i], elements + i * kElementSize);
+  }
+  return binarySize<T>(count);
+}
+
+}  // namespace
+
+namespace internal {
+
+void storeInteger(std::uint64_t value, const std::size_t bytes,
+                  unsigned char* r_out) {
+  for (std::size_t i = 0; i < bytes; ++i) {
+    r_out[i] = static_cast<unsigned char>(value & 0xff);
+    value >>= 8;
+  }
+}
+
+std::uint64_t loadInteger(const unsigned char* bytes, const std::size_t size) {
+  std::uint64_t value{0};
+  for (std::size_t i = size; i > 0; --i) {
+    value = (value << 8) | bytes[i - 1];
+  }
+  return value;
+}
+
+void storeDoubles(const double* values, const std::size_t count,
+                  unsigned char* r_out) {
+  if (isLittleEndian()) {
+    std::memcpy(r_out, values, count * sizeof(double));
+    return;
+  }
+  for (std::size_t i = 0; i < count; ++i) {
+    std::uint64_t bits;
+    std::memcpy(&bits, values + i, sizeof(double));
+    storeInteger(bits, sizeof(double), r_out + i * sizeof(double));
+  }
+}
+
+void store(const Vector3& r_vector, unsigned char* r_out) {
+  const double values[]{r_vector.x(), r_vector.y(), r_vector.z()};
+  storeDoubles(values, 3, r_out);
+}
+
+void store(const Matrix3& r_matrix, unsigned char* r_out) {
+  for (int i = 0; i < 3; ++i) {
+    store(r_matrix[i], r_out + i * 3 * sizeof(double));
+  }
+}
+
+void store(const Isometry& r_isometry, unsigned char* r_out) {
+  store(r_isometry.translation(), r_out);
+  store(r_isometry.rotation(), r_out + 3 * sizeof(double));
+}
+
+std::size_t checkBinaryHeader(const unsigned char* bytes,
+                              const std::size_t size, const BinaryType type,
+                              const std::size_t element_size) {
+  if (size < kBinaryHeaderSize) {
+    throw std::invalid_argument("Truncated binary header");
+  }
+  if (std::memcmp(bytes, kMagic, sizeof(kMagic)) != 0) {
+    throw std::invalid_argument("Not a binary isometry buffer");
+  }
+  if (loadInteger(bytes + 4, 2) != kBinaryVersion) {
+    throw std::invalid_argument("Unsupported binary version");
+  }
+  if (loadInteger(bytes + 6, 2) != static_cast<std::uint16_t>(type)) {
+    throw std::invalid_argument("Binary element type mismatch");
+  }
+  const std::uint64_t count = loadInteger(bytes + 8, 8);
+  if (count > (size - kBinaryHeaderSize) / element_size) {
+    throw std::invalid_argument("Truncated binary elements");
+  }
+  return static_cast<std::size_t>(count);
+}
+
+}  // namespace internal
+
+std::size_t encode(const Vector3* r_values, const std::size_t count,
+                   void* buffer, const std::size_t size) {
+  return encodeAll(r_values, count, buffer, size);
+}
+
+std::size_t encode(const Matrix3* r_values, const std::size_t count,
+                   void* buffer, const std::size_t size) {
+  return encodeAll(r_values, count, buffer, size);
+}
+
+std::size_t encode(const Isometry* r_values, const std::size_t count,
+                   void* buffer, const std::size_t size) {
+  return encodeAll(r_values, count, buffer, size);
+}
+
+template <class T>
+BinaryView<T>::BinaryView(const void* buffer, const std::size_t size)
+    : elements_{static_cast<const unsigned char*>(buffer) +
+                kBinaryHeaderSize},
+      size_{internal::checkBinaryHeader(
+          static_cast<const unsigned char*>(buffer), size,
+          internal::BinaryLayout<T>::kType, kElementSize)} {}
+
+template class BinaryView<Vector3>;
+template class BinaryView<Matrix3>;
+template class BinaryView<Isometry>;
+
+}  // namespace math
+}  // namespace ekumen
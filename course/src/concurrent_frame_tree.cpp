@@ -0,0 +1,186 @@
+/*
+ * Concurrent frame tree library
+ * Author: Steven Desvars, 2020
+ * Copyright 2020 Ekumen
+ */
+
+#include <isometry/concurrent_frame_tree.hpp>
+
+#include <stdlib.h>
+
+#include <limits>
+#include <new>
+#include <stdexcept>
+
+namespace ekumen {
+namespace math {
+
+namespace {
+
+// Epoch value of a slot whose reader is not inside a read section.
+const std::uint64_t kIdle{std::numeric_limits<std::uint64_t>::max()};
+
+}  // namespace
+
+const std::size_t ConcurrentFrameTree::kDefaultMaxReaders{128};
+
+void* ConcurrentFrameTree::ReaderSlot::operator new[](const std::size_t size) {
+  void* memory;
+  if (::posix_memalign(&memory, alignof(ReaderSlot), size) != 0) {
+    throw std::bad_alloc();
+  }
+  return memory;
+}
+
+void ConcurrentFrameTree::ReaderSlot::operator delete[](void* memory) {
+  ::free(memory);
+}
+
+ConcurrentFrameTree::ConcurrentFrameTree(const FrameTree& r_tree,
+                                         const std::size_t max_readers)
+    : current_{new FrameTree(r_tree)},
+      epoch_{0},
+      max_readers_{max_readers},
+      slots_{new ReaderSlot[max_readers]} {
+  for (std::size_t i = 0; i < max_readers_; ++i) {
+    slots_[i].epoch.store(kIdle);
+    slots_[i].in_use.store(false);
+  }
+}
+
+ConcurrentFrameTree::~ConcurrentFrameTree() {
+  for (const auto& retired : retired_) {
+    delete retired.second;
+  }
+  delete current_.load();
+}
+
+ConcurrentFrameTree::Reader::Reader(Reader&& r_reader)
+    : owner_{r_reader.owner_}, slot_{r_reader.slot_} {
+  r_reader.owner_ = nullptr;
+}
+
+ConcurrentFrameTree::Reader::~Reader() {
+  if (owner_ != nullptr) {
+    owner_->releaseSlot(slot_);
+  }
+}
+
+Isometry ConcurrentFrameTree::Reader::lookup(const std::string& target,
+                                             const std::string& source) const {
+  const Guard guard{owner_, slot_};
+  return guard.tree().lookup(target, source);
+}
+
+Isometry ConcurrentFrameTree::Reader::lookup(const FrameId target,
+                                             const FrameId source) const {
+  const Guard guard{owner_, slot_};
+  return guard.tree().lookup(target, source);
+}
+
+FrameId ConcurrentFrameTree::Reader::id(const std::string& name) const {
+  const Guard guard{owner_, slot_};
+  return guard.tree().id(name);
+}
+
+void ConcurrentFrameTree::Reader::read(
+    const std::function<void(const FrameTree&)>& r_function) const {
+  const Guard guard{owner_, slot_};
+  r_function(guard.tree());
+}
+
+ConcurrentFrameTree::Reader ConcurrentFrameTree::reader() {
+  for (std::size_t i = 0; i < max_readers_; ++i) {
+    bool expected = false;
+    if (!slots_[i].in_use.load(std::memory_order_relaxed) &&
+        slots_[i].in_use.compare_exchange_strong(expected, true)) {
+      return Reader{this, i};
+    }
+  }
+  throw std::runtime_error("No free reader slots");
+}
+
+void ConcurrentFrameTree::update(
+    const std::function<void(FrameTree*)>& r_update) {
+  std::lock_guard<std::mutex> lock{writer_mutex_};
+  std::unique_ptr<FrameTree> next{new FrameTree(*current_.load())};
+  r_update(next.get());
+  next->updateWorldPoses();
+  const FrameTree* previous = current_.exchange(next.release());
+  // Readers that enter from now on announce an epoch at least this large,
+  // and they are guaranteed to load the new snapshot.
+  const std::uint64_t retire_epoch = epoch_.fetch_add(1) + 1;
+  retired_.push_back(std::make_pair(retire_epoch, previous));
+  reclaim();
+}
+
+FrameId ConcurrentFrameTree::addFrame(const std::string& name,
+                                      const std::string& parent,
+                                      const Isometry& r_transform) {
+  FrameId frame{0};
+  update([&](FrameTree* tree) {
+    frame = tree->addFrame(name, parent, r_transform);
+  });
+  return frame;
+}
+
+FrameId ConcurrentFrameTree::addFrame(const std::string& name,
+                                      const FrameId parent,
+                                      const Isometry& r_transform) {
+  FrameId frame{0};
+  update([&](FrameTree* tree) {
+    frame = tree->addFrame(name, parent, r_transform);
+  });
+  return frame;
+}
+
+void ConcurrentFrameTree::setTransform(const std::string& name,
+                                       const Isometry& r_transform) {
+  update([&](FrameTree* tree) { tree->setTransform(name, r_transform); });
+}
+
+void ConcurrentFrameTree::setTransform(const FrameId frame,
+                                       const Isometry& r_transform) {
+  update([&](FrameTree* tree) { tree->setTransform(frame, r_transform); });
+}
+
+std::size_t ConcurrentFrameTree::retiredCount() const {
+  std::lock_guard<std::mutex> lock{writer_mutex_};
+  return retired_.size();
+}
+
+ConcurrentFrameTree::Guard::Guard(ConcurrentFrameTree* owner,
+                                  const std::size_t slot)
+    : slot_{&owner->slots_[slot]} {
+  // Both operations are sequentially consistent: a writer that misses this
+  // announcement has already published a snapshot this reader will load.
+  slot_->epoch.store(owner->epoch_.load());
+  tree_ = owner->current_.load();
+}
+
+ConcurrentFrameTree::Guard::~Guard() {
+  slot_->epoch.store(kIdle, std::memory_order_release);
+}
+
+void ConcurrentFrameTree::releaseSlot(const std::size_t slot) {
+  slots_[slot].in_use.store(false, std::memory_order_release);
+}
+
+void ConcurrentFrameTree::reclaim() {
+  std::uint64_t oldest_active = kIdle;
+  for (std::size_t i = 0; i < max_readers_; ++i) {
+    oldest_active = std::min(oldest_active, slots_[i].epoch.load());
+  }
+  std::size_t kept = 0;
+  for (const auto& retired : retired_) {
+    if (retired.first <= oldest_active) {
+      delete retired.second;
+    } else {
+      retired_[kept++] = retired;
+    }
+  }
+  retired_.resize(kept);
+}
+
+}  // namespace math
+}  // namespace ekumen
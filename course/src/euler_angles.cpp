@@ -0,0 +1,154 @@
+/*
+ * Euler angles library
+ * Author: Steven Desvars, 2020
+ * Copyright 2020 Ekumen
+ */
+
+#include <isometry/euler_angles.hpp>
+
+#include <cmath>
+
+namespace ekumen {
+namespace math {
+
+namespace {
+
+// Below this value of cos(middle angle) (Tait-Bryan) or sin(middle angle)
+// (proper Euler) the first and third axes are considered aligned.
+const double kGimbalLockThreshold{1e-12};
+
+const int kSequenceAxes[][3] = {{0, 1, 2}, {0, 2, 1}, {1, 0, 2}, {1, 2, 0},
+                                {2, 0, 1}, {2, 1, 0}, {0, 1, 0}, {0, 2, 0},
+                                {1, 0, 1}, {1, 2, 1}, {2, 0, 2}, {2, 1, 2}};
+
+// Elementary rotation around a coordinate axis, as a row-major array.
+void axis_rotation(const int axis, const double sine, const double cosine,
+                   double* r_out) {
+  for (int i = 0; i < 9; ++i) {
+    r_out[i] = 0.;
+  }
+  const int next = (axis + 1) % 3;
+  const int prev = (axis + 2) % 3;
+  r_out[axis * 3 + axis] = 1.;
+  r_out[next * 3 + next] = cosine;
+  r_out[next * 3 + prev] = -sine;
+  r_out[prev * 3 + next] = sine;
+  r_out[prev * 3 + prev] = cosine;
+}
+
+void product(const double* lhs, const double* rhs, double* r_out) {
+  for (int i = 0; i < 3; ++i) {
+    for (int j = 0; j < 3; ++j) {
+      r_out[i * 3 + j] = lhs[i * 3] * rhs[j] + lhs[i * 3 + 1] * rhs[3 + j] +
+                         lhs[i * 3 + 2] * rhs[6 + j];
+    }
+  }
+}
+
+// Parity of the sequence: +1 when the first two axes (and the remaining one)
+// are in cyclic order.
+double parity(const int first, const int second) {
+  return (second == (first + 1) % 3) ? 1. : -1.;
+}
+
+// Angles of the intrinsic rotation Ri(a) * Rj(b) * Rk(c), see
+// Shoemake, "Euler Angle Conversion", Graphics Gems IV. At gimbal lock the
+// locked rotation goes to a, or to c if lock_in_third is set.
+Vector3 intrinsic_angles(const double* m, const int* axes,
+                         const bool lock_in_third) {
+  const int i = axes[0];
+  const int j = axes[1];
+  const double s = parity(i, j);
+  double a;
+  double b;
+  double c;
+  bool locked{false};
+  if (axes[2] != i) {
+    // Tait-Bryan.
+    const int k = axes[2];
+    const double cos_b = std::hypot(m[i * 3 + i], m[i * 3 + j]);
+    b = std::atan2(s * m[i * 3 + k], cos_b);
+    if (cos_b > kGimbalLockThreshold) {
+      a = std::atan2(-s * m[j * 3 + k], m[k * 3 + k]);
+      c = std::atan2(-s * m[i * 3 + j], m[i * 3 + i]);
+    } else {
+      a = std::atan2(s * m[k * 3 + j], m[j * 3 + j]);
+      c = 0.;
+      locked = true;
+    }
+  } else {
+    // Proper Euler, with k the remaining axis.
+    const int k = 3 - i - j;
+    const double sin_b = std::hypot(m[i * 3 + j], m[i * 3 + k]);
+    b = std::atan2(sin_b, m[i * 3 + i]);
+    if (sin_b > kGimbalLockThreshold) {
+      a = std::atan2(m[j * 3 + i], -s * m[k * 3 + i]);
+      c = std::atan2(m[i * 3 + j], s * m[i * 3 + k]);
+    } else {
+      a = std::atan2(s * m[k * 3 + j], m[j * 3 + j]);
+      c = 0.;
+      locked = true;
+    }
+  }
+  if (locked && lock_in_third) {
+    // Ri(a) * Rj(b) equals Rj(b) * Rk(+-a): conjugated by Rj(b), the axis i
+    // maps to the axis k, with the sign of row i, column k of Rj(b).
+    double middle[9];
+    axis_rotation(j, std::sin(b), std::cos(b), middle);
+    c = middle[i * 3 + axes[2]] > 0. ? a : -a;
+    a = 0.;
+  }
+  return Vector3(a, b, c);
+}
+
+}  // namespace
+
+Matrix3 eulerRotation(const double* sines, const double* cosines,
+                      const EulerSequence sequence, const EulerFrame frame) {
+  const int* axes = kSequenceAxes[static_cast<int>(sequence)];
+  double first[9];
+  double second[9];
+  double third[9];
+  axis_rotation(axes[0], sines[0], cosines[0], first);
+  axis_rotation(axes[1], sines[1], cosines[1], second);
+  axis_rotation(axes[2], sines[2], cosines[2], third);
+  double partial[9];
+  double m[9];
+  if (frame == EulerFrame::kIntrinsic) {
+    product(first, second, partial);
+    product(partial, third, m);
+  } else {
+    product(third, second, partial);
+    product(partial, first, m);
+  }
+  return Matrix3{m[0], m[1], m[2], m[3], m[4], m[5], m[6], m[7], m[8]};
+}
+
+Vector3 eulerAngles(const Matrix3& r_matrix, const EulerSequence sequence,
+                    const EulerFrame frame) {
+  const Vector3 rows[] = {r_matrix[0], r_matrix[1], r_matrix[2]};
+  const double m[] = {rows[0].x(), rows[0].y(), rows[0].z(),
+                      rows[1].x(), rows[1].y(), rows[1].z(),
+                      rows[2].x(), rows[2].y(), rows[2].z()};
+  const int* axes = kSequenceAxes[static_cast<int>(sequence)];
+  if (frame == EulerFrame::kIntrinsic) {
+    return intrinsic_angles(m, axes, false);
+  }
+  // Extrinsic i, j, k with angles a, b, c is intrinsic k, j, i with c, b, a,
+  // whose third angle is the first extrinsic one.
+  const int reversed[] = {axes[2], axes[1], axes[0]};
+  const Vector3 angles{intrinsic_angles(m, reversed, true)};
+  return Vector3(angles.z(), angles.y(), angles.x());
+}
+
+Vector3 eulerAxis(const EulerSequence sequence, const int i) {
+  if ((i < 0) || (i > 2)) {
+    throw std::out_of_range("Operator out of range");
+  }
+  Vector3 aux;
+  aux[kSequenceAxes[static_cast<int>(sequence)][i]] = 1.;
+  return aux;
+}
+
+}  // namespace math
+}  // namespace ekumen
@@ -0,0 +1,97 @@
+/*
+ * File input and output
+ * Author: Steven Desvars, 2020
+ * Copyright 2020 Ekumen
+ */
+
+#include <isometry/internal/file_io.hpp>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+
+namespace ekumen {
+namespace math {
+namespace internal {
+
+std::system_error systemError(const std::string& r_what) {
+  return std::system_error(errno, std::generic_category(), r_what);
+}
+
+void writeAll(const int fd, const void* bytes, const std::size_t size,
+              const std::string& r_what) {
+  const unsigned char* data = static_cast<const unsigned char*>(bytes);
+  std::size_t done{0};
+  while (done < size) {
+    const ssize_t result = ::write(fd, data + done, size - done);
+    if (result < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw systemError(r_what);
+    }
+    done += static_cast<std::size_t>(result);
+  }
+}
+
+void writeAllAt(const int fd, const void* bytes, const std::size_t size,
+                const std::size_t offset, const std::string& r_what) {
+  const unsigned char* data = static_cast<const unsigned char*>(bytes);
+  std::size_t done{0};
+  while (done < size) {
+    const ssize_t result = ::pwrite(fd, data + done, size - done,
+                                    static_cast<off_t>(offset + done));
+    if (result < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw systemError(r_what);
+    }
+    done += static_cast<std::size_t>(result);
+  }
+}
+
+FileMapping::FileMapping(const std::string& r_path)
+    : data_{nullptr}, size_{0} {
+  const int fd = ::open(r_path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    throw systemError("Cannot open " + r_path);
+  }
+  struct stat status;
+  if (::fstat(fd, &status) != 0) {
+    const std::system_error error{systemError("Cannot stat " + r_path)};
+    ::close(fd);
+    throw error;
+  }
+  const std::size_t size = static_cast<std::size_t>(status.st_size);
+  if (size > 0) {
+    void* memory = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    if (memory == MAP_FAILED) {
+      const std::system_error error{systemError("Cannot map " + r_path)};
+      ::close(fd);
+      throw error;
+    }
+    data_ = static_cast<const unsigned char*>(memory);
+    size_ = size;
+  }
+  ::close(fd);
+}
+
+FileMapping::~FileMapping() {
+  if (data_ != nullptr) {
+    ::munmap(const_cast<unsigned char*>(data_), size_);
+  }
+}
+
+void FileMapping::adviseSequential() const {
+  if (data_ != nullptr) {
+    ::madvise(const_cast<unsigned char*>(data_), size_, MADV_SEQUENTIAL);
+  }
+}
+
+}  // namespace internal
+}  // namespace math
+}  // namespace ekumen
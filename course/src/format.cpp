@@ -0,0 +1,230 @@
+/*
+ * Text formatting library
+ * Author: Steven Desvars, 2020
+ * Copyright 2020 Ekumen
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <isometry/format.hpp>
+#include <isometry/internal/format_double.hpp>
+#include <isometry/internal/parse_double.hpp>
+#include <stdexcept>
+
+namespace ekumen {
+namespace math {
+
+namespace {
+
+// Longest text of a double, e.g. -1.2345678901234567e-308.
+const std::size_t kNumberSize{32};
+
+// Appends text to a caller buffer, keeping it null terminated.
+class Writer {
+ public:
+  Writer(char* buffer, const std::size_t size)
+      : buffer_{buffer}, size_{size}, length_{0} {
+    if (size_ == 0) {
+      throw std::length_error("Empty format buffer");
+    }
+    buffer_[0] = '\0';
+  }
+
+  void append(const char* text, const std::size_t length) {
+    if (length_ + length >= size_) {
+      throw std::length_error("Format buffer too small");
+    }
+    std::memcpy(buffer_ + length_, text, length);
+    length_ += length;
+    buffer_[length_] = '\0';
+  }
+
+  void append(const char* text) { append(text, std::strlen(text)); }
+
+  void append(const double value, const int precision) {
+    char number[kNumberSize];
+    append(number, std::snprintf(number, kNumberSize, "%.*g", precision,
+                                 value));
+  }
+
+  void appendRoundTrip(const double value) {
+    char number[internal::kShortestDoubleSize];
+    append(number, internal::formatShortest(value, number));
+  }
+
+  std::size_t length() const { return length_; }
+
+ private:
+  char* buffer_;
+  std::size_t size_;
+  std::size_t length_;
+};
+
+// Precisions of operator<<, the stream default for vectors and the one
+// set for matrices.
+const int kVectorPrecision{6};
+const int kMatrixPrecision{9};
+
+void appendNumber(const double value, const int precision,
+                  const FormatMode mode, Writer* r_writer) {
+  if (mode == FormatMode::kRoundTrip) {
+    r_writer->appendRoundTrip(value);
+  } else {
+    r_writer->append(value, precision);
+  }
+}
+
+void appendVector(const Vector3& r_vector, const FormatMode mode,
+                  Writer* r_writer) {
+  r_writer->append("(x: ");
+  appendNumber(r_vector.x(), kVectorPrecision, mode, r_writer);
+  r_writer->append(", y: ");
+  appendNumber(r_vector.y(), kVectorPrecision, mode, r_writer);
+  r_writer->append(", z: ");
+  appendNumber(r_vector.z(), kVectorPrecision, mode, r_writer);
+  r_writer->append(")");
+}
+
+void appendMatrix(const Matrix3& r_matrix, const FormatMode mode,
+                  Writer* r_writer) {
+  r_writer->append("[");
+  for (int i = 0; i < 3; ++i) {
+    const Vector3 row{r_matrix.row(i)};
+    r_writer->append(i == 0 ? "[" : ", [");
+    appendNumber(row.x(), kMatrixPrecision, mode, r_writer);
+    r_writer->append(", ");
+    appendNumber(row.y(), kMatrixPrecision, mode, r_writer);
+    r_writer->append(", ");
+    appendNumber(row.z(), kMatrixPrecision, mode, r_writer);
+    r_writer->append("]");
+  }
+  r_writer->append("]");
+}
+
+// Reads tokens from a text that needs not be null terminated.
+class Reader {
+ public:
+  Reader(const char* text, const std::size_t size)
+      : begin_{text}, it_{text}, end_{text + size} {}
+
+  // Consumes the characters of a token, each one optionally preceded by
+  // spaces.
+  void expect(const char* token) {
+    for (; *token != '\0'; ++token) {
+      skipSpaces();
+      if (it_ == end_ || *it_ != *token) {
+        throw std::invalid_argument("Malformed text, expected '" +
+                                    std::string(1, *token) + "'");
+      }
+      ++it_;
+    }
+  }
+
+  double number() {
+    skipSpaces();
+    double value;
+    const char* next = internal::parseDouble(it_, end_, &value);
+    if (next == nullptr) {
+      throw std::invalid_argument("Malformed text, expected a number");
+    }
+    it_ = next;
+    return value;
+  }
+
+  std::size_t consumed() const { return it_ - begin_; }
+
+ private:
+  void skipSpaces() {
+    while (it_ != end_ && (*it_ == ' ' || *it_ == '\t' || *it_ == '\n')) {
+      ++it_;
+    }
+  }
+
+  const char* begin_;
+  const char* it_;
+  const char* end_;
+};
+
+Vector3 readVector(Reader* r_reader) {
+  r_reader->expect("(x:");
+  const double x = r_reader->number();
+  r_reader->expect(",y:");
+  const double y = r_reader->number();
+  r_reader->expect(",z:");
+  const double z = r_reader->number();
+  r_reader->expect(")");
+  return Vector3(x, y, z);
+}
+
+Matrix3 readMatrix(Reader* r_reader) {
+  double values[9];
+  r_reader->expect("[");
+  for (int i = 0; i < 3; ++i) {
+    r_reader->expect(i == 0 ? "[" : ",[");
+    for (int j = 0; j < 3; ++j) {
+      if (j > 0) {
+        r_reader->expect(",");
+      }
+      values[3 * i + j] = r_reader->number();
+    }
+    r_reader->expect("]");
+  }
+  r_reader->expect("]");
+  return Matrix3{Vector3(values[0], values[1], values[2]),
+                 Vector3(values[3], values[4], values[5]),
+                 Vector3(values[6], values[7], values[8])};
+}
+
+}  // namespace
+
+std::size_t format(const Vector3& r_vector, char* buffer,
+                   const std::size_t size, const FormatMode mode) {
+  Writer writer{buffer, size};
+  appendVector(r_vector, mode, &writer);
+  return writer.length();
+}
+
+std::size_t format(const Matrix3& r_matrix, char* buffer,
+                   const std::size_t size, const FormatMode mode) {
+  Writer writer{buffer, size};
+  appendMatrix(r_matrix, mode, &writer);
+  return writer.length();
+}
+
+std::size_t format(const Isometry& r_isometry, char* buffer,
+                   const std::size_t size, const FormatMode mode) {
+  Writer writer{buffer, size};
+  writer.append("[T: ");
+  appendVector(r_isometry.translation(), mode, &writer);
+  writer.append(", R:");
+  appendMatrix(r_isometry.rotation(), mode, &writer);
+  writer.append("]");
+  return writer.length();
+}
+
+std::size_t parse(const char* text, const std::size_t size, Vector3* r_out) {
+  Reader reader{text, size};
+  *r_out = readVector(&reader);
+  return reader.consumed();
+}
+
+std::size_t parse(const char* text, const std::size_t size, Matrix3* r_out) {
+  Reader reader{text, size};
+  *r_out = readMatrix(&reader);
+  return reader.consumed();
+}
+
+std::size_t parse(const char* text, const std::size_t size,
+                  Isometry* r_out) {
+  Reader reader{text, size};
+  reader.expect("[T:");
+  const Vector3 translation{readVector(&reader)};
+  reader.expect(",R:");
+  const Matrix3 rotation{readMatrix(&reader)};
+  reader.expect("]");
+  *r_out = Isometry{translation, rotation};
+  return reader.consumed();
+}
+
+}  // namespace math
+}  // namespace ekumen
@@ -0,0 +1,323 @@
+/*
+ * Number formatting library
+ * Author: Steven Desvars, 2020
+ * Copyright 2020 Ekumen
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <isometry/internal/format_double.hpp>
+
+namespace ekumen {
+namespace math {
+namespace internal {
+
+namespace {
+
+const std::uint64_t kHiddenBit{std::uint64_t{1} << 52};
+const std::uint64_t kSignificandMask{kHiddenBit - 1};
+const int kExponentBias{1075};
+
+// Normalized 64-bit significands and binary exponents of 10^k, for
+// k = -348, -340, ..., 340.
+const std::uint64_t kCachedPowersF[]{
+    0xfa8fd5a0081c0288, 0xbaaee17fa23ebf76, 0x8b16fb203055ac76,
+    0xcf42894a5dce35ea, 0x9a6bb0aa55653b2d, 0xe61acf033d1a45df,
+    0xab70fe17c79ac6ca, 0xff77b1fcbebcdc4f, 0xbe5691ef416bd60c,
+    0x8dd01fad907ffc3c, 0xd3515c2831559a83, 0x9d71ac8fada6c9b5,
+    0xea9c227723ee8bcb, 0xaecc49914078536d, 0x823c12795db6ce57,
+    0xc21094364dfb5637, 0x9096ea6f3848984f, 0xd77485cb25823ac7,
+    0xa086cfcd97bf97f4, 0xef340a98172aace5, 0xb23867fb2a35b28e,
+    0x84c8d4dfd2c63f3b, 0xc5dd44271ad3cdba, 0x936b9fcebb25c996,
+    0xdbac6c247d62a584, 0xa3ab66580d5fdaf6, 0xf3e2f893dec3f126,
+    0xb5b5ada8aaff80b8, 0x87625f056c7c4a8b, 0xc9bcff6034c13053,
+    0x964e858c91ba2655, 0xdff9772470297ebd, 0xa6dfbd9fb8e5b88f,
+    0xf8a95fcf88747d94, 0xb94470938fa89bcf, 0x8a08f0f8bf0f156b,
+    0xcdb02555653131b6, 0x993fe2c6d07b7fac, 0xe45c10c42a2b3b06,
+    0xaa242499697392d3, 0xfd87b5f28300ca0e, 0xbce5086492111aeb,
+    0x8cbccc096f5088cc, 0xd1b71758e219652c, 0x9c40000000000000,
+    0xe8d4a51000000000, 0xad78ebc5ac620000, 0x813f3978f8940984,
+    0xc097ce7bc90715b3, 0x8f7e32ce7bea5c70, 0xd5d238a4abe98068,
+    0x9f4f2726179a2245, 0xed63a231d4c4fb27, 0xb0de65388cc8ada8,
+    0x83c7088e1aab65db, 0xc45d1df942711d9a, 0x924d692ca61be758,
+    0xda01ee641a708dea, 0xa26da3999aef774a, 0xf209787bb47d6b85,
+    0xb454e4a179dd1877, 0x865b86925b9bc5c2, 0xc83553c5c8965d3d,
+    0x952ab45cfa97a0b3, 0xde469fbd99a05fe3, 0xa59bc234db398c25,
+    0xf6c69a72a3989f5c, 0xb7dcbf5354e9bece, 0x88fcf317f22241e2,
+    0xcc20ce9bd35c78a5, 0x98165af37b2153df, 0xe2a0b5dc971f303a,
+    0xa8d9d1535ce3b396, 0xfb9b7cd9a4a7443c, 0xbb764c4ca7a44410,
+    0x8bab8eefb6409c1a, 0xd01fef10a657842c, 0x9b10a4e5e9913129,
+    0xe7109bfba19c0c9d, 0xac2820d9623bf429, 0x80444b5e7aa7cf85,
+    0xbf21e44003acdd2d, 0x8e679c2f5e44ff8f, 0xd433179d9c8cb841,
+    0x9e19db92b4e31ba9, 0xeb96bf6ebadf77d9, 0xaf87023b9bf0ee6b};
+const std::int16_t kCachedPowersE[]{
+    -1220, -1193, -1166, -1140, -1113, -1087, -1060, -1034, -1007, -980,
+    -954, -927, -901, -874, -847, -821, -794, -768, -741, -715,
+    -688, -661, -635, -608, -582, -555, -529, -502, -475, -449,
+    -422, -396, -369, -343, -316, -289, -263, -236, -210, -183,
+    -157, -130, -103, -77, -50, -24, 3, 30, 56, 83,
+    109, 136, 162, 189, 216, 242, 269, 295, 322, 348,
+    375, 402, 428, 455, 481, 508, 534, 561, 588, 614,
+    641, 667, 694, 720, 747, 774, 800, 827, 853, 880,
+    907, 933, 960, 986, 1013, 1039, 1066};
+
+const std::uint64_t kPowersOfTen[]{1ull,
+                                   10ull,
+                                   100ull,
+                                   1000ull,
+                                   10000ull,
+                                   100000ull,
+                                   1000000ull,
+                                   10000000ull,
+                                   100000000ull,
+                                   1000000000ull,
+                                   10000000000ull,
+                                   100000000000ull,
+                                   1000000000000ull,
+                                   10000000000000ull,
+                                   100000000000000ull,
+                                   1000000000000000ull,
+                                   10000000000000000ull,
+                                   100000000000000000ull,
+                                   1000000000000000000ull,
+                                   10000000000000000000ull};
+
+// Floating point number with a 64-bit significand, f * 2^e.
+struct DiyFp {
+  std::uint64_t f;
+  int e;
+
+  DiyFp operator-(const DiyFp& r_other) const {
+    return DiyFp{f - r_other.f, e};
+  }
+
+  // Product rounded to the upper 64 bits.
+  DiyFp operator*(const DiyFp& r_other) const {
+    const std::uint64_t kMask32{0xffffffff};
+    const std::uint64_t a = f >> 32;
+    const std::uint64_t b = f & kMask32;
+    const std::uint64_t c = r_other.f >> 32;
+    const std::uint64_t d = r_other.f & kMask32;
+    const std::uint64_t ac = a * c;
+    const std::uint64_t bc = b * c;
+    const std::uint64_t ad = a * d;
+    const std::uint64_t bd = b * d;
+    const std::uint64_t middle =
+        (bd >> 32) + (ad & kMask32) + (bc & kMask32) + (std::uint64_t{1} << 31);
+    return DiyFp{ac + (ad >> 32) + (bc >> 32) + (middle >> 32),
+                 e + r_other.e + 64};
+  }
+};
+
+DiyFp normalize(DiyFp value) {
+  while ((value.f & (std::uint64_t{1} << 63)) == 0) {
+    value.f <<= 1;
+    --value.e;
+  }
+  return value;
+}
+
+// Decomposes a finite positive double.
+DiyFp decompose(const double value) {
+  std::uint64_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  const int biased = static_cast<int>((bits >> 52) & 0x7ff);
+  const std::uint64_t significand = bits & kSignificandMask;
+  return biased == 0 ? DiyFp{significand, 1 - kExponentBias}
+                     : DiyFp{significand + kHiddenBit, biased - kExponentBias};
+}
+
+// Boundaries halfway to the neighboring doubles, with the same exponent.
+void boundaries(const DiyFp& r_value, DiyFp* r_minus, DiyFp* r_plus) {
+  *r_plus = normalize(DiyFp{(r_value.f << 1) + 1, r_value.e - 1});
+  // The gap below a power of two is half the gap above.
+  *r_minus = r_value.f == kHiddenBit
+                 ? DiyFp{(r_value.f << 2) - 1, r_value.e - 2}
+                 : DiyFp{(r_value.f << 1) - 1, r_value.e - 1};
+  r_minus->f <<= r_minus->e - r_plus->e;
+  r_minus->e = r_plus->e;
+}
+
+// Cached power c = 10^-k such that the exponent of a normalized number of
+// binary exponent e times c falls in [-60, -32].
+DiyFp cachedPower(const int e, int* r_k) {
+  const double estimate = (-61 - e) * 0.30102999566398114 + 347;
+  int k = static_cast<int>(estimate);
+  if (estimate - k > 0.) {
+    ++k;
+  }
+  const int index = (k >> 3) + 1;
+  *r_k = -(-348 + index * 8);
+  return DiyFp{kCachedPowersF[index], kCachedPowersE[index]};
+}
+
+// Moves the last digit down while the result gets closer to the exact
+// value and stays within the rounding interval.
+void round(char* buffer, const int length, const std::uint64_t delta,
+           std::uint64_t rest, const std::uint64_t ten_kappa,
+           const std::uint64_t distance) {
+  while (rest < distance && delta - rest >= ten_kappa &&
+         (rest + ten_kappa < distance ||
+          distance - rest > rest + ten_kappa - distance)) {
+    --buffer[length - 1];
+    rest += ten_kappa;
+  }
+}
+
+int countDigits(const std::uint32_t value) {
+  int digits = 1;
+  while (digits < 10 && value >= kPowersOfTen[digits]) {
+    ++digits;
+  }
+  return digits;
+}
+
+// Generates the shortest digits of a number within (upper - delta, upper],
+// value * 10^k being the result.
+int generateDigits(const DiyFp& r_value, const DiyFp& r_upper,
+                   std::uint64_t delta, char* buffer, int* r_k) {
+  const DiyFp one{std::uint64_t{1} << -r_upper.e, r_upper.e};
+  const std::uint64_t distance = (r_upper - r_value).f;
+  std::uint32_t integral = static_cast<std::uint32_t>(r_upper.f >> -one.e);
+  std::uint64_t fractional = r_upper.f & (one.f - 1);
+  int kappa = countDigits(integral);
+  int length = 0;
+  while (kappa > 0) {
+    const std::uint32_t power = static_cast<std::uint32_t>(
+        kPowersOfTen[kappa - 1]);
+    const std::uint32_t digit = integral / power;
+    integral %= power;
+    if (digit != 0 || length != 0) {
+      buffer[length++] = static_cast<char>('0' + digit);
+    }
+    --kappa;
+    const std::uint64_t rest =
+        (static_cast<std::uint64_t>(integral) << -one.e) + fractional;
+    if (rest <= delta) {
+      *r_k += kappa;
+      round(buffer, length, delta, rest, kPowersOfTen[kappa] << -one.e,
+            distance);
+      return length;
+    }
+  }
+  for (;;) {
+    fractional *= 10;
+    delta *= 10;
+    const char digit = static_cast<char>(fractional >> -one.e);
+    if (digit != 0 || length != 0) {
+      buffer[length++] = static_cast<char>('0' + digit);
+    }
+    fractional &= one.f - 1;
+    --kappa;
+    if (fractional < delta) {
+      *r_k += kappa;
+      round(buffer, length, delta, fractional, one.f,
+            distance * (-kappa < 20 ? kPowersOfTen[-kappa] : 0));
+      return length;
+    }
+  }
+}
+
+// Shortest digits of a finite positive double, value = digits * 10^k.
+int grisu2(const double value, char* digits, int* r_k) {
+  const DiyFp v{decompose(value)};
+  DiyFp minus;
+  DiyFp plus;
+  boundaries(v, &minus, &plus);
+  const DiyFp power{cachedPower(plus.e, r_k)};
+  const DiyFp scaled{normalize(v) * power};
+  DiyFp upper{plus * power};
+  DiyFp lower{minus * power};
+  // Stay strictly inside the interval, the products may be off by one.
+  ++lower.f;
+  --upper.f;
+  return generateDigits(scaled, upper, upper.f - lower.f, digits, r_k);
+}
+
+char* writeExponent(int exponent, char* out) {
+  *out++ = 'e';
+  *out++ = exponent < 0 ? '-' : '+';
+  exponent = exponent < 0 ? -exponent : exponent;
+  if (exponent >= 100) {
+    *out++ = static_cast<char>('0' + exponent / 100);
+    exponent %= 100;
+  }
+  *out++ = static_cast<char>('0' + exponent / 10);
+  *out++ = static_cast<char>('0' + exponent % 10);
+  return out;
+}
+
+}  // namespace
+
+std::size_t formatShortest(const double value, char* buffer) {
+  char* out = buffer;
+  if (std::isnan(value)) {
+    std::memcpy(out, "nan", 4);
+    return 3;
+  }
+  if (std::signbit(value)) {
+    *out++ = '-';
+  }
+  if (std::isinf(value)) {
+    std::memcpy(out, "inf", 4);
+    return out + 3 - buffer;
+  }
+  if (value == 0.) {
+    std::memcpy(out, "0", 2);
+    return out + 1 - buffer;
+  }
+  char digits[20];
+  int k;
+  const int length = grisu2(std::fabs(value), digits, &k);
+  // Exponent of the first digit in scientific notation.
+  const int exponent = length + k - 1;
+  const int exponent_length = std::abs(exponent) >= 100 ? 5 : 4;
+  const int scientific_length = length + (length > 1 ? 1 : 0) + exponent_length;
+  const int fixed_length = exponent >= 0
+                               ? std::max(length, exponent + 1) +
+                                     (length > exponent + 1 ? 1 : 0)
+                               : length + 1 - exponent;
+  if (fixed_length <= scientific_length) {
+    if (exponent < 0) {
+      // 0.000ddd
+      *out++ = '0';
+      *out++ = '.';
+      for (int i = exponent + 1; i < 0; ++i) {
+        *out++ = '0';
+      }
+      std::memcpy(out, digits, length);
+      out += length;
+    } else if (length <= exponent + 1) {
+      // ddd000
+      std::memcpy(out, digits, length);
+      out += length;
+      for (int i = length; i <= exponent; ++i) {
+        *out++ = '0';
+      }
+    } else {
+      // dd.ddd
+      std::memcpy(out, digits, exponent + 1);
+      out += exponent + 1;
+      *out++ = '.';
+      std::memcpy(out, digits + exponent + 1, length - exponent - 1);
+      out += length - exponent - 1;
+    }
+  } else {
+    *out++ = digits[0];
+    if (length > 1) {
+      *out++ = '.';
+      std::memcpy(out, digits + 1, length - 1);
+      out += length - 1;
+    }
+    out = writeExponent(exponent, out);
+  }
+  *out = '\0';
+  return out - buffer;
+}
+
+}  // namespace internal
+}  // namespace math
+}  // namespace ekumen
@@ -0,0 +1,174 @@
+/*
+ * Frame tree library
+ * Author: Steven Desvars, 2020
+ * Copyright 2020 Ekumen
+ */
+
+#include <algorithm>
+#include <isometry/frame_tree.hpp>
+#include <stdexcept>
+
+namespace ekumen {
+namespace math {
+
+namespace {
+
+const std::size_t kRoot{0};
+
+}  // namespace
+
+FrameTree::FrameTree(const std::string& root)
+    : names_{root},
+      parents_{kRoot},
+      transforms_{Isometry()},
+      world_poses_{Isometry()},
+      dirty_{0},
+      stale_{false} {
+  indices_.emplace(root, FrameId(kRoot));
+}
+
+FrameId FrameTree::addFrame(const std::string& name, const std::string& parent,
+                            const Isometry& r_transform) {
+  return addFrame(name, id(parent), r_transform);
+}
+
+FrameId FrameTree::addFrame(const std::string& name, const FrameId parent,
+                            const Isometry& r_transform) {
+  check(parent);
+  if (hasFrame(name)) {
+    throw std::invalid_argument("Frame already exists: " + name);
+  }
+  // Appending keeps the arrays in topological order. If an ancestor is
+  // dirty, the next update recomputes this pose as part of its subtree.
+  const FrameId frame{names_.size()};
+  indices_.emplace(name, frame);
+  names_.push_back(name);
+  parents_.push_back(parent.index());
+  transforms_.push_back(r_transform);
+  world_poses_.push_back(world_poses_[parent.index()] * r_transform);
+  dirty_.push_back(0);
+  return frame;
+}
+
+void FrameTree::setTransform(const std::string& name,
+                             const Isometry& r_transform) {
+  setTransform(id(name), r_transform);
+}
+
+void FrameTree::setTransform(const FrameId frame,
+                             const Isometry& r_transform) {
+  check(frame);
+  if (frame == root()) {
+    throw std::invalid_argument("The root frame has no parent");
+  }
+  transforms_[frame.index()] = r_transform;
+  dirty_[frame.index()] = 1;
+  stale_ = true;
+}
+
+FrameTree::UpdateStats FrameTree::updateWorldPoses() {
+  UpdateStats stats{0, 0};
+  if (!stale_) {
+    stats.saved = size() - 1;
+    return stats;
+  }
+  // Parents come first, so a frame sees its parent's flag already
+  // propagated from any dirty ancestor.
+  for (std::size_t i = 1; i < size(); ++i) {
+    dirty_[i] |= dirty_[parents_[i]];
+    if (dirty_[i]) {
+      world_poses_[i] = world_poses_[parents_[i]] * transforms_[i];
+      ++stats.recomputed;
+    }
+  }
+  std::fill(dirty_.begin(), dirty_.end(), 0);
+  stale_ = false;
+  stats.saved = size() - 1 - stats.recomputed;
+  return stats;
+}
+
+bool FrameTree::hasFrame(const std::string& name) const {
+  return indices_.find(name) != indices_.end();
+}
+
+FrameId FrameTree::id(const std::string& name) const {
+  const auto it = indices_.find(name);
+  if (it == indices_.end()) {
+    throw std::invalid_argument("Unknown frame: " + name);
+  }
+  return it->second;
+}
+
+const std::string& FrameTree::name(const FrameId frame) const {
+  check(frame);
+  return names_[frame.index()];
+}
+
+const std::string& FrameTree::parent(const std::string& name) const {
+  return names_[parent(id(name)).index()];
+}
+
+FrameId FrameTree::parent(const FrameId frame) const {
+  check(frame);
+  if (frame == root()) {
+    throw std::invalid_argument("The root frame has no parent");
+  }
+  return FrameId(parents_[frame.index()]);
+}
+
+Isometry FrameTree::transform(const std::string& name) const {
+  return transforms_[id(name).index()];
+}
+
+Isometry FrameTree::transform(const FrameId frame) const {
+  check(frame);
+  return transforms_[frame.index()];
+}
+
+Isometry FrameTree::lookup(const std::string& target,
+                           const std::string& source) const {
+  return lookup(id(target), id(source));
+}
+
+Isometry FrameTree::lookup(const FrameId target, const FrameId source) const {
+  check(target);
+  check(source);
+  return worldPose(target.index()).inverse() * worldPose(source.index());
+}
+
+Isometry FrameTree::worldPose(const std::size_t frame) const {
+  if (!stale_) {
+    return world_poses_[frame];
+  }
+  // The cached pose is valid unless the frame or an ancestor is dirty. If
+  // one is, the path below the topmost dirty one is composed on the pose of
+  // its parent, which is valid.
+  std::size_t topmost{kRoot};
+  for (std::size_t i = frame; i != kRoot; i = parents_[i]) {
+    if (dirty_[i]) {
+      topmost = i;
+    }
+  }
+  if (topmost == kRoot) {
+    return world_poses_[frame];
+  }
+  Isometry path{transforms_[frame]};
+  for (std::size_t i = frame; i != topmost;) {
+    i = parents_[i];
+    path = transforms_[i] * path;
+  }
+  return world_poses_[parents_[topmost]] * path;
+}
+
+std::ostream& operator<<(std::ostream& r_os, const FrameId& r_frame) {
+  return r_os << "FrameId(" << r_frame.index() << ")";
+}
+
+void FrameTree::check(const FrameId frame) const {
+  if (frame.index() >= names_.size()) {
+    throw std::out_of_range("Unknown frame handle");
+  }
+}
+
+}  // namespace math
+}  // namespace ekumen
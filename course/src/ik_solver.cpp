@@ -0,0 +1,177 @@
+/*
+ * Inverse kinematics library
+ * Author: Steven Desvars, 2020
+ * Copyright 2020 Ekumen
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <isometry/ik_solver.hpp>
+#include <limits>
+#include <stdexcept>
+
+namespace ekumen {
+namespace math {
+
+namespace {
+
+const int kTaskSize{6};
+
+// Solves A x = b in place for a symmetric positive definite 6x6 A, stored
+// row-major. A is overwritten by its Cholesky factor and b by x.
+void choleskySolve(double* r_a, double* r_b) {
+  for (int j = 0; j < kTaskSize; ++j) {
+    double diagonal = r_a[j * kTaskSize + j];
+    for (int k = 0; k < j; ++k) {
+      diagonal -= r_a[j * kTaskSize + k] * r_a[j * kTaskSize + k];
+    }
+    diagonal = std::sqrt(diagonal);
+    r_a[j * kTaskSize + j] = diagonal;
+    for (int i = j + 1; i < kTaskSize; ++i) {
+      double aux = r_a[i * kTaskSize + j];
+      for (int k = 0; k < j; ++k) {
+        aux -= r_a[i * kTaskSize + k] * r_a[j * kTaskSize + k];
+      }
+      r_a[i * kTaskSize + j] = aux / diagonal;
+    }
+  }
+  for (int i = 0; i < kTaskSize; ++i) {
+    for (int k = 0; k < i; ++k) {
+      r_b[i] -= r_a[i * kTaskSize + k] * r_b[k];
+    }
+    r_b[i] /= r_a[i * kTaskSize + i];
+  }
+  for (int i = kTaskSize - 1; i >= 0; --i) {
+    for (int k = i + 1; k < kTaskSize; ++k) {
+      r_b[i] -= r_a[k * kTaskSize + i] * r_b[k];
+    }
+    r_b[i] /= r_a[i * kTaskSize + i];
+  }
+}
+
+}  // namespace
+
+IkSolver::IkSolver(const KinematicChain& r_chain, const IkOptions& r_options)
+    : chain_{r_chain},
+      options_{r_options},
+      lower_(r_chain.dof(), -std::numeric_limits<double>::infinity()),
+      upper_(r_chain.dof(), std::numeric_limits<double>::infinity()),
+      poses_(r_chain.dof()),
+      jacobian_(kTaskSize * r_chain.dof()),
+      step_(r_chain.dof()) {
+  if (chain_.dof() == 0) {
+    throw std::invalid_argument("The chain has no joints");
+  }
+  if (!(options_.damping > 0.) || !(options_.max_step > 0.) ||
+      !(options_.position_tolerance > 0.) ||
+      !(options_.orientation_tolerance > 0.)) {
+    throw std::invalid_argument("The solver options must be positive");
+  }
+}
+
+void IkSolver::setJointLimits(const double* lower, const double* upper) {
+  for (std::size_t i = 0; i < chain_.dof(); ++i) {
+    if (lower[i] > upper[i]) {
+      throw std::invalid_argument("Lower joint limit above the upper one");
+    }
+  }
+  std::copy(lower, lower + chain_.dof(), lower_.begin());
+  std::copy(upper, upper + chain_.dof(), upper_.begin());
+}
+
+IkResult IkSolver::solve(const Isometry& r_target, double* r_q) {
+  const std::size_t dof = chain_.dof();
+  const double damping = options_.damping * options_.damping;
+  clamp(r_q);
+  IkResult result{false, 0, 0., 0.};
+  double error[kTaskSize];
+  double system[kTaskSize * kTaskSize];
+  for (;; ++result.iterations) {
+    chain_.forwardKinematics(r_q, poses_.data());
+    computeError(r_target, error);
+    result.position_error =
+        std::sqrt(error[0] * error[0] + error[1] * error[1] +
+                  error[2] * error[2]);
+    result.orientation_error =
+        std::sqrt(error[3] * error[3] + error[4] * error[4] +
+                  error[5] * error[5]);
+    if (result.position_error <= options_.position_tolerance &&
+        result.orientation_error <= options_.orientation_tolerance) {
+      result.converged = true;
+      return result;
+    }
+    if (result.iterations == options_.max_iterations) {
+      return result;
+    }
+
+    // Geometric Jacobian, a revolute joint moves the end effector by
+    // z x (p_end - p_joint) and rotates it around z, a prismatic one
+    // translates it along z.
+    const Vector3 end{(poses_[dof - 1] * chain_.tip()).translation()};
+    for (std::size_t j = 0; j < dof; ++j) {
+      const Vector3 z{poses_[j].rotation() * chain_.axis(j)};
+      Vector3 linear{z};
+      Vector3 angular;
+      if (chain_.type(j) == JointType::kRevolute) {
+        linear = z.cross(end - poses_[j].translation());
+        angular = z;
+      }
+      for (int i = 0; i < 3; ++i) {
+        jacobian_[i * dof + j] = linear[i];
+        jacobian_[(i + 3) * dof + j] = angular[i];
+      }
+    }
+
+    // (J J^T + lambda^2 I) y = e, then dq = J^T y.
+    for (int i = 0; i < kTaskSize; ++i) {
+      for (int k = 0; k <= i; ++k) {
+        double aux{0.};
+        for (std::size_t j = 0; j < dof; ++j) {
+          aux += jacobian_[i * dof + j] * jacobian_[k * dof + j];
+        }
+        system[i * kTaskSize + k] = aux;
+        system[k * kTaskSize + i] = aux;
+      }
+      system[i * kTaskSize + i] += damping;
+    }
+    choleskySolve(system, error);
+    double largest{0.};
+    for (std::size_t j = 0; j < dof; ++j) {
+      double aux{0.};
+      for (int i = 0; i < kTaskSize; ++i) {
+        aux += jacobian_[i * dof + j] * error[i];
+      }
+      step_[j] = aux;
+      largest = std::max(largest, std::abs(aux));
+    }
+    // Long steps are scaled down as a whole, keeping their direction.
+    const double scale =
+        largest > options_.max_step ? options_.max_step / largest : 1.;
+    for (std::size_t j = 0; j < dof; ++j) {
+      r_q[j] += scale * step_[j];
+    }
+    clamp(r_q);
+  }
+}
+
+void IkSolver::computeError(const Isometry& r_target,
+                            double* r_error) const {
+  const Isometry end{poses_[chain_.dof() - 1] * chain_.tip()};
+  const Vector3 position{r_target.translation() - end.translation()};
+  // Rotation taking the end effector orientation to the target one,
+  // expressed in the base frame.
+  const Vector3 orientation{(r_target * end.inverse()).toRotationVector()};
+  for (int i = 0; i < 3; ++i) {
+    r_error[i] = position[i];
+    r_error[3 + i] = orientation[i];
+  }
+}
+
+void IkSolver::clamp(double* r_q) const {
+  for (std::size_t j = 0; j < chain_.dof(); ++j) {
+    r_q[j] = std::min(std::max(r_q[j], lower_[j]), upper_[j]);
+  }
+}
+
+}  // namespace math
+}  // namespace ekumen
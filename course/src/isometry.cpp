@@ -18,22 +18,75 @@ Vector3 translation_vector_operation(const Matrix3& matrix,
   return matrix * first_vector + second_vector;
 }
 
+// Rodrigues' rotation formula, given the cosine and sine of the angle.
+Matrix3 axis_rotation(const Vector3& axis, const double cosine,
+                      const double sine) {
+  const double x = axis.x();
+  const double y = axis.y();
+  const double z = axis.z();
+  const double one_minus_cos = 1 - cosine;
+  return Matrix3{cosine + x * x * one_minus_cos,
+                 x * y * one_minus_cos - z * sine,
+                 x * z * one_minus_cos + y * sine,
+                 y * x * one_minus_cos + z * sine,
+                 cosine + y * y * one_minus_cos,
+                 y * z * one_minus_cos - x * sine,
+                 z * x * one_minus_cos - y * sine,
+                 z * y * one_minus_cos + x * sine,
+                 cosine + z * z * one_minus_cos};
+}
+
+// Below this sine of the angle, rotation vectors use series expansions.
+const double kSmallAngleSine{1e-10};
+// Below this sine of the angle, and with a negative cosine, the rotation
+// axis is recovered from the symmetric part of the matrix.
+const double kNearPiSine{1e-6};
+
+// Batch builders evaluate sines and cosines in fixed-size chunks on the
+// stack, so they never allocate.
+const std::size_t kBatchChunk{64};
+
 }  // namespace
 
 
 Isometry Isometry::fromTranslation(const Vector3& r_vector) {
-  return Isometry{r_vector, Matrix3::kIdentity};
-}
-
-Vector3 Isometry::translation() const {
-  return translation_vector_;
+  return Isometry{r_vector, AxisAlignedRotation()};
 }
 
 Vector3 Isometry::transform(const Vector3& r_vector) const {
   return (*this) * r_vector;
 }
 
+void Isometry::transform(const Vector3* r_points, const std::size_t count,
+                         Vector3* r_out) const {
+  double rotation[9];
+  for (int i = 0; i < 3; ++i) {
+    for (int j = 0; j < 3; ++j) {
+      rotation[3 * i + j] = rotation_matrix_[i][j];
+    }
+  }
+  const double tx = translation_vector_.x();
+  const double ty = translation_vector_.y();
+  const double tz = translation_vector_.z();
+  for (std::size_t i = 0; i < count; ++i) {
+    const double px = r_points[i].x();
+    const double py = r_points[i].y();
+    const double pz = r_points[i].z();
+    r_out[i] = Vector3(
+        rotation[0] * px + rotation[1] * py + rotation[2] * pz + tx,
+        rotation[3] * px + rotation[4] * py + rotation[5] * pz + ty,
+        rotation[6] * px + rotation[7] * py + rotation[8] * pz + tz);
+  }
+}
+
 Isometry Isometry::inverse() const {
+  if (axis_aligned_) {
+    const AxisAlignedRotation aux{permutation_.inverse()};
+    const Vector3 translation{aux * translation_vector_};
+    return Isometry{Vector3(-translation.x(), -translation.y(),
+                            -translation.z()),
+                    aux};
+  }
   const double det = rotation_matrix_.det();
   if (det == 0) {
     throw std::invalid_argument("Isometry doesn't have an inverse");
@@ -49,8 +102,8 @@ Isometry Isometry::inverse() const {
       transpose_matrix[0][2] * transpose_matrix[2][1];
   const double c_11 = transpose_matrix[0][0] * transpose_matrix[2][2] -
       transpose_matrix[0][2] * transpose_matrix[2][0];
-  const double c_12 = transpose_matrix[0][0] * transpose_matrix[1][2] -
-      transpose_matrix[0][2] * transpose_matrix[1][0];
+  const double c_12 = transpose_matrix[0][0] * transpose_matrix[2][1] -
+      transpose_matrix[0][1] * transpose_matrix[2][0];
   const double c_20 = transpose_matrix[0][1] * transpose_matrix[1][2] -
       transpose_matrix[0][2] * transpose_matrix[1][1];
   const double c_21 = transpose_matrix[0][0] * transpose_matrix[1][2] -
@@ -63,8 +116,113 @@ Isometry Isometry::inverse() const {
   return Isometry{aux * translation_vector_ * -1, aux};
 }
 
-Matrix3 Isometry::rotation() const {
-  return rotation_matrix_;
+Isometry Isometry::fromRotationVector(const Vector3& r_vector) {
+  const double angle = r_vector.norm();
+  if (angle == 0.) {
+    return Isometry();
+  }
+  return rotateAround(r_vector / angle, angle);
+}
+
+Vector3 Isometry::toRotationVector() const {
+  const Vector3 rows[] = {rotation_matrix_[0], rotation_matrix_[1],
+                          rotation_matrix_[2]};
+  const Vector3 skew{rows[2][1] - rows[1][2], rows[0][2] - rows[2][0],
+                     rows[1][0] - rows[0][1]};
+  const double sine = skew.norm() / 2.;
+  const double cosine = (rows[0][0] + rows[1][1] + rows[2][2] - 1.) / 2.;
+  const double angle = std::atan2(sine, cosine);
+  if (sine < kSmallAngleSine && cosine > 0.) {
+    return skew / 2.;
+  }
+  if (sine < kNearPiSine && cosine < 0.) {
+    // R = 2 * a * a^T - I at pi: take the axis from the largest diagonal
+    // entry of (R + I) / 2, and its sign from the skew-symmetric part.
+    int k = 0;
+    for (int i = 1; i < 3; ++i) {
+      if (rows[i][i] > rows[k][k]) {
+        k = i;
+      }
+    }
+    const double pivot = std::sqrt((rows[k][k] + 1.) / 2.);
+    Vector3 axis;
+    for (int i = 0; i < 3; ++i) {
+      axis[i] = (i == k) ? pivot : (rows[i][k] + rows[k][i]) / (4. * pivot);
+    }
+    if (axis.dot(skew) < 0.) {
+      axis *= -1.;
+    }
+    return axis * (angle / axis.norm());
+  }
+  return skew * (angle / (2. * sine));
+}
+
+Isometry Isometry::interpolate(const Isometry& r_from, const Isometry& r_to,
+                               const double& fraction) {
+  const Isometry relative{
+      Vector3::kZero,
+      r_from.rotation_matrix_.transpose().product(r_to.rotation_matrix_)};
+  const Vector3 translation{r_from.translation_vector_ +
+                            (r_to.translation_vector_ -
+                             r_from.translation_vector_) *
+                                fraction};
+  return Isometry{
+      translation,
+      r_from.rotation_matrix_.product(
+          fromRotationVector(relative.toRotationVector() * fraction)
+              .rotation_matrix_)};
+}
+
+void Isometry::interpolate(const Isometry& r_from, const Isometry& r_to,
+                           const double* fractions, const std::size_t count,
+                           Isometry* r_out, const SinCosAccuracy accuracy) {
+  const Vector3 rotation_vector{
+      Isometry{Vector3::kZero, r_from.rotation_matrix_.transpose().product(
+                                   r_to.rotation_matrix_)}
+          .toRotationVector()};
+  const double angle = rotation_vector.norm();
+  const Vector3 axis{angle > 0. ? rotation_vector / angle : Vector3::kUnitX};
+  const Vector3 delta{r_to.translation_vector_ - r_from.translation_vector_};
+  // R * (cos I + (1 - cos) a a^T + sin [a]x), row by row: row i of R a a^T
+  // is (R a)_i a^T and row i of R [a]x is r_i x a.
+  double rotation[9];
+  double outer[9];
+  double skew[9];
+  const Vector3 direction{r_from.rotation_matrix_ * axis};
+  for (int i = 0; i < 3; ++i) {
+    const Vector3 row{r_from.rotation_matrix_[i]};
+    const Vector3 cross{row.cross(axis)};
+    for (int j = 0; j < 3; ++j) {
+      rotation[3 * i + j] = row[j];
+      outer[3 * i + j] = direction[i] * axis[j];
+      skew[3 * i + j] = cross[j];
+    }
+  }
+  double angles[kBatchChunk];
+  double sines[kBatchChunk];
+  double cosines[kBatchChunk];
+  for (std::size_t begin = 0; begin < count; begin += kBatchChunk) {
+    const std::size_t size = std::min(kBatchChunk, count - begin);
+    for (std::size_t i = 0; i < size; ++i) {
+      angles[i] = fractions[begin + i] * angle;
+    }
+    internal::sincos(angles, size, sines, cosines, accuracy);
+    for (std::size_t i = 0; i < size; ++i) {
+      const double fraction = fractions[begin + i];
+      const double one_minus_cos = 1. - cosines[i];
+      double aux[9];
+      for (int k = 0; k < 9; ++k) {
+        aux[k] = cosines[i] * rotation[k] + one_minus_cos * outer[k] +
+                 sines[i] * skew[k];
+      }
+      r_out[begin + i] = Isometry{
+          Vector3(r_from.translation_vector_.x() + fraction * delta.x(),
+                  r_from.translation_vector_.y() + fraction * delta.y(),
+                  r_from.translation_vector_.z() + fraction * delta.z()),
+          Matrix3{aux[0], aux[1], aux[2], aux[3], aux[4], aux[5], aux[6],
+                  aux[7], aux[8]}};
+    }
+  }
 }
 
 Isometry Isometry::compose(const Isometry& r_isometry) const {
@@ -72,26 +230,27 @@ Isometry Isometry::compose(const Isometry& r_isometry) const {
 }
 
 Isometry Isometry::rotateAround(const Vector3& r_vector, const double& angle) {
-  Isometry aux;
-  aux.rotation_matrix_[0][0] = std::cos(angle) + pow(r_vector[0], 2)
-  * (1 - std::cos(angle));
-  aux.rotation_matrix_[0][1] = r_vector[0] * r_vector[1] *
-  (1 - std::cos(angle)) - r_vector[2] * std::sin(angle);
-  aux.rotation_matrix_[0][2] = r_vector[0] * r_vector[2] *
-  (1 - std::cos(angle)) + r_vector[1] * std::sin(angle);
-  aux.rotation_matrix_[1][0] = r_vector[1] * r_vector[0] *
-  (1 - std::cos(angle)) + r_vector[2] * std::sin(angle);
-  aux.rotation_matrix_[1][1] = std::cos(angle) + pow(r_vector[1], 2)
-  * (1 - std::cos(angle));
-  aux.rotation_matrix_[1][2] = r_vector[1] * r_vector[2] *
-  (1 - std::cos(angle)) - r_vector[0] * std::sin(angle);
-  aux.rotation_matrix_[2][0] = r_vector[2] * r_vector[0] *
-  (1 - std::cos(angle)) - r_vector[1] * std::sin(angle);
-  aux.rotation_matrix_[2][1] = r_vector[2] * r_vector[1] *
-  (1 - std::cos(angle)) + r_vector[0] * std::sin(angle);
-  aux.rotation_matrix_[2][2] = std::cos(angle) + pow(r_vector[2], 2)
-  * (1 - std::cos(angle));
-  return aux;
+  AxisAlignedRotation permutation;
+  if (AxisAlignedRotation::fromAxisAngle(r_vector, angle, &permutation)) {
+    return Isometry{Vector3::kZero, permutation};
+  }
+  return Isometry{Vector3::kZero,
+                  axis_rotation(r_vector, std::cos(angle), std::sin(angle))};
+}
+
+void Isometry::rotateAround(const Vector3& r_vector, const double* angles,
+                            const std::size_t count, Isometry* r_out,
+                            const SinCosAccuracy accuracy) {
+  double sines[kBatchChunk];
+  double cosines[kBatchChunk];
+  for (std::size_t begin = 0; begin < count; begin += kBatchChunk) {
+    const std::size_t size = std::min(kBatchChunk, count - begin);
+    internal::sincos(angles + begin, size, sines, cosines, accuracy);
+    for (std::size_t i = 0; i < size; ++i) {
+      r_out[begin + i] = Isometry{
+          Vector3::kZero, axis_rotation(r_vector, cosines[i], sines[i])};
+    }
+  }
 }
 
 Isometry Isometry::fromEulerAngles(const double& roll, const double& pitch,
@@ -101,6 +260,89 @@ Isometry Isometry::fromEulerAngles(const double& roll, const double& pitch,
                  Isometry::rotateAround(Vector3::kUnitZ, yaw);
 }
 
+void Isometry::fromEulerAngles(const double* rolls, const double* pitches,
+                               const double* yaws, const std::size_t count,
+                               Isometry* r_out,
+                               const SinCosAccuracy accuracy) {
+  double sr[kBatchChunk];
+  double cr[kBatchChunk];
+  double sp[kBatchChunk];
+  double cp[kBatchChunk];
+  double sy[kBatchChunk];
+  double cy[kBatchChunk];
+  for (std::size_t begin = 0; begin < count; begin += kBatchChunk) {
+    const std::size_t size = std::min(kBatchChunk, count - begin);
+    internal::sincos(rolls + begin, size, sr, cr, accuracy);
+    internal::sincos(pitches + begin, size, sp, cp, accuracy);
+    internal::sincos(yaws + begin, size, sy, cy, accuracy);
+    // Closed form of Rx(roll) * Ry(pitch) * Rz(yaw).
+    for (std::size_t i = 0; i < size; ++i) {
+      r_out[begin + i] = Isometry{
+          Vector3::kZero,
+          Matrix3{cp[i] * cy[i], -cp[i] * sy[i], sp[i],
+                  sr[i] * sp[i] * cy[i] + cr[i] * sy[i],
+                  cr[i] * cy[i] - sr[i] * sp[i] * sy[i], -sr[i] * cp[i],
+                  sr[i] * sy[i] - cr[i] * sp[i] * cy[i],
+                  sr[i] * cy[i] + cr[i] * sp[i] * sy[i], cr[i] * cp[i]}};
+    }
+  }
+}
+
+Isometry Isometry::fromEulerAngles(const Vector3& angles,
+                                   const EulerSequence sequence,
+                                   const EulerFrame frame) {
+  const Isometry first{rotateAround(eulerAxis(sequence, 0), angles.x())};
+  const Isometry second{rotateAround(eulerAxis(sequence, 1), angles.y())};
+  const Isometry third{rotateAround(eulerAxis(sequence, 2), angles.z())};
+  if (frame == EulerFrame::kIntrinsic) {
+    return first * second * third;
+  }
+  return third * second * first;
+}
+
+void Isometry::fromEulerAngles(const Vector3* angles, const std::size_t count,
+                               Isometry* r_out, const EulerSequence sequence,
+                               const EulerFrame frame,
+                               const SinCosAccuracy accuracy) {
+  // Angles are split into one array per position in the sequence, so each
+  // of them goes through the vectorized sincos kernel.
+  double values[3][kBatchChunk];
+  double sines[3][kBatchChunk];
+  double cosines[3][kBatchChunk];
+  for (std::size_t begin = 0; begin < count; begin += kBatchChunk) {
+    const std::size_t size = std::min(kBatchChunk, count - begin);
+    for (std::size_t i = 0; i < size; ++i) {
+      values[0][i] = angles[begin + i].x();
+      values[1][i] = angles[begin + i].y();
+      values[2][i] = angles[begin + i].z();
+    }
+    for (int axis = 0; axis < 3; ++axis) {
+      internal::sincos(values[axis], size, sines[axis], cosines[axis],
+                       accuracy);
+    }
+    for (std::size_t i = 0; i < size; ++i) {
+      const double sine[] = {sines[0][i], sines[1][i], sines[2][i]};
+      const double cosine[] = {cosines[0][i], cosines[1][i], cosines[2][i]};
+      r_out[begin + i] = Isometry{
+          Vector3::kZero, eulerRotation(sine, cosine, sequence, frame)};
+    }
+  }
+}
+
+Vector3 Isometry::toEulerAngles(const EulerSequence sequence,
+                                const EulerFrame frame) const {
+  return eulerAngles(rotation_matrix_, sequence, frame);
+}
+
+void Isometry::toEulerAngles(const Isometry* isometries,
+                             const std::size_t count, Vector3* r_out,
+                             const EulerSequence sequence,
+                             const EulerFrame frame) {
+  for (std::size_t i = 0; i < count; ++i) {
+    r_out[i] = eulerAngles(isometries[i].rotation_matrix_, sequence, frame);
+  }
+}
+
 bool Isometry::operator==(const Isometry& r_isometry) const {
   return translation_vector_ == r_isometry.translation_vector_ &&
   rotation_matrix_ == r_isometry.rotation_matrix_;
@@ -111,14 +353,28 @@ bool Isometry::operator!=(const Isometry& r_isometry) const {
 }
 
 Vector3 Isometry::operator*(const Vector3& r_vector) const {
+  if (axis_aligned_) {
+    return permutation_ * r_vector + translation_vector_;
+  }
   return translation_vector_operation(rotation_matrix_,
                                              r_vector, translation_vector_);
 }
 
 Isometry Isometry::operator*(const Isometry& r_isometry) const {
-  return Isometry{translation_vector_operation(
-    rotation_matrix_, translation_vector_, r_isometry.translation_vector_),
-    rotation_matrix_.product(r_isometry.rotation_matrix_)};
+  const Vector3 translation{(*this) * r_isometry.translation_vector_};
+  if (axis_aligned_ && r_isometry.axis_aligned_) {
+    return Isometry{translation, permutation_ * r_isometry.permutation_};
+  }
+  if (axis_aligned_) {
+    return Isometry{translation,
+                    permutation_.product(r_isometry.rotation_matrix_)};
+  }
+  if (r_isometry.axis_aligned_) {
+    return Isometry{translation,
+                    r_isometry.permutation_.rightProduct(rotation_matrix_)};
+  }
+  return Isometry{translation,
+                  rotation_matrix_.product(r_isometry.rotation_matrix_)};
 }
 
 Isometry& Isometry::operator*=(const Isometry& r_isometry) {
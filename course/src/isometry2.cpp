@@ -0,0 +1,111 @@
+/*
+ * Planar isometry library
+ * Author: Steven Desvars, 2020
+ * Copyright 2020 Ekumen
+ */
+
+#include <isometry/isometry2.hpp>
+
+namespace ekumen {
+namespace math {
+
+namespace {
+
+double normalize_angle(const double angle) {
+  if (angle > M_PI) {
+    return angle - 2. * M_PI;
+  }
+  if (angle <= -M_PI) {
+    return angle + 2. * M_PI;
+  }
+  return angle;
+}
+
+}  // namespace
+
+Isometry2::Isometry2(const double x, const double y, const double theta)
+    : x_{x},
+      y_{y},
+      theta_{std::remainder(theta, 2. * M_PI)},
+      cos_{std::cos(theta)},
+      sin_{std::sin(theta)} {
+  theta_ = normalize_angle(theta_);
+}
+
+Isometry2 Isometry2::fromTranslation(const double x, const double y) {
+  return Isometry2{x, y, 0., 1., 0.};
+}
+
+Isometry2 Isometry2::fromRotation(const double theta) {
+  return Isometry2{0., 0., theta};
+}
+
+Vector3 Isometry2::transform(const Vector3& r_vector) const {
+  return (*this) * r_vector;
+}
+
+void Isometry2::transform(const Vector3* r_points, const std::size_t count,
+                          Vector3* r_out) const {
+  for (std::size_t i = 0; i < count; ++i) {
+    const double px = r_points[i].x();
+    const double py = r_points[i].y();
+    const double pz = r_points[i].z();
+    r_out[i] = Vector3(cos_ * px - sin_ * py + x_, sin_ * px + cos_ * py + y_,
+                       pz);
+  }
+}
+
+Isometry2 Isometry2::inverse() const {
+  return Isometry2{-cos_ * x_ - sin_ * y_, sin_ * x_ - cos_ * y_,
+                   normalize_angle(-theta_), cos_, -sin_};
+}
+
+Isometry2 Isometry2::compose(const Isometry2& r_isometry) const {
+  return *this * r_isometry;
+}
+
+Isometry Isometry2::toIsometry() const {
+  return Isometry{Vector3(x_, y_, 0.),
+                  Matrix3{cos_, -sin_, 0., sin_, cos_, 0., 0., 0., 1.}};
+}
+
+bool Isometry2::operator==(const Isometry2& r_isometry) const {
+  return almost_equal(x_, r_isometry.x_, 2) &&
+         almost_equal(y_, r_isometry.y_, 2) &&
+         almost_equal(cos_, r_isometry.cos_, 2) &&
+         almost_equal(sin_, r_isometry.sin_, 2);
+}
+
+bool Isometry2::operator!=(const Isometry2& r_isometry) const {
+  return !(*this == r_isometry);
+}
+
+Vector3 Isometry2::operator*(const Vector3& r_vector) const {
+  return Vector3(cos_ * r_vector.x() - sin_ * r_vector.y() + x_,
+                 sin_ * r_vector.x() + cos_ * r_vector.y() + y_, r_vector.z());
+}
+
+Isometry2 Isometry2::operator*(const Isometry2& r_isometry) const {
+  // Angle addition formulas keep the cached cosine and sine in sync with the
+  // heading without evaluating any trigonometric function.
+  return Isometry2{
+      cos_ * r_isometry.x_ - sin_ * r_isometry.y_ + x_,
+      sin_ * r_isometry.x_ + cos_ * r_isometry.y_ + y_,
+      normalize_angle(theta_ + r_isometry.theta_),
+      cos_ * r_isometry.cos_ - sin_ * r_isometry.sin_,
+      sin_ * r_isometry.cos_ + cos_ * r_isometry.sin_};
+}
+
+Isometry2& Isometry2::operator*=(const Isometry2& r_isometry) {
+  *this = (*this) * r_isometry;
+  return *this;
+}
+
+std::ostream& operator<<(std::ostream& os, const Isometry2& r_isometry) {
+  os << "[x: " << r_isometry.x() << ", y: " << r_isometry.y()
+     << ", theta: " << r_isometry.theta() << "]";
+  return os;
+}
+
+}  // namespace math
+}  // namespace ekumen
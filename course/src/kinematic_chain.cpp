@@ -0,0 +1,217 @@
+/*
+ * Kinematic chain library
+ * Author: Steven Desvars, 2020
+ * Copyright 2020 Ekumen
+ */
+
+#include <algorithm>
+#include <isometry/kinematic_chain.hpp>
+#include <stdexcept>
+
+namespace ekumen {
+namespace math {
+
+namespace {
+
+// Configurations are evaluated in fixed-size chunks on the stack.
+const std::size_t kBatchChunk{64};
+
+// Poses are kept as 12 doubles, the row-major rotation followed by the
+// translation, so composing stays inline.
+const std::size_t kPoseSize{12};
+const double kIdentityPose[kPoseSize]{1., 0., 0., 0., 1., 0.,
+                                      0., 0., 1., 0., 0., 0.};
+
+void toPose(const Isometry& r_isometry, double* r_pose) {
+  const Matrix3 rotation{r_isometry.rotation()};
+  const Vector3 translation{r_isometry.translation()};
+  for (int i = 0; i < 3; ++i) {
+    const Vector3 row{rotation.row(i)};
+    r_pose[3 * i] = row.x();
+    r_pose[3 * i + 1] = row.y();
+    r_pose[3 * i + 2] = row.z();
+    r_pose[9 + i] = translation[i];
+  }
+}
+
+Isometry toIsometry(const double* pose) {
+  return Isometry{Vector3(pose[9], pose[10], pose[11]),
+                  Matrix3{pose[0], pose[1], pose[2], pose[3], pose[4],
+                          pose[5], pose[6], pose[7], pose[8]}};
+}
+
+// r_pose = r_pose * (rotation, translation)
+void compose(const double* rotation, const double* translation,
+             double* r_pose) {
+  double aux[kPoseSize];
+  for (int i = 0; i < 3; ++i) {
+    const double* row = r_pose + 3 * i;
+    for (int j = 0; j < 3; ++j) {
+      aux[3 * i + j] = row[0] * rotation[j] + row[1] * rotation[3 + j] +
+                       row[2] * rotation[6 + j];
+    }
+    aux[9 + i] = row[0] * translation[0] + row[1] * translation[1] +
+                 row[2] * translation[2] + r_pose[9 + i];
+  }
+  std::copy(aux, aux + kPoseSize, r_pose);
+}
+
+}  // namespace
+
+KinematicChain::KinematicChain() : tip_{Isometry()} {
+  std::copy(kIdentityPose, kIdentityPose + kPoseSize, tip_pose_);
+}
+
+void KinematicChain::addJoint(const JointType type, const Isometry& r_origin,
+                              const Vector3& r_axis) {
+  const double norm = r_axis.norm();
+  if (norm == 0.) {
+    throw std::invalid_argument("The joint axis can't be null");
+  }
+  const Isometry origin{tip_ * r_origin};
+  const Vector3 k{r_axis.x() / norm, r_axis.y() / norm, r_axis.z() / norm};
+  const Matrix3 rotation{origin.rotation()};
+  const Vector3 direction{rotation * k};
+  Joint joint;
+  joint.type = type;
+  joint.axis = k;
+  for (int i = 0; i < 3; ++i) {
+    joint.translation[i] = origin.translation()[i];
+    joint.direction[i] = direction[i];
+    // Row i of R * k * k^T is (R * k)_i * k^T, and row i of R * [k]x is
+    // r_i x k.
+    const Vector3 row{rotation.row(i)};
+    const Vector3 skew{row.cross(k)};
+    for (int j = 0; j < 3; ++j) {
+      joint.rotation[3 * i + j] = row[j];
+      joint.outer[3 * i + j] = direction[i] * k[j];
+      joint.skew[3 * i + j] = skew[j];
+    }
+  }
+  joints_.push_back(joint);
+  tip_ = Isometry();
+  std::copy(kIdentityPose, kIdentityPose + kPoseSize, tip_pose_);
+}
+
+void KinematicChain::addDHJoint(const JointType type, const double a,
+                                const double alpha, const double d,
+                                const double theta) {
+  // The joint moves first, then the rest of the link becomes a fixed
+  // transform in front of the next joint.
+  Isometry rest{Isometry::fromTranslation(Vector3(a, 0., 0.)) *
+                Isometry::rotateAround(Vector3::kUnitX, alpha)};
+  if (type == JointType::kRevolute) {
+    addJoint(type, Isometry::rotateAround(Vector3::kUnitZ, theta),
+             Vector3::kUnitZ);
+    rest = Isometry::fromTranslation(Vector3(0., 0., d)) * rest;
+  } else {
+    addJoint(type, Isometry::rotateAround(Vector3::kUnitZ, theta) *
+                       Isometry::fromTranslation(Vector3(0., 0., d)),
+             Vector3::kUnitZ);
+  }
+  addTip(rest);
+}
+
+void KinematicChain::addTip(const Isometry& r_tip) {
+  tip_ *= r_tip;
+  toPose(tip_, tip_pose_);
+}
+
+void KinematicChain::forwardKinematics(const double* q,
+                                       Isometry* r_poses) const {
+  double pose[kPoseSize];
+  std::copy(kIdentityPose, kIdentityPose + kPoseSize, pose);
+  for (std::size_t i = 0; i < joints_.size(); ++i) {
+    const Joint& joint = joints_[i];
+    if (joint.type == JointType::kRevolute) {
+      double sine;
+      double cosine;
+      internal::sincos(q[i], &sine, &cosine, SinCosAccuracy::kFull);
+      advance(joint, cosine, sine, pose);
+    } else {
+      advance(joint, q[i], pose);
+    }
+    r_poses[i] = toIsometry(pose);
+  }
+}
+
+Isometry KinematicChain::endEffector(const double* q) const {
+  double pose[kPoseSize];
+  std::copy(kIdentityPose, kIdentityPose + kPoseSize, pose);
+  for (std::size_t i = 0; i < joints_.size(); ++i) {
+    const Joint& joint = joints_[i];
+    if (joint.type == JointType::kRevolute) {
+      double sine;
+      double cosine;
+      internal::sincos(q[i], &sine, &cosine, SinCosAccuracy::kFull);
+      advance(joint, cosine, sine, pose);
+    } else {
+      advance(joint, q[i], pose);
+    }
+  }
+  compose(tip_pose_, tip_pose_ + 9, pose);
+  return toIsometry(pose);
+}
+
+void KinematicChain::endEffectors(const double* configurations,
+                                  const std::size_t count, Isometry* r_out,
+                                  const SinCosAccuracy accuracy) const {
+  const std::size_t dof = joints_.size();
+  double angles[kBatchChunk];
+  double sines[kBatchChunk];
+  double cosines[kBatchChunk];
+  double poses[kBatchChunk][kPoseSize];
+  for (std::size_t begin = 0; begin < count; begin += kBatchChunk) {
+    const std::size_t size = std::min(kBatchChunk, count - begin);
+    const double* chunk = configurations + begin * dof;
+    for (std::size_t i = 0; i < size; ++i) {
+      std::copy(kIdentityPose, kIdentityPose + kPoseSize, poses[i]);
+    }
+    // Joint by joint, so each joint's constants stay hot across the chunk
+    // and its angles go through the batch kernel at once.
+    for (std::size_t j = 0; j < dof; ++j) {
+      const Joint& joint = joints_[j];
+      if (joint.type == JointType::kRevolute) {
+        for (std::size_t i = 0; i < size; ++i) {
+          angles[i] = chunk[i * dof + j];
+        }
+        internal::sincos(angles, size, sines, cosines, accuracy);
+        for (std::size_t i = 0; i < size; ++i) {
+          advance(joint, cosines[i], sines[i], poses[i]);
+        }
+      } else {
+        for (std::size_t i = 0; i < size; ++i) {
+          advance(joint, chunk[i * dof + j], poses[i]);
+        }
+      }
+    }
+    for (std::size_t i = 0; i < size; ++i) {
+      compose(tip_pose_, tip_pose_ + 9, poses[i]);
+      r_out[begin + i] = toIsometry(poses[i]);
+    }
+  }
+}
+
+void KinematicChain::advance(const Joint& r_joint, const double cosine,
+                             const double sine, double* r_pose) {
+  // R * (cos(q) I + (1 - cos(q)) k k^T + sin(q) [k]x)
+  const double one_minus_cos = 1. - cosine;
+  double rotation[9];
+  for (int i = 0; i < 9; ++i) {
+    rotation[i] = cosine * r_joint.rotation[i] +
+                  one_minus_cos * r_joint.outer[i] + sine * r_joint.skew[i];
+  }
+  compose(rotation, r_joint.translation, r_pose);
+}
+
+void KinematicChain::advance(const Joint& r_joint, const double value,
+                             double* r_pose) {
+  double translation[3];
+  for (int i = 0; i < 3; ++i) {
+    translation[i] = r_joint.translation[i] + value * r_joint.direction[i];
+  }
+  compose(r_joint.rotation, translation, r_pose);
+}
+
+}  // namespace math
+}  // namespace ekumen
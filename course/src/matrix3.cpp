@@ -6,24 +6,12 @@
  * Copyright 2020 Ekumen"
  */
 
+#include <isometry/matrix3_format.hpp>
 #include <isometry/matrix3.hpp>
 
 namespace ekumen {
 namespace math {
 
-namespace {
-
-std::string row_print(const Vector3& r_vector) {
-  std::stringstream ss(std::ios_base::in | std::ios_base::out);
-  ss << std::setprecision(9);
-  ss << "[" << r_vector.x() << ", " << r_vector.y() << ", " << r_vector.z()
-     << "]";
-  std::string aux = ss.str();
-  return aux;
-}
-
-}  // namespace
-
 Matrix3::Matrix3(const std::initializer_list<double>& values) {
   if (values.size() != 9) {
     throw std::length_error("Incorrect size of list");
@@ -45,19 +33,6 @@ Matrix3::Matrix3(const std::initializer_list<double>& values) {
   }
 }
 
-Vector3 Matrix3::operator[](const int i) const {
-  switch (i) {
-    case 0:
-      return row_0_;
-    case 1:
-      return row_1_;
-    case 2:
-      return row_2_;
-    default:
-      throw std::out_of_range("Operator out of range");
-  }
-}
-
 Vector3& Matrix3::operator[](const int i) {
   switch (i) {
     case 0:
@@ -201,11 +176,6 @@ Matrix3& Matrix3::operator/=(const double& value) {
   return *this;
 }
 
-Vector3 Matrix3::row(const int& value) const {
-  Vector3 aux{(*this)[value]};
-  return aux;
-}
-
 Vector3 Matrix3::col(const int& value) const {
   Vector3 aux;
   for (int i = 0; i < 3; ++i) {
@@ -219,8 +189,9 @@ Matrix3 operator*(const double value, const Matrix3& r_matrix) {
 }
 
 std::ostream& operator<<(std::ostream& os, const Matrix3& r_matrix) {
-  os << "[" << row_print(r_matrix.row(0)) << ", " << row_print(r_matrix.row(1))
-     << ", " << row_print(r_matrix.row(2)) << "]";
+  char buffer[kFormatBufferSize];
+  format(r_matrix, buffer, kFormatBufferSize);
+  os << buffer;
   return os;
 }
 
@@ -0,0 +1,128 @@
+/*
+ * Number parsing library
+ * Author: Steven Desvars, 2020
+ * Copyright 2020 Ekumen
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <isometry/internal/parse_double.hpp>
+
+namespace ekumen {
+namespace math {
+namespace internal {
+
+namespace {
+
+// Powers of ten that are exact in a double.
+const double kExactPowers[]{1e0,  1e1,  1e2,  1e3,  1e4,  1e5,
+                            1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                            1e12, 1e13, 1e14, 1e15, 1e16, 1e17,
+                            1e18, 1e19, 1e20, 1e21, 1e22};
+const int kMaxExactPower{22};
+// Integers up to 2^53 are exact in a double.
+const std::uint64_t kMaxExactMantissa{std::uint64_t{1} << 53};
+const int kMaxMantissaDigits{19};
+// Longest number handed to strtod(), longer ones are rejected. It leaves
+// room for the 767 significant digits that a correctly rounded conversion
+// may need.
+const std::size_t kMaxLength{1023};
+
+bool isDigit(const char c) { return c >= '0' && c <= '9'; }
+
+// Parses with strtod() from a null terminated copy on the stack of at most
+// kMaxLength characters of the range.
+const char* parseSlow(const char* begin, const char* end, double* r_value) {
+  char copy[kMaxLength + 1];
+  const std::size_t length =
+      std::min(static_cast<std::size_t>(end - begin), kMaxLength);
+  std::memcpy(copy, begin, length);
+  copy[length] = '\0';
+  char* parsed;
+  const double value = std::strtod(copy, &parsed);
+  if (parsed == copy) {
+    return nullptr;
+  }
+  *r_value = value;
+  return begin + (parsed - copy);
+}
+
+}  // namespace
+
+const char* parseDouble(const char* begin, const char* end, double* r_value) {
+  const char* it = begin;
+  const bool negative = it != end && *it == '-';
+  if (it != end && (*it == '-' || *it == '+')) {
+    ++it;
+  }
+  std::uint64_t mantissa{0};
+  int digits{0};
+  int exponent{0};
+  bool any_digit{false};
+  for (; it != end && isDigit(*it); ++it) {
+    any_digit = true;
+    if (digits < kMaxMantissaDigits) {
+      mantissa = mantissa * 10 + (*it - '0');
+      digits += mantissa > 0 ? 1 : 0;
+    } else {
+      ++exponent;
+      ++digits;
+    }
+  }
+  if (it != end && *it == '.') {
+    for (++it; it != end && isDigit(*it); ++it) {
+      any_digit = true;
+      if (digits < kMaxMantissaDigits) {
+        mantissa = mantissa * 10 + (*it - '0');
+        digits += mantissa > 0 ? 1 : 0;
+        --exponent;
+      } else {
+        ++digits;
+      }
+    }
+  }
+  if (!any_digit) {
+    // inf, nan and the like.
+    const bool special = it != end && (*it == 'i' || *it == 'I' ||
+                                       *it == 'n' || *it == 'N');
+    return special ? parseSlow(begin, end, r_value) : nullptr;
+  }
+  if (it != end && (*it == 'e' || *it == 'E')) {
+    const char* mark = it;
+    ++it;
+    const bool negative_exponent = it != end && *it == '-';
+    if (it != end && (*it == '-' || *it == '+')) {
+      ++it;
+    }
+    if (it == end || !isDigit(*it)) {
+      // Not an exponent, the number ends before the 'e'.
+      it = mark;
+    } else {
+      int value{0};
+      for (; it != end && isDigit(*it); ++it) {
+        value = std::min(value * 10 + (*it - '0'), 100000);
+      }
+      exponent += negative_exponent ? -value : value;
+    }
+  }
+  if (digits > kMaxMantissaDigits || mantissa > kMaxExactMantissa ||
+      exponent < -kMaxExactPower || exponent > kMaxExactPower) {
+    if (static_cast<std::size_t>(it - begin) > kMaxLength) {
+      return nullptr;
+    }
+    return parseSlow(begin, it, r_value) ? it : nullptr;
+  }
+  // Both operands are exact, so the single rounding of the operation gives
+  // the correctly rounded result.
+  double value = static_cast<double>(mantissa);
+  value = exponent < 0 ? value / kExactPowers[-exponent]
+                       : value * kExactPowers[exponent];
+  *r_value = negative ? -value : value;
+  return it;
+}
+
+}  // namespace internal
+}  // namespace math
+}  // namespace ekumen
@@ -0,0 +1,426 @@
+/*
+ * Point cloud streaming library
+ * Author: Steven Desvars, 2020
+ * Copyright 2020 Ekumen
+ */
+
+#include <isometry/point_cloud_stream.hpp>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <isometry/binary.hpp>
+#include <isometry/internal/file_io.hpp>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace ekumen {
+namespace math {
+
+namespace {
+
+// Longest PLY header accepted.
+const std::size_t kMaxHeaderSize{65536};
+
+const char kPlyMagic[]{"ply\n"};
+const char kEndHeader[]{"end_header\n"};
+
+// Owned file descriptor.
+class File {
+ public:
+  File(const std::string& r_path, const int flags) : path_{r_path} {
+    fd_ = ::open(r_path.c_str(), flags | O_CLOEXEC, 0644);
+    if (fd_ < 0) {
+      throw internal::systemError("Cannot open " + r_path);
+    }
+  }
+
+  File(const File&) = delete;
+  File& operator=(const File&) = delete;
+
+  ~File() {
+    if (fd_ >= 0) {
+      ::close(fd_);
+    }
+  }
+
+  // Reads until the size is reached or the file ends.
+  // @returns Number of bytes read.
+  std::size_t read(unsigned char* bytes, const std::size_t size) {
+    std::size_t done{0};
+    while (done < size) {
+      const ssize_t result = ::read(fd_, bytes + done, size - done);
+      if (result < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        throw internal::systemError("Cannot read " + path_);
+      }
+      if (result == 0) {
+        break;
+      }
+      done += static_cast<std::size_t>(result);
+    }
+    return done;
+  }
+
+  void write(const unsigned char* bytes, const std::size_t size) {
+    internal::writeAll(fd_, bytes, size, "Cannot write " + path_);
+  }
+
+  void seek(const std::size_t offset) {
+    if (::lseek(fd_, static_cast<off_t>(offset), SEEK_SET) < 0) {
+      throw internal::systemError("Cannot seek " + path_);
+    }
+  }
+
+  // Whether both descriptors open the same file, through hard links too.
+  bool isSameFile(const File& r_other) const {
+    struct stat own;
+    struct stat other;
+    if (::fstat(fd_, &own) != 0 || ::fstat(r_other.fd_, &other) != 0) {
+      throw internal::systemError("Cannot stat " + path_);
+    }
+    return own.st_dev == other.st_dev && own.st_ino == other.st_ino;
+  }
+
+  void truncate() {
+    if (::ftruncate(fd_, 0) != 0) {
+      throw internal::systemError("Cannot truncate " + path_);
+    }
+  }
+
+  // Closes the file, reporting the errors a deferred write may raise.
+  void close() {
+    const int fd = fd_;
+    fd_ = -1;
+    if (::close(fd) != 0) {
+      throw internal::systemError("Cannot close " + path_);
+    }
+  }
+
+ private:
+  std::string path_;
+  int fd_;
+};
+
+// Where the coordinates are within a point record.
+struct Layout {
+  // Bytes copied verbatim in front of the points.
+  std::string header;
+  std::size_t stride;
+  std::size_t offsets[3];
+  bool doubles[3];
+  // Whether the number of points is known, the data after them being
+  // copied untouched. Otherwise points go on until the file ends.
+  bool counted;
+  std::size_t points;
+};
+
+std::size_t scalarSize(const std::string& r_type) {
+  if (r_type == "char" || r_type == "uchar" || r_type == "int8" ||
+      r_type == "uint8") {
+    return 1;
+  }
+  if (r_type == "short" || r_type == "ushort" || r_type == "int16" ||
+      r_type == "uint16") {
+    return 2;
+  }
+  if (r_type == "int" || r_type == "uint" || r_type == "int32" ||
+      r_type == "uint32" || r_type == "float" || r_type == "float32") {
+    return 4;
+  }
+  if (r_type == "double" || r_type == "float64") {
+    return 8;
+  }
+  throw std::invalid_argument("Unknown PLY property type " + r_type);
+}
+
+Layout plyLayout(const std::string& r_header) {
+  Layout layout{r_header, 0, {0, 0, 0}, {false, false, false}, true, 0};
+  bool found[3]{false, false, false};
+  bool format{false};
+  std::string element;
+  std::istringstream lines{r_header};
+  std::string line;
+  while (std::getline(lines, line)) {
+    std::istringstream tokens{line};
+    std::string keyword;
+    tokens >> keyword;
+    if (keyword == "format") {
+      std::string encoding;
+      std::string version;
+      tokens >> encoding >> version;
+      if (encoding != "binary_little_endian" || version != "1.0") {
+        throw std::invalid_argument(
+            "Only binary little-endian PLY files are supported");
+      }
+      format = true;
+    } else if (keyword == "element") {
+      const bool first = element.empty();
+      tokens >> element;
+      if (first) {
+        if (element != "vertex" || !(tokens >> layout.points)) {
+          throw std::invalid_argument("PLY vertices must come first");
+        }
+      }
+    } else if (keyword == "property" && element == "vertex") {
+      std::string type;
+      std::string name;
+      tokens >> type >> name;
+      if (type == "list") {
+        throw std::invalid_argument("PLY vertex lists are not supported");
+      }
+      const std::size_t size = scalarSize(type);
+      const int axis = name == "x" ? 0 : name == "y" ? 1 : name == "z" ? 2 : -1;
+      if (axis >= 0) {
+        if (size != 4 && size != 8) {
+          throw std::invalid_argument("PLY coordinates must be float or "
+                                      "double");
+        }
+        found[axis] = true;
+        layout.offsets[axis] = layout.stride;
+        layout.doubles[axis] = size == 8;
+      }
+      layout.stride += size;
+    }
+  }
+  if (!format || !found[0] || !found[1] || !found[2]) {
+    throw std::invalid_argument("PLY vertices lack a format or coordinates");
+  }
+  return layout;
+}
+
+// Reads the PLY header if there is one, leaving the file at the points.
+Layout readLayout(File* r_file) {
+  std::string header(kMaxHeaderSize, '\0');
+  header.resize(r_file->read(reinterpret_cast<unsigned char*>(&header[0]),
+                             header.size()));
+  if (header.compare(0, sizeof(kPlyMagic) - 1, kPlyMagic) != 0) {
+    r_file->seek(0);
+    return Layout{std::string(), 3 * sizeof(float), {0, 4, 8},
+                  {false, false, false}, false, 0};
+  }
+  const std::size_t end = header.find(kEndHeader);
+  if (end == std::string::npos) {
+    throw std::invalid_argument("PLY header too long or truncated");
+  }
+  header.resize(end + sizeof(kEndHeader) - 1);
+  r_file->seek(header.size());
+  return plyLayout(header);
+}
+
+double loadCoordinate(const unsigned char* bytes, const bool is_double) {
+  if (is_double) {
+    double value;
+    internal::loadDoubles(bytes, 1, &value);
+    return value;
+  }
+  const std::uint32_t bits =
+      static_cast<std::uint32_t>(internal::loadInteger(bytes, 4));
+  float value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+void storeCoordinate(const double value, const bool is_double,
+                     unsigned char* r_out) {
+  if (is_double) {
+    internal::storeDoubles(&value, 1, r_out);
+    return;
+  }
+  const float single = static_cast<float>(value);
+  std::uint32_t bits;
+  std::memcpy(&bits, &single, sizeof(bits));
+  internal::storeInteger(bits, 4, r_out);
+}
+
+struct Chunk {
+  std::vector<unsigned char> bytes;
+  std::size_t size;
+  // Whether it holds points, or data copied untouched.
+  bool points;
+};
+
+// State shared by the reader thread and the transforming one. Chunk k is
+// stored in slot k % 2.
+struct Pipeline {
+  std::mutex mutex;
+  std::condition_variable changed;
+  Chunk chunks[2];
+  std::size_t produced{0};
+  std::size_t consumed{0};
+  bool finished{false};
+  bool stop{false};
+  std::exception_ptr error;
+};
+
+// Fills a chunk.
+// @returns Whether there was anything left to read.
+bool fill(const Layout& r_layout, File* r_file, std::size_t* r_point_bytes,
+          Chunk* r_chunk) {
+  const std::size_t capacity = r_chunk->bytes.size();
+  const std::size_t total_point_bytes = r_layout.points * r_layout.stride;
+  r_chunk->points = !r_layout.counted || *r_point_bytes < total_point_bytes;
+  const std::size_t wanted =
+      r_layout.counted && r_chunk->points
+          ? std::min(capacity, total_point_bytes - *r_point_bytes)
+          : capacity;
+  r_chunk->size = r_file->read(r_chunk->bytes.data(), wanted);
+  if (r_chunk->points) {
+    if (r_layout.counted ? r_chunk->size != wanted
+                         : r_chunk->size % r_layout.stride != 0) {
+      throw std::invalid_argument("Truncated point cloud");
+    }
+    *r_point_bytes += r_chunk->size;
+  }
+  return r_chunk->size > 0;
+}
+
+void readChunks(const Layout& r_layout, File* r_file, Pipeline* r_pipeline) {
+  try {
+    std::size_t point_bytes{0};
+    for (std::size_t k = 0;; ++k) {
+      {
+        std::unique_lock<std::mutex> lock{r_pipeline->mutex};
+        r_pipeline->changed.wait(lock, [&] {
+          return k - r_pipeline->consumed < 2 || r_pipeline->stop;
+        });
+        if (r_pipeline->stop) {
+          return;
+        }
+      }
+      const bool filled =
+          fill(r_layout, r_file, &point_bytes, &r_pipeline->chunks[k % 2]);
+      std::lock_guard<std::mutex> lock{r_pipeline->mutex};
+      if (!filled) {
+        r_pipeline->finished = true;
+        r_pipeline->changed.notify_all();
+        return;
+      }
+      ++r_pipeline->produced;
+      r_pipeline->changed.notify_all();
+    }
+  } catch (...) {
+    std::lock_guard<std::mutex> lock{r_pipeline->mutex};
+    r_pipeline->error = std::current_exception();
+    r_pipeline->finished = true;
+    r_pipeline->changed.notify_all();
+  }
+}
+
+// Stops and joins the reader thread however the transforming one leaves.
+class ReaderGuard {
+ public:
+  ReaderGuard(Pipeline* r_pipeline, std::thread* r_thread)
+      : pipeline_{r_pipeline}, thread_{r_thread} {}
+
+  ~ReaderGuard() {
+    {
+      std::lock_guard<std::mutex> lock{pipeline_->mutex};
+      pipeline_->stop = true;
+    }
+    pipeline_->changed.notify_all();
+    thread_->join();
+  }
+
+ private:
+  Pipeline* pipeline_;
+  std::thread* thread_;
+};
+
+void transformPoints(const Layout& r_layout, const Isometry& r_isometry,
+                     Chunk* r_chunk, std::vector<Vector3>* r_scratch) {
+  const std::size_t count = r_chunk->size / r_layout.stride;
+  unsigned char* bytes = r_chunk->bytes.data();
+  Vector3* scratch = r_scratch->data();
+  for (std::size_t i = 0; i < count; ++i) {
+    const unsigned char* point = bytes + i * r_layout.stride;
+    scratch[i] = Vector3(
+        loadCoordinate(point + r_layout.offsets[0], r_layout.doubles[0]),
+        loadCoordinate(point + r_layout.offsets[1], r_layout.doubles[1]),
+        loadCoordinate(point + r_layout.offsets[2], r_layout.doubles[2]));
+  }
+  r_isometry.transform(scratch, count, scratch);
+  for (std::size_t i = 0; i < count; ++i) {
+    unsigned char* point = bytes + i * r_layout.stride;
+    storeCoordinate(scratch[i].x(), r_layout.doubles[0],
+                    point + r_layout.offsets[0]);
+    storeCoordinate(scratch[i].y(), r_layout.doubles[1],
+                    point + r_layout.offsets[1]);
+    storeCoordinate(scratch[i].z(), r_layout.doubles[2],
+                    point + r_layout.offsets[2]);
+  }
+}
+
+}  // namespace
+
+CloudTransformStats transformCloud(const std::string& r_input,
+                                   const std::string& r_output,
+                                   const Isometry& r_isometry,
+                                   const std::size_t chunk_points) {
+  if (chunk_points == 0) {
+    throw std::invalid_argument("Point cloud chunks must not be empty");
+  }
+  File input{r_input, O_RDONLY};
+  const Layout layout{readLayout(&input)};
+  // Truncated only once it is known not to be the input.
+  File output{r_output, O_WRONLY | O_CREAT};
+  if (output.isSameFile(input)) {
+    throw std::invalid_argument("Point cloud input and output are the same");
+  }
+  output.truncate();
+  output.write(reinterpret_cast<const unsigned char*>(layout.header.data()),
+               layout.header.size());
+
+  Pipeline pipeline;
+  for (Chunk& r_chunk : pipeline.chunks) {
+    r_chunk.bytes.resize(chunk_points * layout.stride);
+  }
+  std::vector<Vector3> scratch(chunk_points);
+  CloudTransformStats stats{0, 0};
+  {
+    std::thread reader{readChunks, std::cref(layout), &input, &pipeline};
+    const ReaderGuard guard{&pipeline, &reader};
+    for (;;) {
+      {
+        std::unique_lock<std::mutex> lock{pipeline.mutex};
+        pipeline.changed.wait(lock, [&] {
+          return pipeline.produced > pipeline.consumed || pipeline.finished;
+        });
+        if (pipeline.produced == pipeline.consumed) {
+          if (pipeline.error) {
+            std::rethrow_exception(pipeline.error);
+          }
+          break;
+        }
+      }
+      Chunk& r_chunk = pipeline.chunks[pipeline.consumed % 2];
+      if (r_chunk.points) {
+        transformPoints(layout, r_isometry, &r_chunk, &scratch);
+        stats.points += r_chunk.size / layout.stride;
+      }
+      output.write(r_chunk.bytes.data(), r_chunk.size);
+      ++stats.chunks;
+      std::lock_guard<std::mutex> lock{pipeline.mutex};
+      ++pipeline.consumed;
+      pipeline.changed.notify_all();
+    }
+  }
+  output.close();
+  return stats;
+}
+
+}  // namespace math
+}  // namespace ekumen
@@ -0,0 +1,245 @@
+/*
+ * Pose channel library
+ * Author: Steven Desvars, 2020
+ * Copyright 2020 Ekumen
+ */
+
+#include <isometry/pose_channel.hpp>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <isometry/internal/file_io.hpp>
+#include <isometry/internal/seqlock.hpp>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include <system_error>
+
+namespace ekumen {
+namespace math {
+
+namespace internal {
+
+// Timestamp, translation and row-major rotation.
+const std::size_t kPoseChannelValues{13};
+
+// Layout of the shared memory, followed by the history slots. The magic
+// number is written last, once the rest is initialized.
+struct PoseChannelSegment {
+  std::atomic<std::uint64_t> magic;
+  std::uint64_t history;
+  std::atomic<std::uint64_t> published;
+  SeqLock<kPoseChannelValues> latest;
+};
+
+}  // namespace internal
+
+namespace {
+
+using Slot = internal::SeqLock<internal::kPoseChannelValues>;
+
+// "EKPC" and the layout version.
+const std::uint64_t kMagic{0x454b504300000001};
+
+// Reads that overlap this many publications in a row give up.
+const int kReadAttempts{64};
+
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2,
+              "Pose channels need lock-free 64-bit atomics");
+static_assert(sizeof(internal::PoseChannelSegment) % alignof(Slot) == 0,
+              "History slots would be misaligned");
+
+void checkName(const std::string& r_name) {
+  if (r_name.size() < 2 || r_name.size() > 255 || r_name[0] != '/' ||
+      r_name.find('/', 1) != std::string::npos) {
+    throw std::invalid_argument("Invalid pose channel name " + r_name);
+  }
+}
+
+std::size_t segmentSize(const std::size_t history) {
+  return sizeof(internal::PoseChannelSegment) + history * sizeof(Slot);
+}
+
+Slot* slots(internal::PoseChannelSegment* r_segment) {
+  return reinterpret_cast<Slot*>(r_segment + 1);
+}
+
+const Slot* slots(const internal::PoseChannelSegment* segment) {
+  return reinterpret_cast<const Slot*>(segment + 1);
+}
+
+// Reads a slot, giving up after kReadAttempts inconsistent copies.
+bool tryLoad(const Slot& r_slot, double* values, std::uint64_t* r_version) {
+  for (int attempt = 0; attempt < kReadAttempts; ++attempt) {
+    if (r_slot.tryLoad(values, r_version)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void unpack(const double* values, double* r_timestamp, Isometry* r_pose) {
+  *r_timestamp = values[0];
+  *r_pose = Isometry{Vector3(values[1], values[2], values[3]),
+                     Matrix3{values[4], values[5], values[6], values[7],
+                             values[8], values[9], values[10], values[11],
+                             values[12]}};
+}
+
+}  // namespace
+
+PoseChannelWriter::PoseChannelWriter(const std::string& r_name,
+                                     const std::size_t history)
+    : name_(r_name), segment_{nullptr}, size_{0}, published_{0} {
+  checkName(r_name);
+  if (history == 0 ||
+      history > (std::numeric_limits<std::size_t>::max() -
+                 sizeof(internal::PoseChannelSegment)) /
+                    sizeof(Slot)) {
+    throw std::invalid_argument("Invalid pose channel history size");
+  }
+  size_ = segmentSize(history);
+  ::shm_unlink(r_name.c_str());
+  const int fd = ::shm_open(r_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+  if (fd < 0) {
+    throw internal::systemError("Cannot create pose channel " + r_name);
+  }
+  void* memory = MAP_FAILED;
+  if (::ftruncate(fd, static_cast<off_t>(size_)) == 0) {
+    memory = ::mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd,
+                    0);
+  }
+  if (memory == MAP_FAILED) {
+    const std::system_error error{
+        internal::systemError("Cannot map pose channel " + r_name)};
+    ::close(fd);
+    ::shm_unlink(r_name.c_str());
+    throw error;
+  }
+  ::close(fd);
+  segment_ = new (memory) internal::PoseChannelSegment();
+  segment_->history = history;
+  for (std::size_t i = 0; i < history; ++i) {
+    new (slots(segment_) + i) Slot();
+  }
+  segment_->magic.store(kMagic, std::memory_order_release);
+}
+
+PoseChannelWriter::~PoseChannelWriter() {
+  ::munmap(segment_, size_);
+  ::shm_unlink(name_.c_str());
+}
+
+void PoseChannelWriter::publish(const double timestamp,
+                                const Isometry& r_pose) {
+  const Vector3& r_translation = r_pose.translation();
+  const Matrix3& r_rotation = r_pose.rotation();
+  const double values[internal::kPoseChannelValues]{
+      timestamp,         r_translation.x(),  r_translation.y(),
+      r_translation.z(), r_rotation[0][0],   r_rotation[0][1],
+      r_rotation[0][2],  r_rotation[1][0],   r_rotation[1][1],
+      r_rotation[1][2],  r_rotation[2][0],   r_rotation[2][1],
+      r_rotation[2][2]};
+  slots(segment_)[published_ % segment_->history].store(values);
+  segment_->latest.store(values);
+  ++published_;
+  segment_->published.store(published_, std::memory_order_release);
+}
+
+PoseChannelReader::PoseChannelReader(const std::string& r_name)
+    : segment_{nullptr}, size_{0}, history_{0} {
+  checkName(r_name);
+  const int fd = ::shm_open(r_name.c_str(), O_RDONLY, 0);
+  if (fd < 0) {
+    throw internal::systemError("Cannot open pose channel " + r_name);
+  }
+  struct stat status;
+  if (::fstat(fd, &status) != 0) {
+    const std::system_error error{
+        internal::systemError("Cannot stat " + r_name)};
+    ::close(fd);
+    throw error;
+  }
+  size_ = static_cast<std::size_t>(status.st_size);
+  if (size_ < sizeof(internal::PoseChannelSegment)) {
+    ::close(fd);
+    throw std::invalid_argument("Not a pose channel " + r_name);
+  }
+  void* memory = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+  if (memory == MAP_FAILED) {
+    const std::system_error error{
+        internal::systemError("Cannot map pose channel " + r_name)};
+    ::close(fd);
+    throw error;
+  }
+  ::close(fd);
+  segment_ = static_cast<const internal::PoseChannelSegment*>(memory);
+  if (segment_->magic.load(std::memory_order_acquire) != kMagic ||
+      segment_->history == 0 ||
+      segment_->history >
+          (size_ - sizeof(internal::PoseChannelSegment)) / sizeof(Slot) ||
+      segmentSize(segment_->history) != size_) {
+    ::munmap(memory, size_);
+    throw std::invalid_argument("Not a pose channel " + r_name);
+  }
+  history_ = segment_->history;
+}
+
+PoseChannelReader::~PoseChannelReader() {
+  ::munmap(const_cast<internal::PoseChannelSegment*>(segment_), size_);
+}
+
+std::uint64_t PoseChannelReader::published() const {
+  return segment_->published.load(std::memory_order_acquire);
+}
+
+bool PoseChannelReader::latest(double* r_timestamp, Isometry* r_pose) const {
+  double values[internal::kPoseChannelValues];
+  std::uint64_t version;
+  if (!tryLoad(segment_->latest, values, &version) || version == 0) {
+    return false;
+  }
+  unpack(values, r_timestamp, r_pose);
+  return true;
+}
+
+bool PoseChannelReader::at(const std::uint64_t index, double* r_timestamp,
+                           Isometry* r_pose) const {
+  // The slot of a pose has been stored once per lap of the ring, its own
+  // store included.
+  const Slot& r_slot = slots(segment_)[index % history_];
+  const std::uint64_t lap = index / history_ + 1;
+  double values[internal::kPoseChannelValues];
+  std::uint64_t version;
+  if (!tryLoad(r_slot, values, &version) || version != lap) {
+    return false;
+  }
+  unpack(values, r_timestamp, r_pose);
+  return true;
+}
+
+std::size_t PoseChannelReader::recent(const std::size_t count,
+                                      double* r_timestamps,
+                                      Isometry* r_poses) const {
+  const std::uint64_t end = published();
+  const std::uint64_t wanted = std::min<std::uint64_t>(
+      std::min<std::uint64_t>(count, history_), end);
+  std::size_t read = 0;
+  for (std::uint64_t index = end - wanted; index < end; ++index) {
+    if (at(index, r_timestamps + read, r_poses + read)) {
+      ++read;
+    } else {
+      // Older poses than a lost one would leave a gap.
+      read = 0;
+    }
+  }
+  return read;
+}
+
+}  // namespace math
+}  // namespace ekumen
@@ -0,0 +1,248 @@
+/*
+ * Pose logger library
+ * Author: Steven Desvars, 2020
+ * Copyright 2020 Ekumen
+ */
+
+#include <isometry/pose_logger.hpp>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <isometry/binary.hpp>
+#include <isometry/format.hpp>
+#include <isometry/internal/file_io.hpp>
+#include <isometry/internal/format_double.hpp>
+#include <stdexcept>
+
+namespace ekumen {
+namespace math {
+
+namespace {
+
+// Longest text record: timestamp, channel, pose and separators.
+const std::size_t kMaxTextRecordSize{internal::kShortestDoubleSize + 20 +
+                                     kFormatBufferSize + 3};
+
+static_assert(kPoseLogRecordSize == 14 * sizeof(double),
+              "Pose log record layout mismatch");
+
+// Idle writer thread polls this many times before it starts sleeping.
+const int kIdleSpins{64};
+const std::chrono::microseconds kIdleSleep{100};
+
+// Writes the decimal digits of value.
+// @returns Number of characters written.
+std::size_t formatUnsigned(std::uint64_t value, char* buffer) {
+  char digits[20];
+  std::size_t count = 0;
+  do {
+    digits[count++] = static_cast<char>('0' + value % 10);
+    value /= 10;
+  } while (value != 0);
+  for (std::size_t i = 0; i < count; ++i) {
+    buffer[i] = digits[count - 1 - i];
+  }
+  return count;
+}
+
+// Raises r_max to value if it is larger.
+void updateMax(std::atomic<std::uint64_t>* r_max, const std::uint64_t value) {
+  std::uint64_t current = r_max->load(std::memory_order_relaxed);
+  while (value > current &&
+         !r_max->compare_exchange_weak(current, value,
+                                       std::memory_order_relaxed)) {
+  }
+}
+
+// Waits a little, longer the longer the wait has lasted.
+void backOff(int* r_spins) {
+  if (*r_spins < kIdleSpins) {
+    ++*r_spins;
+    std::this_thread::yield();
+  } else {
+    std::this_thread::sleep_for(kIdleSleep);
+  }
+}
+
+}  // namespace
+
+PoseLogger::PoseLogger(const std::string& r_path,
+                       const PoseLoggerOptions& r_options)
+    : options_(r_options),
+      queue_{r_options.capacity},
+      batch_used_{0},
+      fd_{-1},
+      open_{false},
+      stopping_{false},
+      logged_{0},
+      dropped_{0},
+      evicted_{0},
+      written_{0},
+      max_enqueue_ns_{0},
+      failed_{false} {
+  if (options_.batch_size == 0) {
+    throw std::invalid_argument("Pose logger batch size must be positive");
+  }
+  batch_.resize(options_.batch_size *
+                (options_.format == PoseLogFormat::kText
+                     ? kMaxTextRecordSize
+                     : kPoseLogRecordSize));
+  fd_ = ::open(r_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+               0644);
+  if (fd_ < 0) {
+    throw internal::systemError("Cannot create " + r_path);
+  }
+  open_.store(true, std::memory_order_release);
+  try {
+    writer_ = std::thread(&PoseLogger::run, this);
+  } catch (...) {
+    ::close(fd_);
+    throw;
+  }
+}
+
+PoseLogger::~PoseLogger() {
+  try {
+    close();
+  } catch (...) {
+  }
+}
+
+bool PoseLogger::log(const double timestamp, const Isometry& r_pose,
+                     const std::uint64_t channel) {
+  if (!open_.load(std::memory_order_acquire)) {
+    return false;
+  }
+  // Nothing would write the record anymore.
+  if (failed_.load(std::memory_order_acquire)) {
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  const std::chrono::steady_clock::time_point start{
+      std::chrono::steady_clock::now()};
+  const Record record{timestamp, channel, r_pose};
+  bool queued = queue_.tryPush(record);
+  int spins = 0;
+  while (!queued) {
+    if (options_.overflow == PoseLogOverflow::kDropNewest ||
+        failed_.load(std::memory_order_acquire)) {
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      break;
+    }
+    if (options_.overflow == PoseLogOverflow::kDropOldest) {
+      Record oldest;
+      if (queue_.tryPop(&oldest)) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        evicted_.fetch_add(1, std::memory_order_release);
+      }
+    } else {
+      backOff(&spins);
+    }
+    queued = queue_.tryPush(record);
+  }
+  if (queued) {
+    logged_.fetch_add(1, std::memory_order_release);
+  }
+  updateMax(&max_enqueue_ns_,
+            static_cast<std::uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - start)
+                    .count()));
+  return queued;
+}
+
+void PoseLogger::flush() {
+  const std::uint64_t target = logged_.load(std::memory_order_acquire);
+  int spins = 0;
+  while (!failed_.load(std::memory_order_acquire) &&
+         written_.load(std::memory_order_acquire) +
+                 evicted_.load(std::memory_order_acquire) <
+             target) {
+    backOff(&spins);
+  }
+  if (failed_.load(std::memory_order_acquire)) {
+    std::rethrow_exception(error_);
+  }
+}
+
+void PoseLogger::close() {
+  if (!open_.exchange(false, std::memory_order_acq_rel)) {
+    return;
+  }
+  stopping_.store(true, std::memory_order_release);
+  writer_.join();
+  const int fd = fd_;
+  fd_ = -1;
+  if (failed_.load(std::memory_order_acquire)) {
+    ::close(fd);
+    std::rethrow_exception(error_);
+  }
+  if (::close(fd) != 0) {
+    throw internal::systemError("Cannot close pose log");
+  }
+}
+
+PoseLoggerStats PoseLogger::stats() const {
+  return PoseLoggerStats{logged_.load(std::memory_order_relaxed),
+                         dropped_.load(std::memory_order_relaxed),
+                         written_.load(std::memory_order_relaxed),
+                         max_enqueue_ns_.load(std::memory_order_relaxed)};
+}
+
+void PoseLogger::run() {
+  try {
+    Record record;
+    int spins = 0;
+    for (;;) {
+      // Records queued before close() are visible once stopping_ is.
+      const bool stopping = stopping_.load(std::memory_order_acquire);
+      std::size_t batched = 0;
+      while (batched < options_.batch_size && queue_.tryPop(&record)) {
+        serialize(record);
+        ++batched;
+      }
+      if (batched > 0) {
+        writeBatch();
+        written_.fetch_add(batched, std::memory_order_release);
+        spins = 0;
+      } else if (stopping) {
+        return;
+      } else {
+        backOff(&spins);
+      }
+    }
+  } catch (...) {
+    error_ = std::current_exception();
+    failed_.store(true, std::memory_order_release);
+  }
+}
+
+void PoseLogger::serialize(const Record& r_record) {
+  char* out = batch_.data() + batch_used_;
+  if (options_.format == PoseLogFormat::kBinary) {
+    unsigned char* bytes = reinterpret_cast<unsigned char*>(out);
+    internal::storeDoubles(&r_record.timestamp, 1, bytes);
+    internal::storeInteger(r_record.channel, 8, bytes + sizeof(double));
+    internal::store(r_record.pose, bytes + 2 * sizeof(double));
+    batch_used_ += kPoseLogRecordSize;
+    return;
+  }
+  std::size_t length = internal::formatShortest(r_record.timestamp, out);
+  out[length++] = ' ';
+  length += formatUnsigned(r_record.channel, out + length);
+  out[length++] = ' ';
+  length += format(r_record.pose, out + length, kFormatBufferSize,
+                   FormatMode::kRoundTrip);
+  out[length++] = '\n';
+  batch_used_ += length;
+}
+
+void PoseLogger::writeBatch() {
+  internal::writeAll(fd_, batch_.data(), batch_used_, "Cannot write pose log");
+  batch_used_ = 0;
+}
+
+}  // namespace math
+}  // namespace ekumen
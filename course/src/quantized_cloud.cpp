@@ -0,0 +1,219 @@
+/*
+ * Quantized point cloud library
+ * Author: Steven Desvars, 2020
+ * Copyright 2020 Ekumen
+ */
+
+#include <isometry/quantized_cloud.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace ekumen {
+namespace math {
+
+namespace {
+
+// Points per chunk of the stack buffer of transformed().
+const std::size_t kBatchChunk{64};
+
+void checkRange(const std::size_t first, const std::size_t count,
+                const std::size_t size) {
+  if (first > size || count > size - first) {
+    throw std::out_of_range("Quantized cloud range out of range");
+  }
+}
+
+}  // namespace
+
+template <class Integer>
+QuantizedCloud<Integer>::QuantizedCloud()
+    : block_points_{kDefaultQuantizedBlockPoints}, max_error_{0.} {}
+
+template <class Integer>
+QuantizedCloud<Integer>::QuantizedCloud(const Vector3* r_points,
+                                        const std::size_t count,
+                                        const std::size_t block_points)
+    : block_points_{block_points}, max_error_{0.} {
+  if (block_points == 0) {
+    throw std::invalid_argument("Quantized cloud blocks can't be empty");
+  }
+  values_.resize(3 * count);
+  blocks_.resize(count / block_points + (count % block_points != 0));
+  for (std::size_t b = 0; b < blocks_.size(); ++b) {
+    const std::size_t first = b * block_points;
+    const std::size_t size = std::min(block_points, count - first);
+    double low[3];
+    double high[3];
+    for (int k = 0; k < 3; ++k) {
+      low[k] = high[k] = r_points[first][k];
+    }
+    for (std::size_t i = 0; i < size; ++i) {
+      for (int k = 0; k < 3; ++k) {
+        const double value = r_points[first + i][k];
+        if (!std::isfinite(value)) {
+          throw std::invalid_argument("Quantized cloud point is not finite");
+        }
+        low[k] = std::min(low[k], value);
+        high[k] = std::max(high[k], value);
+      }
+    }
+    max_error_ =
+        std::max(max_error_, quantize(r_points + first, size, low, high,
+                                      values_.data() + 3 * first,
+                                      &blocks_[b]));
+  }
+}
+
+template <class Integer>
+std::size_t QuantizedCloud<Integer>::memory() const {
+  return values_.size() * sizeof(Integer) + blocks_.size() * sizeof(Block);
+}
+
+template <class Integer>
+Vector3 QuantizedCloud<Integer>::point(const std::size_t i) const {
+  Vector3 result;
+  decode(i, 1, &result);
+  return result;
+}
+
+template <class Integer>
+void QuantizedCloud<Integer>::decode(const std::size_t first,
+                                     const std::size_t count,
+                                     Vector3* r_out) const {
+  checkRange(first, count, size());
+  const std::size_t end = first + count;
+  std::size_t i = first;
+  while (i < end) {
+    const Block& r_block = blocks_[i / block_points_];
+    const std::size_t stop =
+        std::min(end, (i / block_points_ + 1) * block_points_);
+    for (; i < stop; ++i) {
+      const Integer* value = values_.data() + 3 * i;
+      r_out[i - first] =
+          Vector3(r_block.offset[0] + r_block.scale[0] * value[0],
+                  r_block.offset[1] + r_block.scale[1] * value[1],
+                  r_block.offset[2] + r_block.scale[2] * value[2]);
+    }
+  }
+}
+
+template <class Integer>
+void QuantizedCloud<Integer>::transform(const Isometry& r_isometry,
+                                        const std::size_t first,
+                                        const std::size_t count,
+                                        Vector3* r_out) const {
+  checkRange(first, count, size());
+  const Matrix3& r_rotation = r_isometry.rotation();
+  const Vector3& r_translation = r_isometry.translation();
+  const std::size_t end = first + count;
+  std::size_t i = first;
+  while (i < end) {
+    // R * (offset + scale * q) + t = (R * scale) * q + (R * offset + t).
+    const Block& r_block = blocks_[i / block_points_];
+    double matrix[9];
+    double shift[3];
+    for (int r = 0; r < 3; ++r) {
+      shift[r] = r_translation[r];
+      for (int c = 0; c < 3; ++c) {
+        matrix[3 * r + c] = r_rotation[r][c] * r_block.scale[c];
+        shift[r] += r_rotation[r][c] * r_block.offset[c];
+      }
+    }
+    const std::size_t stop =
+        std::min(end, (i / block_points_ + 1) * block_points_);
+    for (; i < stop; ++i) {
+      const Integer* value = values_.data() + 3 * i;
+      const double qx = value[0];
+      const double qy = value[1];
+      const double qz = value[2];
+      r_out[i - first] = Vector3(
+          matrix[0] * qx + matrix[1] * qy + matrix[2] * qz + shift[0],
+          matrix[3] * qx + matrix[4] * qy + matrix[5] * qz + shift[1],
+          matrix[6] * qx + matrix[7] * qy + matrix[8] * qz + shift[2]);
+    }
+  }
+}
+
+template <class Integer>
+QuantizedCloud<Integer> QuantizedCloud<Integer>::transformed(
+    const Isometry& r_isometry) const {
+  const double kLimit = std::numeric_limits<Integer>::max();
+  const Matrix3& r_rotation = r_isometry.rotation();
+  const Vector3& r_translation = r_isometry.translation();
+  QuantizedCloud result;
+  result.block_points_ = block_points_;
+  result.values_.resize(values_.size());
+  result.blocks_.resize(blocks_.size());
+  double requantization_error = 0.;
+  Vector3 chunk[kBatchChunk];
+  for (std::size_t b = 0; b < blocks_.size(); ++b) {
+    // The transformed box is centered on the transformed offset, its half
+    // extents are those of the old box through |R|.
+    const Block& r_block = blocks_[b];
+    double low[3];
+    double high[3];
+    for (int r = 0; r < 3; ++r) {
+      double center = r_translation[r];
+      double extent = 0.;
+      for (int c = 0; c < 3; ++c) {
+        center += r_rotation[r][c] * r_block.offset[c];
+        extent += std::abs(r_rotation[r][c]) * r_block.scale[c] * kLimit;
+      }
+      low[r] = center - extent;
+      high[r] = center + extent;
+    }
+    const std::size_t first = b * block_points_;
+    const std::size_t end = std::min(size(), first + block_points_);
+    for (std::size_t i = first; i < end; i += kBatchChunk) {
+      const std::size_t count = std::min(kBatchChunk, end - i);
+      transform(r_isometry, i, count, chunk);
+      requantization_error = std::max(
+          requantization_error,
+          quantize(chunk, count, low, high, result.values_.data() + 3 * i,
+                   &result.blocks_[b]));
+    }
+  }
+  result.max_error_ = max_error_ + requantization_error;
+  return result;
+}
+
+template <class Integer>
+double QuantizedCloud<Integer>::quantize(const Vector3* r_points,
+                                         const std::size_t count,
+                                         const double* low,
+                                         const double* high, Integer* r_out,
+                                         Block* r_block) {
+  const double kLimit = std::numeric_limits<Integer>::max();
+  double inverse[3];
+  double error = 0.;
+  double magnitude = 0.;
+  for (int k = 0; k < 3; ++k) {
+    // Halves first, so that huge opposite bounds don't overflow.
+    r_block->offset[k] = 0.5 * low[k] + 0.5 * high[k];
+    r_block->scale[k] = (0.5 * high[k] - 0.5 * low[k]) / kLimit;
+    inverse[k] = r_block->scale[k] > 0. ? 1. / r_block->scale[k] : 0.;
+    error += r_block->scale[k] * r_block->scale[k];
+    magnitude = std::max(
+        magnitude, std::max(std::abs(low[k]), std::abs(high[k])));
+  }
+  for (std::size_t i = 0; i < count; ++i) {
+    for (int k = 0; k < 3; ++k) {
+      const double value =
+          std::nearbyint((r_points[i][k] - r_block->offset[k]) * inverse[k]);
+      r_out[3 * i + k] =
+          static_cast<Integer>(std::max(-kLimit, std::min(kLimit, value)));
+    }
+  }
+  // Half a step per axis, plus the rounding of the decoding arithmetic.
+  return 0.5 * std::sqrt(error) +
+         8. * std::numeric_limits<double>::epsilon() * magnitude;
+}
+
+template class QuantizedCloud<std::int16_t>;
+template class QuantizedCloud<std::int32_t>;
+
+}  // namespace math
+}  // namespace ekumen
@@ -0,0 +1,51 @@
+/*
+ * Quaternion conversions
+ * Author: Steven Desvars, 2020
+ * Copyright 2020 Ekumen
+ */
+
+#include <cmath>
+#include <isometry/internal/quaternion.hpp>
+
+namespace ekumen {
+namespace math {
+namespace internal {
+
+void toQuaternion(const Matrix3& r_rotation, double* r_q) {
+  const Vector3 rows[]{r_rotation[0], r_rotation[1], r_rotation[2]};
+  const double trace = rows[0][0] + rows[1][1] + rows[2][2];
+  if (trace > 0.) {
+    const double s = 2. * std::sqrt(trace + 1.);
+    r_q[0] = s / 4.;
+    r_q[1] = (rows[2][1] - rows[1][2]) / s;
+    r_q[2] = (rows[0][2] - rows[2][0]) / s;
+    r_q[3] = (rows[1][0] - rows[0][1]) / s;
+  } else if (rows[0][0] > rows[1][1] && rows[0][0] > rows[2][2]) {
+    const double s = 2. * std::sqrt(1. + rows[0][0] - rows[1][1] - rows[2][2]);
+    r_q[0] = (rows[2][1] - rows[1][2]) / s;
+    r_q[1] = s / 4.;
+    r_q[2] = (rows[0][1] + rows[1][0]) / s;
+    r_q[3] = (rows[0][2] + rows[2][0]) / s;
+  } else if (rows[1][1] > rows[2][2]) {
+    const double s = 2. * std::sqrt(1. + rows[1][1] - rows[0][0] - rows[2][2]);
+    r_q[0] = (rows[0][2] - rows[2][0]) / s;
+    r_q[1] = (rows[0][1] + rows[1][0]) / s;
+    r_q[2] = s / 4.;
+    r_q[3] = (rows[1][2] + rows[2][1]) / s;
+  } else {
+    const double s = 2. * std::sqrt(1. + rows[2][2] - rows[0][0] - rows[1][1]);
+    r_q[0] = (rows[1][0] - rows[0][1]) / s;
+    r_q[1] = (rows[0][2] + rows[2][0]) / s;
+    r_q[2] = (rows[1][2] + rows[2][1]) / s;
+    r_q[3] = s / 4.;
+  }
+  const double norm = std::sqrt(r_q[0] * r_q[0] + r_q[1] * r_q[1] +
+                                r_q[2] * r_q[2] + r_q[3] * r_q[3]);
+  for (int i = 0; i < 4; ++i) {
+    r_q[i] /= norm;
+  }
+}
+
+}  // namespace internal
+}  // namespace math
+}  // namespace ekumen
@@ -0,0 +1,67 @@
+/*
+ * Rotation cache library
+ * Author: Steven Desvars, 2020
+ * Copyright 2020 Ekumen
+ */
+
+#include <isometry/rotation_cache.hpp>
+
+#include <cmath>
+#include <stdexcept>
+
+namespace ekumen {
+namespace math {
+
+const std::size_t RotationCache::kMaxEntries{1 << 20};
+
+RotationCache::RotationCache(const std::vector<Vector3>& axes,
+                             const std::size_t resolution)
+    : resolution_{resolution}, axis_count_{axes.size()} {
+  if (resolution_ == 0 || axis_count_ == 0) {
+    throw std::invalid_argument("Empty rotation cache");
+  }
+  if (resolution_ > kMaxEntries / axis_count_) {
+    throw std::length_error("Rotation cache exceeds its maximum size");
+  }
+  table_.reserve(axis_count_ * resolution_);
+  const double step = 2. * M_PI / static_cast<double>(resolution_);
+  for (const Vector3& axis : axes) {
+    for (std::size_t tick = 0; tick < resolution_; ++tick) {
+      table_.push_back(
+          Isometry::rotateAround(axis, step * static_cast<double>(tick))
+              .rotation());
+    }
+  }
+}
+
+std::size_t RotationCache::memoryFootprint() const {
+  return table_.capacity() * sizeof(Matrix3);
+}
+
+const Matrix3& RotationCache::rotation(const std::size_t axis,
+                                       const long tick) const {
+  if (axis >= axis_count_) {
+    throw std::out_of_range("Axis out of range");
+  }
+  const long resolution = static_cast<long>(resolution_);
+  long wrapped = tick % resolution;
+  if (wrapped < 0) {
+    wrapped += resolution;
+  }
+  return table_[axis * resolution_ + static_cast<std::size_t>(wrapped)];
+}
+
+Isometry RotationCache::rotateAround(const std::size_t axis,
+                                     const double& angle) const {
+  if (!std::isfinite(angle)) {
+    throw std::invalid_argument("Rotation cache angle is not finite");
+  }
+  const double steps =
+      std::round(angle * static_cast<double>(resolution_) / (2. * M_PI));
+  const long tick = static_cast<long>(
+      std::fmod(steps, static_cast<double>(resolution_)));
+  return Isometry{Vector3::kZero, rotation(axis, tick)};
+}
+
+}  // namespace math
+}  // namespace ekumen
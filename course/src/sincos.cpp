@@ -0,0 +1,145 @@
+/*
+ * Sine and cosine kernels
+ * Author: Steven Desvars, 2020
+ * Copyright 2020 Ekumen
+ */
+
+#include <isometry/internal/sincos.hpp>
+
+#include <cmath>
+#include <cstdint>
+
+namespace ekumen {
+namespace math {
+namespace internal {
+
+namespace {
+
+// Cody-Waite split of pi / 2. The leading part has enough trailing zero bits
+// for k * kPiOver2High to be exact while |k| < 2^20.
+const double kTwoOverPi{6.36619772367581382433e-01};
+const double kPiOver2High{1.57079632673412561417e+00};
+const double kPiOver2Mid{6.07710050630396597660e-11};
+const double kPiOver2Low{2.02226624879595063154e-21};
+// Adding and subtracting 1.5 * 2^52 rounds to the nearest integer.
+const double kRoundingShift{6755399441055744.0};
+// Largest |angle| handled by the reduction above; beyond it libm is used.
+const double kMaxReducedAngle{1.0e5};
+
+// Polynomial coefficients in z = r * r, for r in [-pi / 4, pi / 4]:
+//   sin(r) = r + r * z * S(z),  cos(r) = 1 - z / 2 + z * z * C(z).
+// The full tier uses the minimax coefficients of fdlibm, the others a
+// truncated Taylor series.
+struct FullCoefficients {
+  static constexpr int kSinTerms = 6;
+  static constexpr int kCosTerms = 6;
+  static const double kSin[kSinTerms];
+  static const double kCos[kCosTerms];
+};
+const double FullCoefficients::kSin[] = {
+    -1.66666666666666324348e-01, 8.33333333332248946124e-03,
+    -1.98412698298579493134e-04, 2.75573137070700676789e-06,
+    -2.50507602534068634195e-08, 1.58969099521155010221e-10};
+const double FullCoefficients::kCos[] = {
+    4.16666666666666019037e-02,  -1.38888888888741095749e-03,
+    2.48015872894767294178e-05,  -2.75573143513906633035e-07,
+    2.08757232129817482790e-09,  -1.13596475577881948265e-11};
+
+struct HighCoefficients {
+  static constexpr int kSinTerms = 5;
+  static constexpr int kCosTerms = 4;
+  static const double kSin[kSinTerms];
+  static const double kCos[kCosTerms];
+};
+const double HighCoefficients::kSin[] = {-1. / 6., 1. / 120., -1. / 5040.,
+                                         1. / 362880., -1. / 39916800.};
+const double HighCoefficients::kCos[] = {1. / 24., -1. / 720., 1. / 40320.,
+                                         -1. / 3628800.};
+
+struct FastCoefficients {
+  static constexpr int kSinTerms = 3;
+  static constexpr int kCosTerms = 3;
+  static const double kSin[kSinTerms];
+  static const double kCos[kCosTerms];
+};
+const double FastCoefficients::kSin[] = {-1. / 6., 1. / 120., -1. / 5040.};
+const double FastCoefficients::kCos[] = {1. / 24., -1. / 720., 1. / 40320.};
+
+template <int kTerms>
+inline double horner(const double* coefficients, const double z) {
+  double result = coefficients[kTerms - 1];
+  for (int i = kTerms - 2; i >= 0; --i) {
+    result = result * z + coefficients[i];
+  }
+  return result;
+}
+
+template <class Coefficients>
+inline void reduced_sincos(const double angle, double* sine,
+                           double* cosine) {
+  const double k = (angle * kTwoOverPi + kRoundingShift) - kRoundingShift;
+  const double r =
+      ((angle - k * kPiOver2High) - k * kPiOver2Mid) - k * kPiOver2Low;
+  const double z = r * r;
+  const double s = r + r * z * horner<Coefficients::kSinTerms>(
+                                   Coefficients::kSin, z);
+  // Computing 1 - z / 2 in two steps keeps the rounding error of the
+  // leading terms out of the result.
+  const double half_z = 0.5 * z;
+  const double w = 1. - half_z;
+  const double c =
+      w + (((1. - w) - half_z) +
+           z * z * horner<Coefficients::kCosTerms>(Coefficients::kCos, z));
+  // Quadrant selection, written with selects instead of branches.
+  const std::int64_t quadrant = static_cast<std::int64_t>(k) & 3;
+  const double swapped_sine = (quadrant & 1) ? c : s;
+  const double swapped_cosine = (quadrant & 1) ? s : c;
+  *sine = (quadrant & 2) ? -swapped_sine : swapped_sine;
+  *cosine = ((quadrant + 1) & 2) ? -swapped_cosine : swapped_cosine;
+}
+
+template <class Coefficients>
+void batch_sincos(const double* angles, const std::size_t count,
+                  double* sines, double* cosines) {
+  bool needs_fallback = false;
+  for (std::size_t i = 0; i < count; ++i) {
+    const bool in_range = std::fabs(angles[i]) <= kMaxReducedAngle;
+    reduced_sincos<Coefficients>(in_range ? angles[i] : 0., &sines[i],
+                                 &cosines[i]);
+    needs_fallback |= !in_range;
+  }
+  if (needs_fallback) {
+    for (std::size_t i = 0; i < count; ++i) {
+      if (!(std::fabs(angles[i]) <= kMaxReducedAngle)) {
+        sines[i] = std::sin(angles[i]);
+        cosines[i] = std::cos(angles[i]);
+      }
+    }
+  }
+}
+
+}  // namespace
+
+void sincos(const double angle, double* sine, double* cosine,
+            const SinCosAccuracy accuracy) {
+  sincos(&angle, 1, sine, cosine, accuracy);
+}
+
+void sincos(const double* angles, const std::size_t count, double* sines,
+            double* cosines, const SinCosAccuracy accuracy) {
+  switch (accuracy) {
+    case SinCosAccuracy::kFull:
+      batch_sincos<FullCoefficients>(angles, count, sines, cosines);
+      break;
+    case SinCosAccuracy::kHigh:
+      batch_sincos<HighCoefficients>(angles, count, sines, cosines);
+      break;
+    case SinCosAccuracy::kFast:
+      batch_sincos<FastCoefficients>(angles, count, sines, cosines);
+      break;
+  }
+}
+
+}  // namespace internal
+}  // namespace math
+}  // namespace ekumen
@@ -0,0 +1,343 @@
+/*
+ * Trajectory codec library
+ * Author: Steven Desvars, 2020
+ * Copyright 2020 Ekumen
+ */
+
+#include <isometry/trajectory_codec.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <isometry/binary.hpp>
+#include <isometry/internal/quaternion.hpp>
+#include <stdexcept>
+
+namespace ekumen {
+namespace math {
+
+namespace {
+
+const unsigned char kMagic[]{'E', 'K', 'T', 'C'};
+const std::uint16_t kVersion{1};
+const std::uint8_t kHasTimestamps{1};
+
+// Header field offsets.
+const std::size_t kVersionOffset{4};
+const std::size_t kRotationBitsOffset{6};
+const std::size_t kFlagsOffset{7};
+const std::size_t kCountOffset{8};
+const std::size_t kTranslationResolutionOffset{16};
+const std::size_t kTimeResolutionOffset{24};
+const std::size_t kRotationBytesOffset{32};
+const std::size_t kTranslationBytesOffset{40};
+const std::size_t kTimeBytesOffset{48};
+
+const int kMinRotationBits{4};
+const int kMaxRotationBits{20};
+
+// Largest quantized magnitude, it keeps differences within 63 bits.
+// Differences are computed in unsigned arithmetic all the same, so that
+// sums of steps wrap around instead of overflowing.
+const double kMaxQuantized{4.611686018427387904e18};
+
+const double kSqrt2{1.4142135623730951};
+
+// Poses are decoded in fixed-size chunks on the stack.
+const std::size_t kBatchChunk{64};
+
+std::size_t rotationRecordSize(const int bits) {
+  return (2 + 3 * bits + 7) / 8;
+}
+
+// Quantized value in two's complement.
+std::uint64_t quantize(const double value, const double resolution) {
+  const double scaled = std::round(value / resolution);
+  if (!(std::fabs(scaled) < kMaxQuantized)) {
+    throw std::invalid_argument("Value not finite or too large to encode");
+  }
+  return static_cast<std::uint64_t>(static_cast<std::int64_t>(scaled));
+}
+
+// Signed value of a two's complement one.
+std::int64_t toSigned(const std::uint64_t value) {
+  return value >> 63 ? -static_cast<std::int64_t>(~value) - 1
+                     : static_cast<std::int64_t>(value);
+}
+
+// Appends a two's complement value, zigzag encoded so that small negative
+// values take few bytes too.
+void appendVarint(const std::uint64_t value,
+                  std::vector<std::uint8_t>* r_out) {
+  std::uint64_t zigzag = (value << 1) ^ (0 - (value >> 63));
+  while (zigzag >= 0x80) {
+    r_out->push_back(static_cast<std::uint8_t>(zigzag | 0x80));
+    zigzag >>= 7;
+  }
+  r_out->push_back(static_cast<std::uint8_t>(zigzag));
+}
+
+// Reads a value written by appendVarint().
+std::uint64_t readVarint(const std::uint8_t** r_cursor,
+                         const std::uint8_t* end) {
+  const std::uint8_t* cursor = *r_cursor;
+  // Single byte values, the common case, skip the loop.
+  if (cursor != end && *cursor < 0x80) {
+    const std::uint64_t zigzag = *cursor;
+    *r_cursor = cursor + 1;
+    return (zigzag >> 1) ^ (0 - (zigzag & 1));
+  }
+  std::uint64_t zigzag{0};
+  for (int shift = 0; shift < 64; shift += 7) {
+    if (cursor == end) {
+      throw std::invalid_argument("Truncated trajectory stream");
+    }
+    const std::uint8_t byte = *cursor++;
+    zigzag |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+    if (byte < 0x80) {
+      *r_cursor = cursor;
+      return (zigzag >> 1) ^ (0 - (zigzag & 1));
+    }
+  }
+  throw std::invalid_argument("Corrupt trajectory varint");
+}
+
+// Packs the index of the largest quaternion component in the two low bits
+// and the other three, scaled from [-1/sqrt(2), 1/sqrt(2)] to
+// [0, 2^bits - 1], above it. q and -q being the same rotation, the largest
+// component is made positive and not stored.
+std::uint64_t packRotation(const Matrix3& r_rotation, const int bits) {
+  double q[4];
+  internal::toQuaternion(r_rotation, q);
+  for (const double component : q) {
+    if (!std::isfinite(component)) {
+      throw std::invalid_argument("Rotation not finite");
+    }
+  }
+  int largest = 0;
+  for (int i = 1; i < 4; ++i) {
+    if (std::fabs(q[i]) > std::fabs(q[largest])) {
+      largest = i;
+    }
+  }
+  const double sign = q[largest] < 0. ? -1. : 1.;
+  const double levels = static_cast<double>((1 << bits) - 1);
+  std::uint64_t packed = static_cast<std::uint64_t>(largest);
+  int shift = 2;
+  for (int i = 0; i < 4; ++i) {
+    if (i == largest) {
+      continue;
+    }
+    const double scaled = (sign * q[i] * kSqrt2 + 1.) / 2.;
+    const double level =
+        std::round(std::min(std::max(scaled, 0.), 1.) * levels);
+    packed |= static_cast<std::uint64_t>(level) << shift;
+    shift += bits;
+  }
+  return packed;
+}
+
+// Unpacks a batch of rotations into quaternion components w, x, y, z. The
+// square roots of the largest components go in a separate loop, which the
+// compiler vectorizes.
+void unpackRotations(const std::uint64_t* packed, const std::size_t count,
+                     const int bits, double (*r_q)[kBatchChunk]) {
+  const std::uint64_t mask = (std::uint64_t{1} << bits) - 1;
+  const double scale = kSqrt2 / static_cast<double>(mask);
+  const double offset = 1. / kSqrt2;
+  double components[3][kBatchChunk];
+  double largest[kBatchChunk];
+  for (std::size_t i = 0; i < count; ++i) {
+    double squares{0.};
+    for (int j = 0; j < 3; ++j) {
+      const double component =
+          static_cast<double>((packed[i] >> (2 + j * bits)) & mask) * scale -
+          offset;
+      components[j][i] = component;
+      squares += component * component;
+    }
+    largest[i] = 1. - squares;
+  }
+  for (std::size_t i = 0; i < count; ++i) {
+    largest[i] = std::sqrt(std::max(largest[i], 0.));
+  }
+  for (std::size_t i = 0; i < count; ++i) {
+    const int index = static_cast<int>(packed[i] & 3);
+    int j = 0;
+    for (int k = 0; k < 4; ++k) {
+      r_q[k][i] = k == index ? largest[i] : components[j++][i];
+    }
+  }
+}
+
+void checkOptions(const TrajectoryCodecOptions& r_options) {
+  if (!(r_options.translation_resolution > 0.) ||
+      !std::isfinite(r_options.translation_resolution) ||
+      !(r_options.time_resolution > 0.) ||
+      !std::isfinite(r_options.time_resolution)) {
+    throw std::invalid_argument("Codec resolutions must be positive");
+  }
+  if (r_options.rotation_bits < kMinRotationBits ||
+      r_options.rotation_bits > kMaxRotationBits) {
+    throw std::invalid_argument("Codec rotation bits out of range");
+  }
+}
+
+}  // namespace
+
+std::vector<std::uint8_t> encodeTrajectory(
+    const Isometry* r_poses, const double* timestamps,
+    const std::size_t count, const TrajectoryCodecOptions& r_options) {
+  checkOptions(r_options);
+  const std::size_t record_size = rotationRecordSize(r_options.rotation_bits);
+  std::vector<std::uint8_t> rotations(count * record_size);
+  std::vector<std::uint8_t> translations;
+  std::vector<std::uint8_t> times;
+  translations.reserve(3 * count);
+  times.reserve(timestamps != nullptr ? count : 0);
+
+  std::uint64_t previous[3]{0, 0, 0};
+  std::uint64_t time{0};
+  std::uint64_t time_step{0};
+  for (std::size_t i = 0; i < count; ++i) {
+    internal::storeInteger(
+        packRotation(r_poses[i].rotation(), r_options.rotation_bits),
+        record_size, rotations.data() + i * record_size);
+    const Vector3 translation{r_poses[i].translation()};
+    for (int j = 0; j < 3; ++j) {
+      const std::uint64_t quantized =
+          quantize(translation[j], r_options.translation_resolution);
+      appendVarint(quantized - previous[j], &translations);
+      previous[j] = quantized;
+    }
+    if (timestamps != nullptr) {
+      const std::uint64_t quantized =
+          quantize(timestamps[i], r_options.time_resolution);
+      appendVarint(quantized - time - time_step, &times);
+      time_step = quantized - time;
+      time = quantized;
+    }
+  }
+
+  std::vector<std::uint8_t> out(kTrajectoryCodecHeaderSize);
+  std::memcpy(out.data(), kMagic, sizeof(kMagic));
+  internal::storeInteger(kVersion, 2, out.data() + kVersionOffset);
+  out[kRotationBitsOffset] = static_cast<std::uint8_t>(r_options.rotation_bits);
+  out[kFlagsOffset] = timestamps != nullptr ? kHasTimestamps : 0;
+  internal::storeInteger(count, 8, out.data() + kCountOffset);
+  internal::storeDoubles(&r_options.translation_resolution, 1,
+                         out.data() + kTranslationResolutionOffset);
+  internal::storeDoubles(&r_options.time_resolution, 1,
+                         out.data() + kTimeResolutionOffset);
+  internal::storeInteger(rotations.size(), 8,
+                         out.data() + kRotationBytesOffset);
+  internal::storeInteger(translations.size(), 8,
+                         out.data() + kTranslationBytesOffset);
+  internal::storeInteger(times.size(), 8, out.data() + kTimeBytesOffset);
+  out.insert(out.end(), rotations.begin(), rotations.end());
+  out.insert(out.end(), translations.begin(), translations.end());
+  out.insert(out.end(), times.begin(), times.end());
+  return out;
+}
+
+TrajectoryDecoder::TrajectoryDecoder(const void* data, const std::size_t size)
+    : decoded_{0}, translation_{0, 0, 0}, time_{0}, time_step_{0} {
+  const std::uint8_t* header = static_cast<const std::uint8_t*>(data);
+  if (size < kTrajectoryCodecHeaderSize ||
+      std::memcmp(header, kMagic, sizeof(kMagic)) != 0) {
+    throw std::invalid_argument("Not an encoded trajectory");
+  }
+  if (internal::loadInteger(header + kVersionOffset, 2) != kVersion) {
+    throw std::invalid_argument("Unsupported trajectory codec version");
+  }
+  rotation_bits_ = header[kRotationBitsOffset];
+  has_timestamps_ = (header[kFlagsOffset] & kHasTimestamps) != 0;
+  internal::loadDoubles(header + kTranslationResolutionOffset, 1,
+                        &translation_resolution_);
+  internal::loadDoubles(header + kTimeResolutionOffset, 1, &time_resolution_);
+  TrajectoryCodecOptions options;
+  options.translation_resolution = translation_resolution_;
+  options.rotation_bits = rotation_bits_;
+  options.time_resolution = time_resolution_;
+  checkOptions(options);
+  rotation_record_size_ = rotationRecordSize(rotation_bits_);
+
+  const std::uint64_t count = internal::loadInteger(header + kCountOffset, 8);
+  const std::uint64_t rotation_bytes =
+      internal::loadInteger(header + kRotationBytesOffset, 8);
+  const std::uint64_t translation_bytes =
+      internal::loadInteger(header + kTranslationBytesOffset, 8);
+  const std::uint64_t time_bytes =
+      internal::loadInteger(header + kTimeBytesOffset, 8);
+  const std::uint64_t available = size - kTrajectoryCodecHeaderSize;
+  if (count > available / rotation_record_size_ ||
+      rotation_bytes != count * rotation_record_size_ ||
+      translation_bytes > available - rotation_bytes ||
+      time_bytes != available - rotation_bytes - translation_bytes ||
+      (!has_timestamps_ && time_bytes != 0)) {
+    throw std::invalid_argument("Inconsistent encoded trajectory sizes");
+  }
+  size_ = static_cast<std::size_t>(count);
+  rotations_ = header + kTrajectoryCodecHeaderSize;
+  translations_ = rotations_ + rotation_bytes;
+  translations_end_ = translations_ + translation_bytes;
+  times_ = translations_end_;
+  times_end_ = times_ + time_bytes;
+  end_ = times_end_;
+}
+
+std::size_t TrajectoryDecoder::decode(const std::size_t count,
+                                      Isometry* r_poses,
+                                      double* r_timestamps) {
+  if (r_timestamps != nullptr && !has_timestamps_) {
+    throw std::logic_error("The trajectory has no timestamps");
+  }
+  const std::size_t batch = std::min(count, remaining());
+  const std::uint64_t mask =
+      rotation_record_size_ == 8
+          ? ~std::uint64_t{0}
+          : (std::uint64_t{1} << (8 * rotation_record_size_)) - 1;
+  const bool little_endian = internal::isLittleEndian();
+  std::uint64_t packed[kBatchChunk];
+  double q[4][kBatchChunk];
+  for (std::size_t begin = 0; begin < batch; begin += kBatchChunk) {
+    const std::size_t size = std::min(kBatchChunk, batch - begin);
+    for (std::size_t i = 0; i < size; ++i) {
+      // Whole words are loaded while they stay inside the buffer.
+      if (little_endian && end_ - rotations_ >= 8) {
+        std::memcpy(&packed[i], rotations_, sizeof(packed[i]));
+        packed[i] &= mask;
+      } else {
+        packed[i] = internal::loadInteger(rotations_, rotation_record_size_);
+      }
+      rotations_ += rotation_record_size_;
+    }
+    unpackRotations(packed, size, rotation_bits_, q);
+    for (std::size_t i = 0; i < size; ++i) {
+      for (int j = 0; j < 3; ++j) {
+        translation_[j] += readVarint(&translations_, translations_end_);
+      }
+      r_poses[begin + i] = Isometry{
+          Vector3(toSigned(translation_[0]) * translation_resolution_,
+                  toSigned(translation_[1]) * translation_resolution_,
+                  toSigned(translation_[2]) * translation_resolution_),
+          internal::fromQuaternion(q[0][i], q[1][i], q[2][i], q[3][i])};
+    }
+    if (!has_timestamps_) {
+      continue;
+    }
+    // Skipped timestamps still advance the stream.
+    for (std::size_t i = 0; i < size; ++i) {
+      time_step_ += readVarint(&times_, times_end_);
+      time_ += time_step_;
+      if (r_timestamps != nullptr) {
+        r_timestamps[begin + i] = toSigned(time_) * time_resolution_;
+      }
+    }
+  }
+  decoded_ += batch;
+  return batch;
+}
+
+}  // namespace math
+}  // namespace ekumen
@@ -0,0 +1,320 @@
+/*
+ * Trajectory file library
+ * Author: Steven Desvars, 2020
+ * Copyright 2020 Ekumen
+ */
+
+#include <isometry/trajectory_file.hpp>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <isometry/binary.hpp>
+#include <stdexcept>
+
+namespace ekumen {
+namespace math {
+
+namespace {
+
+const unsigned char kMagic[]{'E', 'K', 'T', 'R'};
+const std::uint16_t kVersion{1};
+
+// Header field offsets.
+const std::size_t kVersionOffset{4};
+const std::size_t kRecordSizeOffset{6};
+const std::size_t kStrideOffset{8};
+const std::size_t kCountOffset{16};
+const std::size_t kIndexOffsetOffset{24};
+const std::size_t kIndexCountOffset{32};
+
+std::size_t recordOffset(const std::size_t i) {
+  return kTrajectoryHeaderSize + i * kTrajectoryRecordSize;
+}
+
+std::size_t indexEntries(const std::size_t count, const std::size_t stride) {
+  return (count + stride - 1) / stride;
+}
+
+// Validates a header.
+// @returns Number of committed records.
+std::size_t checkHeader(const unsigned char* header, const std::size_t size,
+                        std::size_t* r_stride) {
+  if (std::memcmp(header, kMagic, sizeof(kMagic)) != 0) {
+    throw std::invalid_argument("Not a trajectory file");
+  }
+  if (internal::loadInteger(header + kVersionOffset, 2) != kVersion) {
+    throw std::invalid_argument("Unsupported trajectory file version");
+  }
+  if (internal::loadInteger(header + kRecordSizeOffset, 2) !=
+      kTrajectoryRecordSize) {
+    throw std::invalid_argument("Unexpected trajectory record size");
+  }
+  *r_stride = internal::loadInteger(header + kStrideOffset, 4);
+  if (*r_stride == 0) {
+    throw std::invalid_argument("Invalid trajectory index stride");
+  }
+  const std::uint64_t count = internal::loadInteger(header + kCountOffset, 8);
+  if (count > (size - kTrajectoryHeaderSize) / kTrajectoryRecordSize) {
+    throw std::invalid_argument("Truncated trajectory file");
+  }
+  return static_cast<std::size_t>(count);
+}
+
+double loadTimestamp(const unsigned char* bytes) {
+  double timestamp;
+  internal::loadDoubles(bytes, 1, &timestamp);
+  return timestamp;
+}
+
+}  // namespace
+
+const std::size_t TrajectoryWriter::kDefaultFlushInterval{1024};
+const std::size_t TrajectoryWriter::kDefaultIndexStride{1024};
+
+TrajectoryWriter::TrajectoryWriter(const std::string& r_path,
+                                   const std::size_t flush_interval,
+                                   const std::size_t index_stride)
+    : fd_{-1},
+      index_stride_{index_stride},
+      committed_{0},
+      pending_{0},
+      last_timestamp_{0.} {
+  if (flush_interval == 0 || index_stride == 0) {
+    throw std::invalid_argument("Trajectory intervals must be positive");
+  }
+  fd_ = ::open(r_path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+  if (fd_ < 0) {
+    throw internal::systemError("Cannot open " + r_path);
+  }
+  try {
+    struct stat status;
+    if (::fstat(fd_, &status) != 0) {
+      throw internal::systemError("Cannot stat " + r_path);
+    }
+    unsigned char header[kTrajectoryHeaderSize]{};
+    if (status.st_size == 0) {
+      std::memcpy(header, kMagic, sizeof(kMagic));
+      internal::storeInteger(kVersion, 2, header + kVersionOffset);
+      internal::storeInteger(kTrajectoryRecordSize, 2,
+                             header + kRecordSizeOffset);
+      internal::storeInteger(index_stride_, 4, header + kStrideOffset);
+      writeAll(header, sizeof(header), 0);
+      sync();
+    } else {
+      const std::size_t size = static_cast<std::size_t>(status.st_size);
+      if (size < kTrajectoryHeaderSize ||
+          ::pread(fd_, header, sizeof(header), 0) !=
+              static_cast<ssize_t>(sizeof(header))) {
+        throw std::invalid_argument("Truncated trajectory file");
+      }
+      committed_ = checkHeader(header, size, &index_stride_);
+      if (committed_ > 0) {
+        unsigned char timestamp[sizeof(double)];
+        if (::pread(fd_, timestamp, sizeof(timestamp),
+                    recordOffset(committed_ - 1)) !=
+            static_cast<ssize_t>(sizeof(timestamp))) {
+          throw internal::systemError("Cannot read " + r_path);
+        }
+        last_timestamp_ = loadTimestamp(timestamp);
+      }
+      // New records overwrite the index, invalidate it first.
+      if (internal::loadInteger(header + kIndexOffsetOffset, 8) != 0) {
+        unsigned char no_index[16]{};
+        writeAll(no_index, sizeof(no_index), kIndexOffsetOffset);
+        sync();
+      }
+    }
+  } catch (...) {
+    ::close(fd_);
+    throw;
+  }
+  buffer_.resize(flush_interval * kTrajectoryRecordSize);
+}
+
+TrajectoryWriter::~TrajectoryWriter() {
+  try {
+    close();
+  } catch (...) {
+    if (fd_ >= 0) {
+      ::close(fd_);
+    }
+  }
+}
+
+void TrajectoryWriter::append(const double timestamp,
+                              const Isometry& r_pose) {
+  if (fd_ < 0) {
+    throw std::logic_error("Trajectory writer is closed");
+  }
+  if (std::isnan(timestamp) || (size() > 0 && timestamp < last_timestamp_)) {
+    throw std::invalid_argument("Trajectory timestamps must not decrease");
+  }
+  // The automatic flush of a previous call failed, retry it before the
+  // buffer overflows.
+  if (pending_ * kTrajectoryRecordSize == buffer_.size()) {
+    flush();
+  }
+  unsigned char* record = buffer_.data() + pending_ * kTrajectoryRecordSize;
+  internal::storeDoubles(&timestamp, 1, record);
+  internal::store(r_pose, record + sizeof(double));
+  last_timestamp_ = timestamp;
+  ++pending_;
+  if (pending_ * kTrajectoryRecordSize == buffer_.size()) {
+    flush();
+  }
+}
+
+void TrajectoryWriter::flush() {
+  if (fd_ < 0 || pending_ == 0) {
+    return;
+  }
+  writeAll(buffer_.data(), pending_ * kTrajectoryRecordSize,
+           recordOffset(committed_));
+  sync();
+  unsigned char count[8];
+  internal::storeInteger(committed_ + pending_, 8, count);
+  writeAll(count, sizeof(count), kCountOffset);
+  sync();
+  committed_ += pending_;
+  pending_ = 0;
+}
+
+void TrajectoryWriter::close() {
+  if (fd_ < 0) {
+    return;
+  }
+  flush();
+  const std::size_t entries = indexEntries(committed_, index_stride_);
+  std::vector<unsigned char> index(entries * sizeof(double));
+  for (std::size_t i = 0; i < entries; ++i) {
+    if (::pread(fd_, index.data() + i * sizeof(double), sizeof(double),
+                recordOffset(i * index_stride_)) !=
+        static_cast<ssize_t>(sizeof(double))) {
+      throw internal::systemError("Cannot read trajectory records");
+    }
+  }
+  const std::size_t index_offset = recordOffset(committed_);
+  writeAll(index.data(), index.size(), index_offset);
+  sync();
+  unsigned char fields[16];
+  internal::storeInteger(index_offset, 8, fields);
+  internal::storeInteger(entries, 8, fields + 8);
+  writeAll(fields, sizeof(fields), kIndexOffsetOffset);
+  // Drops whatever an interrupted writer left past the index.
+  if (::ftruncate(fd_, index_offset + index.size()) != 0) {
+    throw internal::systemError("Cannot truncate trajectory file");
+  }
+  sync();
+  const int fd = fd_;
+  fd_ = -1;
+  if (::close(fd) != 0) {
+    throw internal::systemError("Cannot close trajectory file");
+  }
+}
+
+void TrajectoryWriter::writeAll(const unsigned char* bytes,
+                                const std::size_t size,
+                                const std::size_t offset) {
+  internal::writeAllAt(fd_, bytes, size, offset,
+                       "Cannot write trajectory file");
+}
+
+void TrajectoryWriter::sync() {
+  if (::fdatasync(fd_) != 0) {
+    throw internal::systemError("Cannot sync trajectory file");
+  }
+}
+
+TrajectoryReader::TrajectoryReader(const std::string& r_path)
+    : mapping_{r_path}, records_{nullptr}, size_{0}, index_stride_{0} {
+  const unsigned char* header = mapping_.data();
+  if (mapping_.size() < kTrajectoryHeaderSize) {
+    throw std::invalid_argument("Truncated trajectory file");
+  }
+  size_ = checkHeader(header, mapping_.size(), &index_stride_);
+  records_ = header + kTrajectoryHeaderSize;
+
+  const std::size_t entries = indexEntries(size_, index_stride_);
+  const std::uint64_t index_offset =
+      internal::loadInteger(header + kIndexOffsetOffset, 8);
+  index_.resize(entries);
+  if (index_offset == recordOffset(size_) &&
+      internal::loadInteger(header + kIndexCountOffset, 8) == entries &&
+      mapping_.size() - index_offset >= entries * sizeof(double)) {
+    internal::loadDoubles(header + index_offset, entries, index_.data());
+  } else {
+    // The writer did not get to close the file, sample the records.
+    for (std::size_t i = 0; i < entries; ++i) {
+      index_[i] = loadTimestamp(record(i * index_stride_));
+    }
+  }
+}
+
+double TrajectoryReader::timestamp(const std::size_t i) const {
+  if (i >= size_) {
+    throw std::out_of_range("Trajectory record out of range");
+  }
+  return loadTimestamp(record(i));
+}
+
+Isometry TrajectoryReader::pose(const std::size_t i) const {
+  if (i >= size_) {
+    throw std::out_of_range("Trajectory record out of range");
+  }
+  Isometry pose;
+  internal::load(record(i) + sizeof(double), &pose);
+  return pose;
+}
+
+std::size_t TrajectoryReader::seek(const double timestamp) const {
+  // The answer lies after the last index entry older than the time, and no
+  // later than the next one.
+  std::size_t low{0};
+  std::size_t high{index_.size()};
+  while (low < high) {
+    const std::size_t middle = low + (high - low) / 2;
+    if (index_[middle] < timestamp) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  high = std::min(low * index_stride_, size_);
+  low = low == 0 ? 0 : (low - 1) * index_stride_ + 1;
+  while (low < high) {
+    const std::size_t middle = low + (high - low) / 2;
+    if (loadTimestamp(record(middle)) < timestamp) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  return low;
+}
+
+Isometry TrajectoryReader::lookup(const double timestamp) const {
+  if (empty() || !(timestamp >= loadTimestamp(record(0)) &&
+                   timestamp <= loadTimestamp(record(size_ - 1)))) {
+    throw std::out_of_range("Time outside the recorded trajectory");
+  }
+  const std::size_t i = seek(timestamp);
+  const double after = loadTimestamp(record(i));
+  if (after == timestamp) {
+    return pose(i);
+  }
+  const double before = loadTimestamp(record(i - 1));
+  return Isometry::interpolate(pose(i - 1), pose(i),
+                               (timestamp - before) / (after - before));
+}
+
+const unsigned char* TrajectoryReader::record(const std::size_t i) const {
+  return records_ + i * kTrajectoryRecordSize;
+}
+
+}  // namespace math
+}  // namespace ekumen
@@ -0,0 +1,335 @@
+/*
+ * Text trajectory library
+ * Author: Steven Desvars, 2020
+ * Copyright 2020 Ekumen
+ */
+
+#include <isometry/trajectory_text.hpp>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <exception>
+#include <isometry/internal/file_io.hpp>
+#include <isometry/internal/format_double.hpp>
+#include <isometry/internal/parse_double.hpp>
+#include <isometry/internal/quaternion.hpp>
+#include <stdexcept>
+#include <thread>
+
+namespace ekumen {
+namespace math {
+
+namespace {
+
+// Automatic thread counts leave smaller pieces to a single thread.
+const std::size_t kMinBytesPerThread{1 << 20};
+const std::size_t kMinPosesPerThread{8192};
+
+// Longest line written: 13 numbers and their separators.
+const std::size_t kMaxLineSize{13 * (internal::kShortestDoubleSize + 1)};
+
+std::invalid_argument malformed(const std::size_t line) {
+  return std::invalid_argument("Malformed trajectory line " +
+                               std::to_string(line));
+}
+
+std::size_t threadCount(const std::size_t threads, const std::size_t work,
+                        const std::size_t min_work) {
+  if (threads > 0) {
+    return threads;
+  }
+  const std::size_t cores =
+      std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+  return std::max<std::size_t>(std::min(cores, work / min_work), 1);
+}
+
+// Runs task(k) for every k below count, on count threads including the
+// calling one, and rethrows the exception of the first task that failed.
+template <class Task>
+void runParallel(const std::size_t count, const Task& r_task) {
+  std::vector<std::exception_ptr> errors(count);
+  const auto guarded = [&r_task, &errors](const std::size_t k) {
+    try {
+      r_task(k);
+    } catch (...) {
+      errors[k] = std::current_exception();
+    }
+  };
+  std::vector<std::thread> threads;
+  try {
+    for (std::size_t k = 1; k < count; ++k) {
+      threads.emplace_back(guarded, k);
+    }
+  } catch (...) {
+    for (std::thread& r_thread : threads) {
+      r_thread.join();
+    }
+    throw;
+  }
+  guarded(0);
+  for (std::thread& r_thread : threads) {
+    r_thread.join();
+  }
+  for (const std::exception_ptr& r_error : errors) {
+    if (r_error) {
+      std::rethrow_exception(r_error);
+    }
+  }
+}
+
+// Whole lines of the file handled by a thread.
+struct Range {
+  const char* begin;
+  const char* end;
+  // Number of lines and of records in the range.
+  std::size_t lines;
+  std::size_t records;
+  // Number of the first line of the range, and index of its first record.
+  std::size_t first_line;
+  std::size_t first_record;
+};
+
+bool isSpace(const char character) {
+  return character == ' ' || character == '\t' || character == '\r';
+}
+
+const char* skipSpaces(const char* cursor, const char* end) {
+  while (cursor < end && isSpace(*cursor)) {
+    ++cursor;
+  }
+  return cursor;
+}
+
+// End of the line starting at begin, before its '\n' if any.
+const char* lineEnd(const char* begin, const char* end) {
+  const void* newline = std::memchr(begin, '\n', end - begin);
+  return newline != nullptr ? static_cast<const char*>(newline) : end;
+}
+
+bool isLetter(const char character) {
+  return (character >= 'a' && character <= 'z') ||
+         (character >= 'A' && character <= 'Z');
+}
+
+bool isRecord(const char* begin, const char* end,
+              const TrajectoryTextFormat format) {
+  begin = skipSpaces(begin, end);
+  return begin < end && *begin != '#' &&
+         (format != TrajectoryTextFormat::kCsv || !isLetter(*begin));
+}
+
+// Parses the record of a line.
+// @throws std::invalid_argument If the line is malformed.
+void parseLine(const char* begin, const char* end,
+               const TrajectoryTextFormat format, const std::size_t line,
+               double* r_timestamp, Isometry* r_pose) {
+  const char* cursor = skipSpaces(begin, end);
+  if (format == TrajectoryTextFormat::kKitti && isLetter(*cursor)) {
+    const char* label = cursor;
+    while (label < end && !isSpace(*label)) {
+      ++label;
+    }
+    if (label[-1] != ':') {
+      throw malformed(line);
+    }
+    cursor = label;
+  }
+  const int count = format == TrajectoryTextFormat::kKitti ? 12 : 8;
+  double values[12];
+  for (int i = 0; i < count; ++i) {
+    cursor = skipSpaces(cursor, end);
+    if (i > 0 && format == TrajectoryTextFormat::kCsv) {
+      if (cursor == end || *cursor != ',') {
+        throw malformed(line);
+      }
+      cursor = skipSpaces(cursor + 1, end);
+    }
+    cursor = internal::parseDouble(cursor, end, values + i);
+    if (cursor == nullptr) {
+      throw malformed(line);
+    }
+  }
+  if (skipSpaces(cursor, end) != end) {
+    throw malformed(line);
+  }
+  if (format == TrajectoryTextFormat::kKitti) {
+    *r_pose = Isometry{Vector3(values[3], values[7], values[11]),
+                       Matrix3{Vector3(values[0], values[1], values[2]),
+                               Vector3(values[4], values[5], values[6]),
+                               Vector3(values[8], values[9], values[10])}};
+    return;
+  }
+  const double norm =
+      std::sqrt(values[4] * values[4] + values[5] * values[5] +
+                values[6] * values[6] + values[7] * values[7]);
+  if (!(norm > 0.) || !std::isfinite(norm)) {
+    throw malformed(line);
+  }
+  *r_timestamp = values[0];
+  *r_pose = Isometry{Vector3(values[1], values[2], values[3]),
+                     internal::fromQuaternion(
+                         values[7] / norm, values[4] / norm,
+                         values[5] / norm, values[6] / norm)};
+}
+
+// Appends a number and a separator.
+char* appendNumber(const double value, const char separator, char* out) {
+  out += internal::formatShortest(value, out);
+  *out++ = separator;
+  return out;
+}
+
+char* formatLine(const TrajectoryTextFormat format, const double timestamp,
+                 const Isometry& r_pose, char* out) {
+  const Vector3& r_translation = r_pose.translation();
+  const Matrix3& r_rotation = r_pose.rotation();
+  if (format == TrajectoryTextFormat::kKitti) {
+    for (int i = 0; i < 3; ++i) {
+      for (int j = 0; j < 3; ++j) {
+        out = appendNumber(r_rotation[i][j], ' ', out);
+      }
+      out = appendNumber(r_translation[i], i < 2 ? ' ' : '\n', out);
+    }
+    return out;
+  }
+  const char separator = format == TrajectoryTextFormat::kCsv ? ',' : ' ';
+  double q[4];
+  internal::toQuaternion(r_rotation, q);
+  out = appendNumber(timestamp, separator, out);
+  for (int i = 0; i < 3; ++i) {
+    out = appendNumber(r_translation[i], separator, out);
+  }
+  out = appendNumber(q[1], separator, out);
+  out = appendNumber(q[2], separator, out);
+  out = appendNumber(q[3], separator, out);
+  return appendNumber(q[0], '\n', out);
+}
+
+}  // namespace
+
+TextTrajectory loadTrajectoryText(const std::string& r_path,
+                                  const TrajectoryTextFormat format,
+                                  const std::size_t threads) {
+  const internal::FileMapping mapping{r_path};
+  mapping.adviseSequential();
+  const char* data = reinterpret_cast<const char*>(mapping.data());
+  const char* data_end = data + mapping.size();
+
+  // Splits the file at the first line break past each even share.
+  const std::size_t count =
+      std::min(threadCount(threads, mapping.size(), kMinBytesPerThread),
+               std::max<std::size_t>(mapping.size(), 1));
+  std::vector<Range> ranges(count);
+  const char* begin = data;
+  for (std::size_t k = 0; k < count; ++k) {
+    const char* end = data + mapping.size() * (k + 1) / count;
+    if (end < begin) {
+      end = begin;
+    }
+    if (end < data_end) {
+      end = lineEnd(end, data_end);
+      end = end < data_end ? end + 1 : end;
+    }
+    ranges[k] = Range{begin, end, 0, 0, 0, 0};
+    begin = end;
+  }
+
+  runParallel(count, [&ranges, format](const std::size_t k) {
+    Range& r_range = ranges[k];
+    for (const char* line = r_range.begin; line < r_range.end;) {
+      const char* end = lineEnd(line, r_range.end);
+      r_range.records += isRecord(line, end, format) ? 1 : 0;
+      ++r_range.lines;
+      line = end + 1;
+    }
+  });
+  std::size_t lines = 1;
+  std::size_t records = 0;
+  for (Range& r_range : ranges) {
+    r_range.first_line = lines;
+    r_range.first_record = records;
+    lines += r_range.lines;
+    records += r_range.records;
+  }
+
+  TextTrajectory trajectory;
+  trajectory.poses.resize(records);
+  if (format != TrajectoryTextFormat::kKitti) {
+    trajectory.timestamps.resize(records);
+  }
+  double* timestamps = format != TrajectoryTextFormat::kKitti
+                           ? trajectory.timestamps.data()
+                           : nullptr;
+  Isometry* poses = trajectory.poses.data();
+  runParallel(count, [&ranges, format, timestamps,
+                      poses](const std::size_t k) {
+    const Range& r_range = ranges[k];
+    std::size_t line_number = r_range.first_line;
+    std::size_t record = r_range.first_record;
+    double unused;
+    for (const char* line = r_range.begin; line < r_range.end;
+         ++line_number) {
+      const char* end = lineEnd(line, r_range.end);
+      if (isRecord(line, end, format)) {
+        parseLine(line, end, format, line_number,
+                  timestamps != nullptr ? timestamps + record : &unused,
+                  poses + record);
+        ++record;
+      }
+      line = end + 1;
+    }
+  });
+  return trajectory;
+}
+
+void saveTrajectoryText(const std::string& r_path,
+                        const TrajectoryTextFormat format,
+                        const Isometry* r_poses, const double* timestamps,
+                        const std::size_t count, const std::size_t threads) {
+  if (format != TrajectoryTextFormat::kKitti && timestamps == nullptr &&
+      count > 0) {
+    throw std::invalid_argument("Trajectory format needs timestamps");
+  }
+  const std::size_t pieces = std::min(
+      threadCount(threads, count, kMinPosesPerThread),
+      std::max<std::size_t>(count, 1));
+  std::vector<std::vector<char>> texts(pieces);
+  runParallel(pieces, [&texts, format, r_poses, timestamps, count,
+                       pieces](const std::size_t k) {
+    const std::size_t first = count * k / pieces;
+    const std::size_t end = count * (k + 1) / pieces;
+    std::vector<char>& r_text = texts[k];
+    r_text.resize((end - first) * kMaxLineSize);
+    char* out = r_text.data();
+    for (std::size_t i = first; i < end; ++i) {
+      out = formatLine(format, timestamps != nullptr ? timestamps[i] : 0.,
+                       r_poses[i], out);
+    }
+    r_text.resize(static_cast<std::size_t>(out - r_text.data()));
+  });
+
+  const int fd =
+      ::open(r_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    throw internal::systemError("Cannot create " + r_path);
+  }
+  try {
+    for (const std::vector<char>& r_text : texts) {
+      internal::writeAll(fd, r_text.data(), r_text.size(),
+                         "Cannot write trajectory");
+    }
+  } catch (...) {
+    ::close(fd);
+    throw;
+  }
+  if (::close(fd) != 0) {
+    throw internal::systemError("Cannot close " + r_path);
+  }
+}
+
+}  // namespace math
+}  // namespace ekumen
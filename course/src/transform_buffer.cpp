@@ -0,0 +1,201 @@
+/*
+ * Transform buffer library
+ * Author: Steven Desvars, 2020
+ * Copyright 2020 Ekumen
+ */
+
+#include <algorithm>
+#include <isometry/transform_buffer.hpp>
+#include <numeric>
+
+namespace ekumen {
+namespace math {
+
+namespace {
+
+// Batch lookups interpolate in fixed-size chunks on the stack.
+const std::size_t kBatchChunk{64};
+
+}  // namespace
+
+TransformBuffer::TransformBuffer(const std::size_t capacity,
+                                 const double max_extrapolation)
+    : samples_(capacity),
+      max_extrapolation_{max_extrapolation},
+      oldest_{0},
+      size_{0} {
+  if (capacity == 0) {
+    throw std::invalid_argument("Empty transform buffer");
+  }
+  if (!(max_extrapolation >= 0.)) {
+    throw std::invalid_argument("Negative extrapolation horizon");
+  }
+}
+
+void TransformBuffer::insert(const double timestamp,
+                             const Isometry& r_transform) {
+  if (size_ > 0) {
+    const double newest = newestTime();
+    if (timestamp < newest) {
+      throw std::invalid_argument("Transform older than the newest sample");
+    }
+    if (timestamp == newest) {
+      samples_[(oldest_ + size_ - 1) % samples_.size()].transform =
+          r_transform;
+      return;
+    }
+  }
+  if (size_ < samples_.size()) {
+    samples_[(oldest_ + size_) % samples_.size()] =
+        Sample{timestamp, r_transform};
+    ++size_;
+  } else {
+    samples_[oldest_] = Sample{timestamp, r_transform};
+    oldest_ = (oldest_ + 1) % samples_.size();
+  }
+}
+
+void TransformBuffer::clear() {
+  oldest_ = 0;
+  size_ = 0;
+}
+
+double TransformBuffer::oldestTime() const { return at(0).timestamp; }
+
+double TransformBuffer::newestTime() const {
+  return at(size_ - 1).timestamp;
+}
+
+double TransformBuffer::timestamp(const std::size_t i) const {
+  return at(i).timestamp;
+}
+
+const Isometry& TransformBuffer::transform(const std::size_t i) const {
+  return at(i).transform;
+}
+
+Isometry TransformBuffer::lookup(const double timestamp) const {
+  if (size_ == 0) {
+    throw std::out_of_range("Empty transform buffer");
+  }
+  const double oldest = oldestTime();
+  const double newest = newestTime();
+  if (!(timestamp >= oldest - max_extrapolation_ &&
+        timestamp <= newest + max_extrapolation_)) {
+    throw std::out_of_range("Time outside of the transform buffer");
+  }
+  if (size_ == 1) {
+    return at(0).transform;
+  }
+  if (timestamp <= oldest) {
+    return interpolate(1, timestamp);
+  }
+  if (timestamp >= newest) {
+    return interpolate(size_ - 1, timestamp);
+  }
+  // First sample not older than the query time.
+  std::size_t low = 1;
+  std::size_t high = size_ - 1;
+  while (low < high) {
+    const std::size_t middle = low + (high - low) / 2;
+    if (at(middle).timestamp < timestamp) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  return interpolate(low, timestamp);
+}
+
+void TransformBuffer::lookup(const double* timestamps,
+                             const std::size_t count, Isometry* r_out,
+                             const SinCosAccuracy accuracy) const {
+  if (std::is_sorted(timestamps, timestamps + count)) {
+    lookupInOrder(timestamps, nullptr, count, r_out, accuracy);
+    return;
+  }
+  std::vector<std::size_t> order(count);
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(),
+            [timestamps](const std::size_t a, const std::size_t b) {
+              return timestamps[a] < timestamps[b];
+            });
+  lookupInOrder(timestamps, order.data(), count, r_out, accuracy);
+}
+
+const TransformBuffer::Sample& TransformBuffer::at(
+    const std::size_t i) const {
+  if (i >= size_) {
+    throw std::out_of_range("Sample out of range");
+  }
+  return samples_[(oldest_ + i) % samples_.size()];
+}
+
+Isometry TransformBuffer::interpolate(const std::size_t i,
+                                      const double timestamp) const {
+  const Sample& before = at(i - 1);
+  const Sample& after = at(i);
+  if (timestamp == after.timestamp) {
+    return after.transform;
+  }
+  const double fraction = (timestamp - before.timestamp) /
+                          (after.timestamp - before.timestamp);
+  return Isometry::interpolate(before.transform, after.transform, fraction);
+}
+
+void TransformBuffer::lookupInOrder(const double* timestamps,
+                                    const std::size_t* order,
+                                    const std::size_t count, Isometry* r_out,
+                                    const SinCosAccuracy accuracy) const {
+  if (size_ == 0) {
+    throw std::out_of_range("Empty transform buffer");
+  }
+  const double lowest = oldestTime() - max_extrapolation_;
+  const double highest = newestTime() + max_extrapolation_;
+  for (std::size_t k = 0; k < count; ++k) {
+    if (!(timestamps[k] >= lowest && timestamps[k] <= highest)) {
+      throw std::out_of_range("Time outside of the transform buffer");
+    }
+  }
+  if (size_ == 1) {
+    std::fill(r_out, r_out + count, at(0).transform);
+    return;
+  }
+  double fractions[kBatchChunk];
+  Isometry interpolated[kBatchChunk];
+  std::size_t segment = 1;
+  std::size_t k = 0;
+  while (k < count) {
+    // The cursor only moves forward, to the first sample not older than
+    // the next query time.
+    const double first = timestamps[order ? order[k] : k];
+    while (segment < size_ - 1 && at(segment).timestamp < first) {
+      ++segment;
+    }
+    const Sample& before = at(segment - 1);
+    const Sample& after = at(segment);
+    const double span = after.timestamp - before.timestamp;
+    // Every query up to the end of the segment goes in one batch, the
+    // last segment also takes the ones extrapolated past the newest sample.
+    std::size_t size = 0;
+    while (k + size < count && size < kBatchChunk) {
+      const double timestamp = timestamps[order ? order[k + size] : k + size];
+      if (segment < size_ - 1 && timestamp > after.timestamp) {
+        break;
+      }
+      fractions[size] = (timestamp - before.timestamp) / span;
+      ++size;
+    }
+    Isometry::interpolate(before.transform, after.transform, fractions, size,
+                          interpolated, accuracy);
+    for (std::size_t i = 0; i < size; ++i) {
+      const std::size_t index = order ? order[k + i] : k + i;
+      r_out[index] = timestamps[index] == after.timestamp ? after.transform
+                                                          : interpolated[i];
+    }
+    k += size;
+  }
+}
+
+}  // namespace math
+}  // namespace ekumen
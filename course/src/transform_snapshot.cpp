@@ -0,0 +1,300 @@
+/*
+ * Transform snapshot library
+ * Author: Steven Desvars, 2020
+ * Copyright 2020 Ekumen
+ */
+
+#include <isometry/transform_snapshot.hpp>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <isometry/binary.hpp>
+#include <isometry/internal/file_io.hpp>
+#include <limits>
+#include <stdexcept>
+#include <system_error>
+#include <unordered_set>
+
+namespace ekumen {
+namespace math {
+
+namespace {
+
+const unsigned char kMagic[]{'E', 'K', 'S', 'N'};
+const std::uint16_t kVersion{1};
+
+// Header field offsets.
+const std::size_t kVersionOffset{4};
+const std::size_t kFrameCountOffset{8};
+const std::size_t kBufferCountOffset{16};
+const std::size_t kSampleCountOffset{24};
+const std::size_t kStringsSizeOffset{32};
+const std::size_t kChecksumOffset{40};
+
+// Record layouts. A frame is its parent, its name and the transform to
+// the parent; a buffer its name, capacity, extrapolation horizon and the
+// range of its samples; a sample a timestamp and a transform.
+const std::size_t kIsometrySize{12 * sizeof(double)};
+const std::size_t kFrameRecordSize{16 + kIsometrySize};
+const std::size_t kBufferRecordSize{40};
+const std::size_t kSampleRecordSize{sizeof(double) + kIsometrySize};
+
+// 64-bit FNV-1a over 8-byte words, then over the trailing bytes.
+std::uint64_t checksum(const unsigned char* bytes, const std::size_t size) {
+  const std::uint64_t kPrime{1099511628211ull};
+  std::uint64_t hash{14695981039346656037ull};
+  std::size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    std::uint64_t word;
+    std::memcpy(&word, bytes + i, sizeof(word));
+    if (!internal::isLittleEndian()) {
+      word = internal::loadInteger(bytes + i, 8);
+    }
+    hash = (hash ^ word) * kPrime;
+  }
+  for (; i < size; ++i) {
+    hash = (hash ^ bytes[i]) * kPrime;
+  }
+  return hash;
+}
+
+// Appends a name to the string table.
+void storeName(const std::string& r_name, std::vector<unsigned char>* r_strings,
+               unsigned char* r_out) {
+  if (r_strings->size() + r_name.size() >
+      std::numeric_limits<std::uint32_t>::max()) {
+    throw std::length_error("Too many names for a transform snapshot");
+  }
+  internal::storeInteger(r_strings->size(), 4, r_out);
+  internal::storeInteger(r_name.size(), 4, r_out + 4);
+  r_strings->insert(r_strings->end(), r_name.begin(), r_name.end());
+}
+
+// Reads a name of the string table.
+// @throws std::invalid_argument If the name is out of the table.
+std::string loadName(const unsigned char* record, const char* strings,
+                     const std::size_t strings_size) {
+  const std::uint64_t offset = internal::loadInteger(record, 4);
+  const std::uint64_t length = internal::loadInteger(record + 4, 4);
+  if (offset > strings_size || length > strings_size - offset) {
+    throw std::invalid_argument("Snapshot name out of range");
+  }
+  return std::string(strings + offset, length);
+}
+
+}  // namespace
+
+void saveTransformSnapshot(const std::string& r_path, const FrameTree& r_tree,
+                           const std::vector<SnapshotBuffer>& r_buffers) {
+  std::size_t sample_count = 0;
+  for (const SnapshotBuffer& r_buffer : r_buffers) {
+    if (r_buffer.buffer == nullptr) {
+      throw std::invalid_argument("Null buffer in a transform snapshot");
+    }
+    if (r_buffer.buffer->capacity() > kMaxSnapshotBufferCapacity) {
+      throw std::invalid_argument("Buffer too large for a transform snapshot");
+    }
+    sample_count += r_buffer.buffer->size();
+  }
+  std::vector<unsigned char> bytes(
+      kTransformSnapshotHeaderSize + r_tree.size() * kFrameRecordSize +
+      r_buffers.size() * kBufferRecordSize + sample_count * kSampleRecordSize);
+  std::vector<unsigned char> strings;
+
+  unsigned char* out = bytes.data() + kTransformSnapshotHeaderSize;
+  for (std::size_t i = 0; i < r_tree.size(); ++i) {
+    const FrameId frame{i};
+    internal::storeInteger(
+        frame == r_tree.root() ? 0 : r_tree.parent(frame).index(), 8, out);
+    storeName(r_tree.name(frame), &strings, out + 8);
+    internal::store(r_tree.transform(frame), out + 16);
+    out += kFrameRecordSize;
+  }
+  std::size_t first_sample = 0;
+  for (const SnapshotBuffer& r_buffer : r_buffers) {
+    const TransformBuffer& r_samples = *r_buffer.buffer;
+    storeName(r_buffer.name, &strings, out);
+    internal::storeInteger(r_samples.capacity(), 8, out + 8);
+    internal::storeInteger(first_sample, 8, out + 16);
+    internal::storeInteger(r_samples.size(), 8, out + 24);
+    const double max_extrapolation = r_samples.maxExtrapolation();
+    internal::storeDoubles(&max_extrapolation, 1, out + 32);
+    first_sample += r_samples.size();
+    out += kBufferRecordSize;
+  }
+  for (const SnapshotBuffer& r_buffer : r_buffers) {
+    const TransformBuffer& r_samples = *r_buffer.buffer;
+    for (std::size_t i = 0; i < r_samples.size(); ++i) {
+      const double timestamp = r_samples.timestamp(i);
+      internal::storeDoubles(&timestamp, 1, out);
+      internal::store(r_samples.transform(i), out + sizeof(double));
+      out += kSampleRecordSize;
+    }
+  }
+  bytes.insert(bytes.end(), strings.begin(), strings.end());
+
+  unsigned char* header = bytes.data();
+  std::memcpy(header, kMagic, sizeof(kMagic));
+  internal::storeInteger(kVersion, 2, header + kVersionOffset);
+  internal::storeInteger(r_tree.size(), 8, header + kFrameCountOffset);
+  internal::storeInteger(r_buffers.size(), 8, header + kBufferCountOffset);
+  internal::storeInteger(sample_count, 8, header + kSampleCountOffset);
+  internal::storeInteger(strings.size(), 8, header + kStringsSizeOffset);
+  internal::storeInteger(
+      checksum(header + kTransformSnapshotHeaderSize,
+               bytes.size() - kTransformSnapshotHeaderSize),
+      8, header + kChecksumOffset);
+
+  const std::string temporary{r_path + ".tmp"};
+  const int fd = ::open(temporary.c_str(),
+                        O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    throw internal::systemError("Cannot create " + temporary);
+  }
+  try {
+    internal::writeAll(fd, bytes.data(), bytes.size(),
+                       "Cannot write transform snapshot");
+    if (::fsync(fd) != 0) {
+      throw internal::systemError("Cannot sync " + temporary);
+    }
+  } catch (...) {
+    ::close(fd);
+    std::remove(temporary.c_str());
+    throw;
+  }
+  if (::close(fd) != 0 || ::rename(temporary.c_str(), r_path.c_str()) != 0) {
+    const std::system_error error{
+        internal::systemError("Cannot replace " + r_path)};
+    std::remove(temporary.c_str());
+    throw error;
+  }
+}
+
+TransformSnapshot loadTransformSnapshot(const std::string& r_path) {
+  const internal::FileMapping mapping{r_path};
+  const unsigned char* header = mapping.data();
+  const std::size_t size = mapping.size();
+  if (size < kTransformSnapshotHeaderSize) {
+    throw std::invalid_argument("Truncated transform snapshot");
+  }
+  if (std::memcmp(header, kMagic, sizeof(kMagic)) != 0) {
+    throw std::invalid_argument("Not a transform snapshot");
+  }
+  if (internal::loadInteger(header + kVersionOffset, 2) != kVersion) {
+    throw std::invalid_argument("Unsupported transform snapshot version");
+  }
+  // Counts are checked one at a time against what is left of the file, so
+  // the sizes below cannot overflow.
+  std::size_t left = size - kTransformSnapshotHeaderSize;
+  const std::uint64_t frame_count =
+      internal::loadInteger(header + kFrameCountOffset, 8);
+  const std::uint64_t buffer_count =
+      internal::loadInteger(header + kBufferCountOffset, 8);
+  const std::uint64_t sample_count =
+      internal::loadInteger(header + kSampleCountOffset, 8);
+  const std::uint64_t strings_size =
+      internal::loadInteger(header + kStringsSizeOffset, 8);
+  if (frame_count == 0 || frame_count > left / kFrameRecordSize) {
+    throw std::invalid_argument("Truncated transform snapshot");
+  }
+  left -= frame_count * kFrameRecordSize;
+  if (buffer_count > left / kBufferRecordSize) {
+    throw std::invalid_argument("Truncated transform snapshot");
+  }
+  left -= buffer_count * kBufferRecordSize;
+  if (sample_count > left / kSampleRecordSize) {
+    throw std::invalid_argument("Truncated transform snapshot");
+  }
+  left -= sample_count * kSampleRecordSize;
+  if (strings_size != left) {
+    throw std::invalid_argument("Transform snapshot size mismatch");
+  }
+  if (checksum(header + kTransformSnapshotHeaderSize,
+               size - kTransformSnapshotHeaderSize) !=
+      internal::loadInteger(header + kChecksumOffset, 8)) {
+    throw std::invalid_argument("Transform snapshot checksum mismatch");
+  }
+
+  const unsigned char* frames = header + kTransformSnapshotHeaderSize;
+  const unsigned char* buffers = frames + frame_count * kFrameRecordSize;
+  const unsigned char* samples = buffers + buffer_count * kBufferRecordSize;
+  const char* strings = reinterpret_cast<const char*>(
+      samples + sample_count * kSampleRecordSize);
+
+  // Parents come before their children, and names are unique.
+  std::unordered_set<std::string> names;
+  for (std::uint64_t i = 0; i < frame_count; ++i) {
+    const unsigned char* record = frames + i * kFrameRecordSize;
+    const std::uint64_t parent = internal::loadInteger(record, 8);
+    if ((i == 0 && parent != 0) || (i > 0 && parent >= i)) {
+      throw std::invalid_argument("Invalid frame parent in snapshot");
+    }
+    if (!names.insert(loadName(record + 8, strings, strings_size)).second) {
+      throw std::invalid_argument("Duplicate frame name in snapshot");
+    }
+  }
+  // Buffers hold increasing timestamps, no more than fit.
+  for (std::uint64_t i = 0; i < buffer_count; ++i) {
+    const unsigned char* record = buffers + i * kBufferRecordSize;
+    loadName(record, strings, strings_size);
+    const std::uint64_t capacity = internal::loadInteger(record + 8, 8);
+    const std::uint64_t first = internal::loadInteger(record + 16, 8);
+    const std::uint64_t count = internal::loadInteger(record + 24, 8);
+    double max_extrapolation;
+    internal::loadDoubles(record + 32, 1, &max_extrapolation);
+    if (capacity == 0 || capacity > kMaxSnapshotBufferCapacity ||
+        count > capacity || first > sample_count ||
+        count > sample_count - first || !(max_extrapolation >= 0.)) {
+      throw std::invalid_argument("Invalid buffer in snapshot");
+    }
+    double previous = -std::numeric_limits<double>::infinity();
+    for (std::uint64_t j = first; j < first + count; ++j) {
+      double timestamp;
+      internal::loadDoubles(samples + j * kSampleRecordSize, 1, &timestamp);
+      if (!(timestamp > previous)) {
+        throw std::invalid_argument("Unordered buffer samples in snapshot");
+      }
+      previous = timestamp;
+    }
+  }
+
+  TransformSnapshot snapshot{
+      FrameTree(loadName(frames + 8, strings, strings_size)),
+      std::vector<std::string>(), std::vector<TransformBuffer>()};
+  Isometry transform;
+  for (std::uint64_t i = 1; i < frame_count; ++i) {
+    const unsigned char* record = frames + i * kFrameRecordSize;
+    internal::load(record + 16, &transform);
+    snapshot.tree.addFrame(
+        loadName(record + 8, strings, strings_size),
+        FrameId(static_cast<std::size_t>(internal::loadInteger(record, 8))),
+        transform);
+  }
+  snapshot.buffer_names.reserve(buffer_count);
+  snapshot.buffers.reserve(buffer_count);
+  for (std::uint64_t i = 0; i < buffer_count; ++i) {
+    const unsigned char* record = buffers + i * kBufferRecordSize;
+    double max_extrapolation;
+    internal::loadDoubles(record + 32, 1, &max_extrapolation);
+    snapshot.buffer_names.push_back(loadName(record, strings, strings_size));
+    snapshot.buffers.emplace_back(internal::loadInteger(record + 8, 8),
+                                  max_extrapolation);
+    const std::uint64_t first = internal::loadInteger(record + 16, 8);
+    const std::uint64_t count = internal::loadInteger(record + 24, 8);
+    for (std::uint64_t j = first; j < first + count; ++j) {
+      const unsigned char* sample = samples + j * kSampleRecordSize;
+      double timestamp;
+      internal::loadDoubles(sample, 1, &timestamp);
+      internal::load(sample + sizeof(double), &transform);
+      snapshot.buffers.back().insert(timestamp, transform);
+    }
+  }
+  return snapshot;
+}
+
+}  // namespace math
+}  // namespace ekumen
@@ -27,22 +27,6 @@ Vector3::Vector3(const std::initializer_list<double>& list) {
   z_ = *it;
 }
 
-double Vector3::operator[](const int i) const {
-  if ((i < 0) || (i > 2)) {
-    throw std::out_of_range("Operator out of range");
-  }
-  switch (i) {
-    case 0:
-      return x_;
-    case 1:
-      return y_;
-    case 2:
-      return z_;
-    default:
-      throw std::out_of_range("Operator out of range");
-  }
-}
-
 double& Vector3::operator[](const int i) {
   if ((i < 0) || (i > 2)) {
     throw std::out_of_range("Operator out of range");
@@ -0,0 +1,98 @@
+/* Copyright 2020, Ekumen
+ * Atomic isometry library tests
+ * Author: Steven Desvars, 2020
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <isometry/atomic_isometry.hpp>
+#include "gtest/gtest.h"
+
+namespace ekumen {
+namespace math {
+namespace test {
+namespace {
+
+// Every entry of the published isometries derives from the same counter, so
+// a torn read shows up as mismatching entries.
+Isometry counterIsometry(const double k) {
+  return Isometry{Vector3(k, k, k), Matrix3{k, k, k, k, k, k, k, k, k}};
+}
+
+GTEST_TEST(AtomicIsometryTest, AtomicIsometryFullTests) {
+  AtomicIsometry pose;
+  EXPECT_EQ(pose.load(), Isometry());
+  EXPECT_EQ(pose.version(), 0u);
+
+  const Isometry t1{Isometry::fromTranslation(Vector3(1., 2., 3.)) *
+                    Isometry::fromEulerAngles(0.1, 0.2, 0.3)};
+  pose.store(t1);
+  EXPECT_EQ(pose.load(), t1);
+  EXPECT_EQ(pose.version(), 1u);
+  EXPECT_EQ(AtomicIsometry(t1).load(), t1);
+  EXPECT_EQ(AtomicIsometry(t1).version(), 0u);
+
+  AtomicVector3 position;
+  EXPECT_EQ(position.load(), Vector3::kZero);
+  EXPECT_EQ(position.version(), 0u);
+  position.store(Vector3(4., 5., 6.));
+  EXPECT_EQ(position.load(), Vector3(4., 5., 6.));
+  EXPECT_EQ(AtomicVector3(Vector3::kUnitY).load(), Vector3::kUnitY);
+  EXPECT_EQ(AtomicVector3(Vector3::kUnitY).version(), 0u);
+  EXPECT_EQ(position.version(), 1u);
+}
+
+GTEST_TEST(AtomicIsometryTest, NoTornReads) {
+  const int kStores{200000};
+  AtomicIsometry pose{counterIsometry(0.)};
+  std::atomic<bool> done{false};
+  std::atomic<int> torn{0};
+  std::vector<std::thread> readers;
+  for (int i = 0; i < 3; ++i) {
+    readers.emplace_back([&]() {
+      double last = 0.;
+      do {
+        const Isometry value{pose.load()};
+        const double k = value.translation().x();
+        for (int row = 0; row < 3; ++row) {
+          if (value.translation()[row] != k) {
+            ++torn;
+          }
+          for (int col = 0; col < 3; ++col) {
+            if (value.rotation()[row][col] != k) {
+              ++torn;
+            }
+          }
+        }
+        // Values never go back in time.
+        if (k < last) {
+          ++torn;
+        }
+        last = k;
+      } while (!done.load());
+    });
+  }
+  for (int i = 1; i <= kStores; ++i) {
+    pose.store(counterIsometry(i));
+  }
+  done.store(true);
+  for (std::thread &reader : readers) {
+    reader.join();
+  }
+  EXPECT_EQ(torn.load(), 0);
+  EXPECT_EQ(pose.load(), counterIsometry(kStores));
+  EXPECT_EQ(pose.version(), static_cast<std::uint64_t>(kStores));
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace math
+}  // namespace ekumen
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,130 @@
+/* Copyright 2020, Ekumen
+ * Axis-aligned rotation library tests
+ * Author: Steven Desvars, 2020
+ */
+
+#include <cmath>
+#include <sstream>
+#include <string>
+
+#include <isometry/isometry.hpp>
+#include "gtest/gtest.h"
+#include "test_utils.hpp"
+
+namespace ekumen {
+namespace math {
+namespace test {
+namespace {
+
+GTEST_TEST(AxisAlignedRotationTest, Detection) {
+  const double kTolerance{1e-12};
+  const Vector3 axes[] = {Vector3::kUnitX, Vector3::kUnitY, Vector3::kUnitZ,
+                          Vector3(0., 0., -1.)};
+  for (const Vector3 &axis : axes) {
+    for (int quarter = -5; quarter <= 5; ++quarter) {
+      const double angle = quarter * M_PI / 2.;
+      AxisAlignedRotation rotation;
+      ASSERT_TRUE(AxisAlignedRotation::fromAxisAngle(axis, angle, &rotation));
+      // Same rotation as the trigonometric formula, but without the noise.
+      const Matrix3 expected{
+          Isometry::rotateAround(axis, angle + 1e-3).rotation().product(
+              Isometry::rotateAround(axis, -1e-3).rotation())};
+      EXPECT_TRUE(areAlmostEqual(rotation.toMatrix(), expected, kTolerance));
+      const Isometry isometry{Isometry::rotateAround(axis, angle)};
+      EXPECT_TRUE(isometry.isAxisAligned());
+      for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+          const double value = isometry.rotation()[i][j];
+          EXPECT_TRUE(value == 0. || value == 1. || value == -1.);
+        }
+      }
+    }
+  }
+
+  AxisAlignedRotation rotation;
+  EXPECT_FALSE(AxisAlignedRotation::fromAxisAngle(Vector3::kUnitX, 0.3,
+                                                  &rotation));
+  EXPECT_FALSE(AxisAlignedRotation::fromAxisAngle(Vector3(1., 1., 0.),
+                                                  M_PI / 2., &rotation));
+  EXPECT_FALSE(Isometry::rotateAround(Vector3::kUnitX, 0.3).isAxisAligned());
+  // Non-finite angles take the trigonometric path, which yields NaNs.
+  for (const double angle : {INFINITY, -INFINITY, NAN}) {
+    EXPECT_FALSE(
+        AxisAlignedRotation::fromAxisAngle(Vector3::kUnitZ, angle, &rotation));
+    const Isometry isometry{Isometry::rotateAround(Vector3::kUnitZ, angle)};
+    EXPECT_FALSE(isometry.isAxisAligned());
+    EXPECT_TRUE(std::isnan(isometry.rotation()[0][0]));
+  }
+  EXPECT_TRUE(Isometry::fromEulerAngles(M_PI / 2., -M_PI, 3. * M_PI / 2.)
+                  .isAxisAligned());
+  EXPECT_FALSE(
+      Isometry::fromEulerAngles(M_PI / 2., 0.1, M_PI).isAxisAligned());
+  EXPECT_TRUE(Isometry().isAxisAligned());
+  EXPECT_TRUE(Isometry::fromTranslation(Vector3(1., 2., 3.)).isAxisAligned());
+
+  EXPECT_TRUE(AxisAlignedRotation::fromMatrix(
+      Matrix3{0., -1., 0., 1., 0., 0., 0., 0., 1.}, &rotation));
+  EXPECT_EQ(rotation.toMatrix(),
+            Matrix3({0., -1., 0., 1., 0., 0., 0., 0., 1.}));
+  // A reflection is a signed permutation, not a rotation.
+  EXPECT_FALSE(AxisAlignedRotation::fromMatrix(
+      Matrix3{0., 1., 0., 1., 0., 0., 0., 0., 1.}, &rotation));
+  EXPECT_FALSE(AxisAlignedRotation::fromMatrix(Matrix3::kOnes, &rotation));
+}
+
+GTEST_TEST(AxisAlignedRotationTest, ExactComposition) {
+  const double kTolerance{1e-12};
+  AxisAlignedRotation r1;
+  AxisAlignedRotation r2;
+  ASSERT_TRUE(
+      AxisAlignedRotation::fromAxisAngle(Vector3::kUnitX, M_PI / 2., &r1));
+  ASSERT_TRUE(
+      AxisAlignedRotation::fromAxisAngle(Vector3::kUnitZ, -M_PI / 2., &r2));
+
+  EXPECT_EQ((r1 * r2).toMatrix(), r1.toMatrix().product(r2.toMatrix()));
+  EXPECT_EQ(r1.compose(r2), r1 * r2);
+  EXPECT_EQ(r1 * r1.inverse(), AxisAlignedRotation());
+  EXPECT_EQ(r1.inverse().toMatrix(), r1.toMatrix().transpose());
+  EXPECT_EQ(r1 * Vector3(1., 2., 3.), Vector3(1., -3., 2.));
+  EXPECT_EQ(r2.transform(Vector3(1., 2., 3.)), Vector3(2., -1., 3.));
+  EXPECT_NE(r1, r2);
+
+  const Matrix3 general{Isometry::rotateAround(Vector3(0.6, 0.8, 0.), 0.4)
+                            .rotation()};
+  EXPECT_TRUE(areAlmostEqual(r1.product(general),
+                             r1.toMatrix().product(general), kTolerance));
+  EXPECT_TRUE(areAlmostEqual(r1.rightProduct(general),
+                             general.product(r1.toMatrix()), kTolerance));
+
+  // Mixed compositions match the general matrix path.
+  const Isometry aligned{Vector3(1., 2., 3.), r1};
+  const Isometry other{Vector3(-1., 0.5, 2.), general};
+  const Isometry plain{Vector3(1., 2., 3.), r1.toMatrix()};
+  EXPECT_FALSE(plain.isAxisAligned());
+  EXPECT_TRUE((aligned * aligned).isAxisAligned());
+  EXPECT_FALSE((aligned * other).isAxisAligned());
+  EXPECT_EQ((aligned * other).translation(), (plain * other).translation());
+  EXPECT_TRUE(areAlmostEqual((aligned * other).rotation(),
+                             (plain * other).rotation(), kTolerance));
+  EXPECT_EQ((other * aligned).translation(), (other * plain).translation());
+  EXPECT_TRUE(areAlmostEqual((other * aligned).rotation(),
+                             (other * plain).rotation(), kTolerance));
+  EXPECT_EQ((aligned * aligned).translation(), (plain * plain).translation());
+  EXPECT_EQ(aligned.inverse() * (aligned * Vector3(4., 5., 6.)),
+            Vector3(4., 5., 6.));
+  EXPECT_EQ(aligned.inverse(), plain.inverse());
+
+  std::stringstream ss;
+  ss << r2;
+  EXPECT_EQ(ss.str(), "[[0, 1, 0], [-1, 0, 0], [0, 0, 1]]");
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace math
+}  // namespace ekumen
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,131 @@
+/* Copyright 2020, Ekumen
+ * Binary serialization library tests
+ * Author: Steven Desvars, 2020
+ */
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include <isometry/binary.hpp>
+#include "gtest/gtest.h"
+
+namespace ekumen {
+namespace math {
+namespace test {
+namespace {
+
+GTEST_TEST(BinaryTest, Layout) {
+  const Vector3 vector{1., -2., 0.5};
+  unsigned char buffer[binarySize<Vector3>(1)];
+  EXPECT_EQ(encode(&vector, 1, buffer, sizeof(buffer)), sizeof(buffer));
+  const unsigned char expected[]{
+      'E',  'K',  'I',  'S',  1,    0,    1,    0,    1,    0,    0,    0,
+      0,    0,    0,    0,    0,    0,    0,    0,    0,    0,    0xf0, 0x3f,
+      0,    0,    0,    0,    0,    0,    0,    0xc0, 0,    0,    0,    0,
+      0,    0,    0xe0, 0x3f};
+  ASSERT_EQ(sizeof(expected), sizeof(buffer));
+  EXPECT_EQ(std::memcmp(buffer, expected, sizeof(buffer)), 0);
+
+  const Vector3View view{buffer, sizeof(buffer)};
+  EXPECT_EQ(view.size(), 1u);
+  EXPECT_EQ(view.bytes(), sizeof(buffer));
+  EXPECT_EQ(view[0], vector);
+}
+
+GTEST_TEST(BinaryTest, RoundTrip) {
+  std::vector<Isometry> isometries;
+  std::vector<Matrix3> matrices;
+  for (int i = 0; i < 20; ++i) {
+    isometries.push_back(
+        Isometry::fromTranslation(Vector3(std::sin(i), 0.1 * i, -1e-300)) *
+        Isometry::fromEulerAngles(0.1 * i, -0.2, 0.3 * i));
+    matrices.push_back(isometries.back().rotation());
+  }
+  isometries.push_back(Isometry::fromTranslation(
+      Vector3(std::numeric_limits<double>::infinity(),
+              std::numeric_limits<double>::denorm_min(), -0.)));
+
+  // Views read in place from unaligned buffers, past trailing data.
+  std::vector<unsigned char> buffer(
+      binarySize<Isometry>(isometries.size()) + 5);
+  const std::size_t size =
+      encode(isometries.data(), isometries.size(), buffer.data() + 1,
+             buffer.size() - 1);
+  EXPECT_EQ(size, binarySize<Isometry>(isometries.size()));
+  const IsometryView view{buffer.data() + 1, buffer.size() - 1};
+  ASSERT_EQ(view.size(), isometries.size());
+  EXPECT_EQ(view.bytes(), size);
+  for (std::size_t i = 0; i < view.size(); ++i) {
+    const Isometry decoded{view[i]};
+    for (int j = 0; j < 3; ++j) {
+      EXPECT_EQ(std::memcmp(&decoded.translation()[j],
+                            &isometries[i].translation()[j], sizeof(double)),
+                0);
+      for (int k = 0; k < 3; ++k) {
+        EXPECT_EQ(decoded.rotation()[j][k], isometries[i].rotation()[j][k]);
+      }
+    }
+  }
+
+  encode(matrices.data(), matrices.size(), buffer.data() + 3,
+         buffer.size() - 3);
+  const Matrix3View matrix_view{buffer.data() + 3, buffer.size() - 3};
+  std::vector<Matrix3> decoded(matrices.size());
+  matrix_view.copy(0, matrix_view.size(), decoded.data());
+  for (std::size_t i = 0; i < matrices.size(); ++i) {
+    EXPECT_EQ(decoded[i], matrices[i]);
+    EXPECT_EQ(matrix_view.at(i), matrices[i]);
+  }
+  EXPECT_THROW(matrix_view.at(matrices.size()), std::out_of_range);
+  EXPECT_THROW(matrix_view.copy(1, matrices.size(), decoded.data()),
+               std::out_of_range);
+
+  const Vector3View empty{buffer.data(),
+                          encode(static_cast<const Vector3*>(nullptr), 0,
+                                 buffer.data(), buffer.size())};
+  EXPECT_TRUE(empty.empty());
+}
+
+GTEST_TEST(BinaryTest, Validation) {
+  const Vector3 vectors[]{Vector3(1., 2., 3.), Vector3(4., 5., 6.)};
+  unsigned char buffer[binarySize<Vector3>(2)];
+  EXPECT_THROW(encode(vectors, 2, buffer, sizeof(buffer) - 1),
+               std::length_error);
+  EXPECT_THROW(encode(vectors, 0, buffer, kBinaryHeaderSize - 1),
+               std::length_error);
+  encode(vectors, 2, buffer, sizeof(buffer));
+
+  EXPECT_NO_THROW(Vector3View(buffer, sizeof(buffer)));
+  EXPECT_THROW(Vector3View(buffer, sizeof(buffer) - 1),
+               std::invalid_argument);
+  EXPECT_THROW(Vector3View(buffer, kBinaryHeaderSize - 1),
+               std::invalid_argument);
+  EXPECT_THROW(Matrix3View(buffer, sizeof(buffer)), std::invalid_argument);
+  EXPECT_THROW(IsometryView(buffer, sizeof(buffer)), std::invalid_argument);
+
+  unsigned char corrupted[sizeof(buffer)];
+  std::memcpy(corrupted, buffer, sizeof(buffer));
+  corrupted[0] = 'X';
+  EXPECT_THROW(Vector3View(corrupted, sizeof(corrupted)),
+               std::invalid_argument);
+  std::memcpy(corrupted, buffer, sizeof(buffer));
+  corrupted[4] = kBinaryVersion + 1;
+  EXPECT_THROW(Vector3View(corrupted, sizeof(corrupted)),
+               std::invalid_argument);
+  std::memcpy(corrupted, buffer, sizeof(buffer));
+  corrupted[15] = 0x80;
+  EXPECT_THROW(Vector3View(corrupted, sizeof(corrupted)),
+               std::invalid_argument);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace math
+}  // namespace ekumen
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,120 @@
+/* Copyright 2020, Ekumen
+ * Concurrent frame tree library tests
+ * Author: Steven Desvars, 2020
+ */
+
+#include <atomic>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+#include <isometry/concurrent_frame_tree.hpp>
+#include "gtest/gtest.h"
+
+namespace ekumen {
+namespace math {
+namespace test {
+namespace {
+
+GTEST_TEST(ConcurrentFrameTreeTest, ReadersAndWriter) {
+  const double kTolerance{1e-9};
+  FrameTree initial{"map"};
+  initial.addFrame("left", "map", Isometry());
+  initial.addFrame("right", "map", Isometry());
+  ConcurrentFrameTree tree{initial, 8};
+
+  // The writer always moves both frames together, so every consistent
+  // snapshot has them on top of each other.
+  const int kReaders{4};
+  std::atomic<int> started{0};
+  std::atomic<bool> done{false};
+  std::atomic<int> inconsistent{0};
+  std::atomic<long> lookups{0};
+  std::vector<std::thread> readers;
+  for (int i = 0; i < kReaders; ++i) {
+    readers.emplace_back([&]() {
+      ConcurrentFrameTree::Reader reader{tree.reader()};
+      ++started;
+      do {
+        const Isometry relative{reader.lookup("left", "right")};
+        if (relative.translation().norm() > kTolerance) {
+          ++inconsistent;
+        }
+        ++lookups;
+      } while (!done.load());
+    });
+  }
+  while (started.load() < kReaders) {
+    std::this_thread::yield();
+  }
+  for (int i = 0; i < 2000; ++i) {
+    const Isometry pose{Vector3(i, -i, 0.5 * i),
+                        Isometry::rotateAround(Vector3::kUnitZ, 0.01 * i)
+                            .rotation()};
+    tree.update([&pose](FrameTree* r_tree) {
+      r_tree->setTransform("left", pose);
+      r_tree->setTransform("right", pose);
+    });
+  }
+  done.store(true);
+  for (std::thread& reader : readers) {
+    reader.join();
+  }
+  EXPECT_EQ(inconsistent.load(), 0);
+  EXPECT_GT(lookups.load(), 0);
+
+  // With no active readers, every replaced snapshot is reclaimed.
+  tree.setTransform("left", Isometry());
+  EXPECT_EQ(tree.retiredCount(), 0u);
+
+  ConcurrentFrameTree::Reader reader{tree.reader()};
+  tree.addFrame("camera", "left",
+                Isometry::fromTranslation(Vector3(0., 0., 1.)));
+  EXPECT_EQ(reader.lookup("map", "camera").translation(),
+            Vector3(0., 0., 1.));
+  reader.read([&tree](const FrameTree& snapshot) {
+    EXPECT_TRUE(snapshot.hasFrame("camera"));
+    // Updates while a snapshot is pinned are retired, not freed.
+    tree.setTransform("camera", Isometry());
+    EXPECT_TRUE(snapshot.hasFrame("camera"));
+    EXPECT_EQ(snapshot.transform("camera").translation(),
+              Vector3(0., 0., 1.));
+  });
+  EXPECT_EQ(tree.retiredCount(), 1u);
+  tree.setTransform("camera", Isometry());
+  EXPECT_EQ(tree.retiredCount(), 0u);
+  EXPECT_ANY_THROW(reader.lookup("map", "unknown"));
+
+  // Handles resolved once keep working on later snapshots.
+  const FrameId map{reader.id("map")};
+  const FrameId camera{reader.id("camera")};
+  const FrameId lidar{tree.addFrame(
+      "lidar", camera, Isometry::fromTranslation(Vector3(1., 0., 0.)))};
+  EXPECT_EQ(lidar, reader.id("lidar"));
+  tree.setTransform(camera, Isometry::fromTranslation(Vector3(0., 2., 0.)));
+  EXPECT_EQ(reader.lookup(map, lidar).translation(), Vector3(1., 2., 0.));
+  EXPECT_EQ(reader.lookup(map, lidar), reader.lookup("map", "lidar"));
+  EXPECT_ANY_THROW(reader.lookup(map, FrameId(42)));
+}
+
+GTEST_TEST(ConcurrentFrameTreeTest, ReaderSlots) {
+  ConcurrentFrameTree tree{FrameTree{"map"}, 2};
+  ConcurrentFrameTree::Reader first{tree.reader()};
+  {
+    ConcurrentFrameTree::Reader second{tree.reader()};
+    EXPECT_ANY_THROW(tree.reader());
+  }
+  ConcurrentFrameTree::Reader third{tree.reader()};
+  ConcurrentFrameTree::Reader moved{std::move(third)};
+  EXPECT_EQ(moved.lookup("map", "map"), Isometry());
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace math
+}  // namespace ekumen
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,150 @@
+/* Copyright 2020, Ekumen
+ * Euler angles library tests
+ * Author: Steven Desvars, 2020
+ */
+
+#include <cmath>
+#include <vector>
+
+#include <isometry/isometry.hpp>
+#include "gtest/gtest.h"
+#include "test_utils.hpp"
+
+namespace ekumen {
+namespace math {
+namespace test {
+namespace {
+
+const EulerSequence kSequences[] = {
+    EulerSequence::kXYZ, EulerSequence::kXZY, EulerSequence::kYXZ,
+    EulerSequence::kYZX, EulerSequence::kZXY, EulerSequence::kZYX,
+    EulerSequence::kXYX, EulerSequence::kXZX, EulerSequence::kYXY,
+    EulerSequence::kYZY, EulerSequence::kZXZ, EulerSequence::kZYZ};
+const EulerFrame kFrames[] = {EulerFrame::kIntrinsic, EulerFrame::kExtrinsic};
+
+GTEST_TEST(EulerAnglesTest, RoundTrips) {
+  const double kTolerance{1e-12};
+  const Vector3 samples[] = {Vector3(0.3, -0.7, 1.1), Vector3(-2.5, 1.2, 3.),
+                             Vector3(1., M_PI / 2., 0.5),
+                             Vector3(0.4, -M_PI / 2., -0.2),
+                             Vector3(0.7, 0., 0.1), Vector3(0.2, M_PI, -1.)};
+  for (const EulerSequence sequence : kSequences) {
+    for (const EulerFrame frame : kFrames) {
+      for (const Vector3 &angles : samples) {
+        const Isometry isometry{
+            Isometry::fromEulerAngles(angles, sequence, frame)};
+        const Vector3 extracted{isometry.toEulerAngles(sequence, frame)};
+        EXPECT_TRUE(areAlmostEqual(
+            Isometry::fromEulerAngles(extracted, sequence, frame).rotation(),
+            isometry.rotation(), kTolerance));
+      }
+    }
+  }
+}
+
+GTEST_TEST(EulerAnglesTest, Conventions) {
+  const double kTolerance{1e-12};
+  const double roll{0.1};
+  const double pitch{-0.4};
+  const double yaw{2.};
+
+  // The legacy constructor is intrinsic XYZ.
+  const Isometry xyz{Isometry::fromEulerAngles(roll, pitch, yaw)};
+  EXPECT_TRUE(areAlmostEqual(
+      Isometry::fromEulerAngles(Vector3(roll, pitch, yaw), EulerSequence::kXYZ)
+          .rotation(),
+      xyz.rotation(), kTolerance));
+  const Vector3 angles{xyz.toEulerAngles()};
+  EXPECT_NEAR(angles.x(), roll, kTolerance);
+  EXPECT_NEAR(angles.y(), pitch, kTolerance);
+  EXPECT_NEAR(angles.z(), yaw, kTolerance);
+
+  // Yaw-pitch-roll is intrinsic ZYX, the same as extrinsic XYZ.
+  const Isometry ypr{Isometry::fromEulerAngles(Vector3(yaw, pitch, roll),
+                                               EulerSequence::kZYX)};
+  EXPECT_TRUE(areAlmostEqual(
+      ypr.rotation(),
+      (Isometry::rotateAround(Vector3::kUnitZ, yaw) *
+       Isometry::rotateAround(Vector3::kUnitY, pitch) *
+       Isometry::rotateAround(Vector3::kUnitX, roll))
+          .rotation(),
+      kTolerance));
+  const Vector3 extrinsic{
+      ypr.toEulerAngles(EulerSequence::kXYZ, EulerFrame::kExtrinsic)};
+  EXPECT_NEAR(extrinsic.x(), roll, kTolerance);
+  EXPECT_NEAR(extrinsic.y(), pitch, kTolerance);
+  EXPECT_NEAR(extrinsic.z(), yaw, kTolerance);
+
+  // Proper Euler angles keep the middle angle in [0, pi].
+  const Vector3 zyz{Isometry::fromEulerAngles(Vector3(0.5, -0.8, 0.3),
+                                              EulerSequence::kZYZ)
+                        .toEulerAngles(EulerSequence::kZYZ)};
+  EXPECT_NEAR(zyz.y(), 0.8, kTolerance);
+
+  // Gimbal lock puts the whole locked rotation in the first angle.
+  const Vector3 locked{Isometry::fromEulerAngles(Vector3(0.3, M_PI / 2., 0.2),
+                                                 EulerSequence::kZYX)
+                           .toEulerAngles(EulerSequence::kZYX)};
+  EXPECT_NEAR(locked.x(), 0.1, kTolerance);
+  EXPECT_NEAR(locked.y(), M_PI / 2., kTolerance);
+  EXPECT_EQ(locked.z(), 0.);
+  // Also for extrinsic rotations.
+  for (const EulerSequence sequence : kSequences) {
+    const double middle = static_cast<int>(sequence) <
+                                  static_cast<int>(EulerSequence::kXYX)
+                              ? -M_PI / 2.
+                              : M_PI;
+    const Isometry isometry{Isometry::fromEulerAngles(
+        Vector3(0.3, middle, 0.2), sequence, EulerFrame::kExtrinsic)};
+    const Vector3 extrinsic{
+        isometry.toEulerAngles(sequence, EulerFrame::kExtrinsic)};
+    EXPECT_EQ(extrinsic.z(), 0.);
+    EXPECT_NEAR(std::abs(extrinsic.y()), std::abs(middle), kTolerance);
+    EXPECT_TRUE(areAlmostEqual(
+        Isometry::fromEulerAngles(extrinsic, sequence, EulerFrame::kExtrinsic)
+            .rotation(),
+        isometry.rotation(), kTolerance));
+  }
+
+  // Exact quarter turns stay axis-aligned.
+  EXPECT_TRUE(Isometry::fromEulerAngles(Vector3(M_PI / 2., M_PI, 0.),
+                                        EulerSequence::kZXZ,
+                                        EulerFrame::kExtrinsic)
+                  .isAxisAligned());
+  EXPECT_ANY_THROW(eulerAxis(EulerSequence::kXYZ, 3));
+}
+
+GTEST_TEST(EulerAnglesTest, Batches) {
+  const double kTolerance{1e-12};
+  std::vector<Vector3> angles;
+  for (int i = 0; i < 100; ++i) {
+    angles.push_back(Vector3(0.05 * i - 2., 0.01 * i - 0.5, 3. - 0.06 * i));
+  }
+  std::vector<Isometry> isometries(angles.size());
+  std::vector<Vector3> extracted(angles.size());
+  for (const EulerSequence sequence : kSequences) {
+    for (const EulerFrame frame : kFrames) {
+      Isometry::fromEulerAngles(angles.data(), angles.size(),
+                                isometries.data(), sequence, frame);
+      Isometry::toEulerAngles(isometries.data(), isometries.size(),
+                              extracted.data(), sequence, frame);
+      for (std::size_t i = 0; i < angles.size(); ++i) {
+        EXPECT_TRUE(areAlmostEqual(
+            isometries[i].rotation(),
+            Isometry::fromEulerAngles(angles[i], sequence, frame).rotation(),
+            kTolerance));
+        EXPECT_EQ(extracted[i], isometries[i].toEulerAngles(sequence, frame));
+      }
+    }
+  }
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace math
+}  // namespace ekumen
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
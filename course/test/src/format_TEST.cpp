@@ -0,0 +1,219 @@
+/* Copyright 2020, Ekumen
+ * Text formatting library tests
+ * Author: Steven Desvars, 2020
+ */
+
+#include <cmath>
+#include <cstdlib>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <isometry/format.hpp>
+#include <isometry/internal/format_double.hpp>
+#include <isometry/internal/parse_double.hpp>
+#include "gtest/gtest.h"
+
+namespace ekumen {
+namespace math {
+namespace test {
+namespace {
+
+template <class T>
+std::string streamed(const T& r_value) {
+  std::stringstream ss;
+  ss << r_value;
+  return ss.str();
+}
+
+template <class T>
+std::string formatted(const T& r_value, const FormatMode mode) {
+  char buffer[kFormatBufferSize];
+  const std::size_t length = format(r_value, buffer, sizeof(buffer), mode);
+  EXPECT_EQ(length, std::strlen(buffer));
+  return std::string(buffer, length);
+}
+
+double parsed(const std::string& text) {
+  double value{0.};
+  EXPECT_EQ(internal::parseDouble(text.data(), text.data() + text.size(),
+                                  &value),
+            text.data() + text.size())
+      << text;
+  return value;
+}
+
+GTEST_TEST(FormatTest, ParseDouble) {
+  const std::vector<std::string> texts{
+      "0", "-0", "1", "+2.5", "0.1", "-0.000123", "123456789", "1e22",
+      "1.7976931348623157e308", "4.9e-324", "2.2250738585072014e-308",
+      "0.30000000000000004", "123456789012345678901234567890",
+      "9007199254740993", "1E-5", "3.", ".5", "inf", "-inf", "1e400",
+      "-1e-400"};
+  for (const std::string& text : texts) {
+    const double value = parsed(text);
+    const double expected = std::strtod(text.c_str(), nullptr);
+    EXPECT_EQ(std::memcmp(&value, &expected, sizeof(double)), 0) << text;
+  }
+  EXPECT_TRUE(std::isnan(parsed("nan")));
+
+  // The number ends where the grammar does, not at a null.
+  const char text[] = "12.5e3x 1e+";
+  double value;
+  EXPECT_EQ(internal::parseDouble(text, text + 4, &value), text + 4);
+  EXPECT_EQ(value, 12.5);
+  EXPECT_EQ(internal::parseDouble(text, text + 11, &value), text + 6);
+  EXPECT_EQ(value, 12500.);
+  EXPECT_EQ(internal::parseDouble(text + 8, text + 11, &value), text + 9);
+  EXPECT_EQ(value, 1.);
+  EXPECT_EQ(internal::parseDouble(text + 6, text + 11, &value), nullptr);
+  EXPECT_EQ(internal::parseDouble(text, text, &value), nullptr);
+  const char spaced[] = " 1";
+  EXPECT_EQ(internal::parseDouble(spaced, spaced + 2, &value), nullptr);
+
+  // Long numbers are read whole, or rejected past 1023 characters.
+  EXPECT_EQ(parsed("1" + std::string(200, '0')), 1e200);
+  EXPECT_EQ(parsed("0." + std::string(150, '0') + "5"), 5e-151);
+  EXPECT_EQ(parsed("-0." + std::string(1000, '0') + "12e1000"), -0.12);
+  const std::string huge{"1" + std::string(1100, '0')};
+  EXPECT_EQ(internal::parseDouble(huge.data(), huge.data() + huge.size(),
+                                  &value),
+            nullptr);
+}
+
+std::string shortest(const double value) {
+  char buffer[internal::kShortestDoubleSize];
+  const std::size_t length = internal::formatShortest(value, buffer);
+  EXPECT_EQ(length, std::strlen(buffer));
+  return std::string(buffer, length);
+}
+
+GTEST_TEST(FormatTest, FormatShortest) {
+  EXPECT_EQ(shortest(0.), "0");
+  EXPECT_EQ(shortest(-0.), "-0");
+  EXPECT_EQ(shortest(1.), "1");
+  EXPECT_EQ(shortest(-2.5), "-2.5");
+  EXPECT_EQ(shortest(0.1), "0.1");
+  EXPECT_EQ(shortest(0.001), "0.001");
+  EXPECT_EQ(shortest(1e-5), "1e-05");
+  EXPECT_EQ(shortest(123456.), "123456");
+  EXPECT_EQ(shortest(1e6), "1e+06");
+  EXPECT_EQ(shortest(1.5e300), "1.5e+300");
+  EXPECT_EQ(shortest(5e-324), "5e-324");
+  EXPECT_EQ(shortest(std::numeric_limits<double>::max()),
+            "1.7976931348623157e+308");
+  EXPECT_EQ(shortest(std::numeric_limits<double>::infinity()), "inf");
+  EXPECT_EQ(shortest(-std::numeric_limits<double>::infinity()), "-inf");
+  EXPECT_EQ(shortest(std::numeric_limits<double>::quiet_NaN()), "nan");
+
+  // Random bit patterns, denormals included, parse back to the same double
+  // and never need more than 17 digits.
+  std::uint64_t state{0x9e3779b97f4a7c15};
+  for (int i = 0; i < 100000; ++i) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    std::uint64_t bits{state};
+    if (i % 4 == 0) {
+      bits &= 0x800fffffffffffff;
+    }
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    if (!std::isfinite(value)) {
+      continue;
+    }
+    const std::string text{shortest(value)};
+    const double parsed_value = std::strtod(text.c_str(), nullptr);
+    ASSERT_EQ(std::memcmp(&parsed_value, &value, sizeof(double)), 0) << text;
+    char legacy[32];
+    std::snprintf(legacy, sizeof(legacy), "%.17g", value);
+    EXPECT_LE(text.size(), std::strlen(legacy) + 1) << text;
+  }
+}
+
+GTEST_TEST(FormatTest, LegacyLayout) {
+  const Vector3 vector{1., -2.5, 1.0 / 3.0};
+  const Matrix3 matrix{1., 2., 3., 4., 5., 6., 7., 8., 1e-20};
+  const Isometry isometry{Isometry::fromTranslation(Vector3(0.1, 2., -3.)) *
+                          Isometry::rotateAround(Vector3::kUnitZ, M_PI / 8.)};
+  EXPECT_EQ(formatted(vector, FormatMode::kLegacy), streamed(vector));
+  EXPECT_EQ(formatted(matrix, FormatMode::kLegacy), streamed(matrix));
+  EXPECT_EQ(formatted(isometry, FormatMode::kLegacy), streamed(isometry));
+  EXPECT_EQ(formatted(Isometry(), FormatMode::kLegacy),
+            "[T: (x: 0, y: 0, z: 0), R:[[1, 0, 0], [0, 1, 0], [0, 0, 1]]]");
+
+  char small[16];
+  EXPECT_THROW(format(isometry, small, sizeof(small)), std::length_error);
+  // What fits is left null terminated.
+  EXPECT_LT(std::strlen(small), sizeof(small));
+  EXPECT_THROW(format(vector, small, 0), std::length_error);
+}
+
+GTEST_TEST(FormatTest, RoundTrip) {
+  EXPECT_EQ(formatted(Vector3(0.1, 1., -2.5), FormatMode::kRoundTrip),
+            "(x: 0.1, y: 1, z: -2.5)");
+  EXPECT_EQ(formatted(Vector3(0.1 + 0.2, 1.0 / 3.0, 1e300),
+                      FormatMode::kRoundTrip),
+            "(x: 0.30000000000000004, y: 0.3333333333333333, z: 1e+300)");
+
+  // Arbitrary isometries go through text without losing a bit.
+  for (int i = 0; i < 50; ++i) {
+    const Isometry isometry{
+        Isometry::fromTranslation(Vector3(std::sin(i) * 1e3, i * 0.1,
+                                          std::exp(-i))) *
+        Isometry::fromEulerAngles(0.1 * i, -0.07 * i, 0.3 * i)};
+    const std::string text{formatted(isometry, FormatMode::kRoundTrip)};
+    Isometry parsed_isometry;
+    EXPECT_EQ(parse(text.data(), text.size(), &parsed_isometry), text.size());
+    for (int j = 0; j < 3; ++j) {
+      EXPECT_EQ(parsed_isometry.translation()[j], isometry.translation()[j]);
+      for (int k = 0; k < 3; ++k) {
+        EXPECT_EQ(parsed_isometry.rotation()[j][k],
+                  isometry.rotation()[j][k]);
+      }
+    }
+  }
+}
+
+GTEST_TEST(FormatTest, Parse) {
+  const std::string text{
+      "[T: (x: 1, y: 2, z: 3), R:[[0, -1, 0], [1, 0, 0], [0, 0, 1]]] tail"};
+  Isometry isometry;
+  EXPECT_EQ(parse(text.data(), text.size(), &isometry), text.size() - 5);
+  EXPECT_EQ(isometry, Isometry::fromTranslation(Vector3(1., 2., 3.)) *
+                          Isometry::rotateAround(Vector3::kUnitZ, M_PI / 2.));
+
+  Vector3 vector;
+  const std::string compact{"(x:1,y:-2e3,z:.5)"};
+  EXPECT_EQ(parse(compact.data(), compact.size(), &vector), compact.size());
+  EXPECT_EQ(vector, Vector3(1., -2000., 0.5));
+
+  Matrix3 matrix;
+  const std::string rows{"[[1, 2, 3], [4, 5, 6], [7, 8, 9]]"};
+  EXPECT_EQ(parse(rows.data(), rows.size(), &matrix), rows.size());
+  EXPECT_EQ(matrix, (Matrix3{1., 2., 3., 4., 5., 6., 7., 8., 9.}));
+
+  // Truncated or malformed text.
+  EXPECT_THROW(parse(rows.data(), rows.size() - 1, &matrix),
+               std::invalid_argument);
+  EXPECT_THROW(parse(compact.data(), 8, &vector), std::invalid_argument);
+  const std::string wrong{"(x: 1, y: two, z: 3)"};
+  EXPECT_THROW(parse(wrong.data(), wrong.size(), &vector),
+               std::invalid_argument);
+  EXPECT_THROW(parse(text.data(), text.size(), &matrix),
+               std::invalid_argument);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace math
+}  // namespace ekumen
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
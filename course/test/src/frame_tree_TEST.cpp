@@ -0,0 +1,184 @@
+/* Copyright 2020, Ekumen
+ * Frame tree library tests
+ * Author: Steven Desvars, 2020
+ */
+
+#include <cmath>
+#include <string>
+
+#include <isometry/frame_tree.hpp>
+#include "gtest/gtest.h"
+#include "test_utils.hpp"
+
+namespace ekumen {
+namespace math {
+namespace test {
+namespace {
+
+GTEST_TEST(FrameTreeTest, FrameTreeFullTests) {
+  const double kTolerance{1e-12};
+  // map -> odom -> base, base -> lidar and base -> arm -> camera.
+  const Isometry map_odom{Vector3(10., -2., 0.),
+                          Isometry::rotateAround(Vector3::kUnitZ, 0.3)
+                              .rotation()};
+  const Isometry odom_base{Isometry::fromTranslation(Vector3(1., 2., 0.)) *
+                           Isometry::rotateAround(Vector3::kUnitZ, -1.1)};
+  const Isometry base_lidar{Isometry::fromTranslation(Vector3(0.2, 0., 1.5))};
+  const Isometry base_arm{Isometry::fromTranslation(Vector3(0.5, 0.1, 0.8)) *
+                          Isometry::fromEulerAngles(0.1, 0.2, 0.3)};
+  const Isometry arm_camera{Isometry::fromTranslation(Vector3(0., 0., 0.4)) *
+                            Isometry::rotateAround(Vector3::kUnitY, 0.7)};
+
+  FrameTree tree{"map"};
+  tree.addFrame("odom", "map", map_odom);
+  tree.addFrame("base", "odom", odom_base);
+  tree.addFrame("lidar", "base", base_lidar);
+  tree.addFrame("arm", "base", base_arm);
+  tree.addFrame("camera", "arm", arm_camera);
+
+  EXPECT_EQ(tree.size(), 6u);
+  EXPECT_TRUE(tree.hasFrame("camera"));
+  EXPECT_FALSE(tree.hasFrame("gps"));
+  EXPECT_EQ(tree.parent("camera"), "arm");
+  EXPECT_EQ(tree.transform("arm"), base_arm);
+
+  EXPECT_TRUE(areAlmostEqual(tree.lookup("map", "camera"),
+                             map_odom * odom_base * base_arm * arm_camera,
+                             kTolerance));
+  EXPECT_TRUE(areAlmostEqual(tree.lookup("lidar", "camera"),
+                             base_lidar.inverse() * base_arm * arm_camera,
+                             kTolerance));
+  EXPECT_TRUE(areAlmostEqual(tree.lookup("camera", "odom"),
+                             (odom_base * base_arm * arm_camera).inverse(),
+                             kTolerance));
+  EXPECT_TRUE(
+      areAlmostEqual(tree.lookup("arm", "arm"), Isometry(), kTolerance));
+
+  // Updates propagate to the whole subtree.
+  const Isometry moved_arm{Isometry::fromTranslation(Vector3(0.5, 0.1, 0.9)) *
+                           Isometry::rotateAround(Vector3::kUnitZ, 1.)};
+  tree.setTransform("arm", moved_arm);
+  EXPECT_TRUE(areAlmostEqual(tree.lookup("lidar", "camera"),
+                             base_lidar.inverse() * moved_arm * arm_camera,
+                             kTolerance));
+  tree.setTransform("odom", Isometry());
+  EXPECT_TRUE(areAlmostEqual(tree.lookup("map", "camera"),
+                             odom_base * moved_arm * arm_camera, kTolerance));
+  const Vector3 point{1., 2., 3.};
+  EXPECT_TRUE((tree.lookup("camera", "map") *
+                   (tree.lookup("map", "camera") * point) -
+               point)
+                  .norm() < kTolerance);
+
+  EXPECT_ANY_THROW(tree.addFrame("lidar", "base", Isometry()));
+  EXPECT_ANY_THROW(tree.addFrame("gps", "unknown", Isometry()));
+  EXPECT_ANY_THROW(tree.setTransform("map", Isometry()));
+  EXPECT_ANY_THROW(tree.lookup("map", "unknown"));
+  EXPECT_ANY_THROW(tree.parent("map"));
+}
+
+GTEST_TEST(FrameTreeTest, FrameIds) {
+  FrameTree tree{"map"};
+  EXPECT_EQ(tree.root(), tree.id("map"));
+  const FrameId odom{tree.addFrame(
+      "odom", tree.root(), Isometry::fromTranslation(Vector3(1., 0., 0.)))};
+  const FrameId base{tree.addFrame(
+      "base", "odom", Isometry::rotateAround(Vector3::kUnitZ, M_PI / 2.))};
+  const FrameId laser{tree.addFrame(
+      "laser", base, Isometry::fromTranslation(Vector3(0., 0., 1.)))};
+  EXPECT_EQ(tree.id("odom"), odom);
+  EXPECT_EQ(tree.id("laser"), laser);
+  EXPECT_EQ(tree.name(base), "base");
+  EXPECT_EQ(tree.parent(laser), base);
+  EXPECT_EQ(tree.parent(odom), tree.root());
+  EXPECT_EQ(tree.transform(odom), tree.transform("odom"));
+  EXPECT_EQ(tree.lookup(tree.root(), laser), tree.lookup("map", "laser"));
+
+  tree.setTransform(odom, Isometry::fromTranslation(Vector3(2., 0., 0.)));
+  tree.updateWorldPoses();
+  EXPECT_EQ(tree.lookup(tree.root(), laser).translation(),
+            Vector3(2., 0., 1.));
+
+  // A copy shares the handles.
+  const FrameTree copy{tree};
+  EXPECT_EQ(copy.lookup(odom, laser), tree.lookup(odom, laser));
+
+  EXPECT_THROW(tree.id("unknown"), std::invalid_argument);
+  EXPECT_EQ(laser.index(), 3u);
+  EXPECT_THROW(tree.name(FrameId(4)), std::out_of_range);
+  EXPECT_THROW(tree.lookup(odom, FrameId(4)), std::out_of_range);
+  EXPECT_THROW(tree.addFrame("tool", FrameId(4), Isometry()),
+               std::out_of_range);
+  EXPECT_THROW(tree.setTransform(tree.root(), Isometry()),
+               std::invalid_argument);
+  EXPECT_THROW(tree.parent(tree.root()), std::invalid_argument);
+}
+
+GTEST_TEST(FrameTreeTest, IncrementalUpdates) {
+  const double kTolerance{1e-12};
+  // A chain of links with a sensor hanging from each of them.
+  FrameTree tree{"world"};
+  const int kLinks{10};
+  std::string parent = "world";
+  for (int i = 0; i < kLinks; ++i) {
+    const std::string link = "link_" + std::to_string(i);
+    tree.addFrame(link, parent, Isometry::fromTranslation(Vector3::kUnitX));
+    tree.addFrame("sensor_" + std::to_string(i), link,
+                  Isometry::fromTranslation(Vector3::kUnitZ));
+    parent = link;
+  }
+  ASSERT_EQ(tree.size(), 21u);
+
+  FrameTree::UpdateStats stats{tree.updateWorldPoses()};
+  EXPECT_EQ(stats.recomputed, 0u);
+  EXPECT_EQ(stats.saved, 20u);
+
+  // Moving link 7 only invalidates links 7 to 9 and their sensors.
+  const Isometry joint{Isometry::fromTranslation(Vector3::kUnitX) *
+                       Isometry::rotateAround(Vector3::kUnitY, 0.4)};
+  tree.setTransform("link_7", joint);
+  stats = tree.updateWorldPoses();
+  EXPECT_EQ(stats.recomputed, 6u);
+  EXPECT_EQ(stats.saved, 14u);
+  EXPECT_TRUE(areAlmostEqual(
+      tree.lookup("world", "sensor_8"),
+      Isometry::fromTranslation(Vector3(7., 0., 0.)) * joint *
+          Isometry::fromTranslation(Vector3(1., 0., 1.)),
+      kTolerance));
+
+  // Several updates are folded into one pass, and frames added under a
+  // dirty subtree end up consistent too.
+  tree.setTransform("link_9", joint);
+  tree.setTransform("sensor_2", Isometry());
+  tree.addFrame("tool", "link_9", Isometry::fromTranslation(Vector3::kUnitX));
+  // Lookups on a stale tree compose the dirty paths on demand.
+  for (int pass = 0; pass < 2; ++pass) {
+    EXPECT_EQ(tree.stale(), pass == 0);
+    EXPECT_TRUE(areAlmostEqual(
+        tree.lookup("link_8", "tool"),
+        joint * Isometry::fromTranslation(Vector3::kUnitX), kTolerance));
+    EXPECT_TRUE(areAlmostEqual(tree.lookup("link_2", "sensor_2"), Isometry(),
+                               kTolerance));
+    EXPECT_TRUE(areAlmostEqual(
+        tree.lookup("world", "tool"),
+        Isometry::fromTranslation(Vector3(7., 0., 0.)) * joint *
+            Isometry::fromTranslation(Vector3::kUnitX) * joint *
+            Isometry::fromTranslation(Vector3::kUnitX),
+        kTolerance));
+    if (pass == 0) {
+      stats = tree.updateWorldPoses();
+      EXPECT_EQ(stats.recomputed, 4u);
+      EXPECT_EQ(stats.saved, 17u);
+    }
+  }
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace math
+}  // namespace ekumen
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
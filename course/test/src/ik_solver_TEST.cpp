@@ -0,0 +1,107 @@
+/* Copyright 2020, Ekumen
+ * Inverse kinematics library tests
+ * Author: Steven Desvars, 2020
+ */
+
+#include <cmath>
+
+#include <isometry/ik_solver.hpp>
+#include "gtest/gtest.h"
+#include "test_utils.hpp"
+
+namespace ekumen {
+namespace math {
+namespace test {
+namespace {
+
+// 7-DOF arm, classic Denavit-Hartenberg parameters.
+KinematicChain makeArm() {
+  const double a[]{0., 0., 0.0825, -0.0825, 0., 0.088, 0.};
+  const double alpha[]{-M_PI / 2., M_PI / 2., M_PI / 2., -M_PI / 2.,
+                       M_PI / 2., M_PI / 2., 0.};
+  const double d[]{0.333, 0., 0.316, 0., 0.384, 0., 0.107};
+  KinematicChain chain;
+  for (int i = 0; i < 7; ++i) {
+    chain.addDHJoint(JointType::kRevolute, a[i], alpha[i], d[i], 0.);
+  }
+  return chain;
+}
+
+GTEST_TEST(IkSolverTest, ReachesTargets) {
+  const KinematicChain arm{makeArm()};
+  IkSolver solver{arm};
+  EXPECT_THROW(IkSolver{KinematicChain()}, std::invalid_argument);
+  IkOptions options;
+  options.damping = 0.;
+  EXPECT_THROW(IkSolver(arm, options), std::invalid_argument);
+
+  const double goal[]{0.4, -0.6, 0.3, -1.8, 0.2, 1.4, 0.5};
+  const Isometry target{arm.endEffector(goal)};
+  double q[]{0., 0., 0., -1.5, 0., 1.5, 0.};
+  IkResult result{solver.solve(target, q)};
+  EXPECT_TRUE(result.converged);
+  EXPECT_GT(result.iterations, 0u);
+  EXPECT_LE(result.position_error, solver.options().position_tolerance);
+  EXPECT_LE(result.orientation_error,
+            solver.options().orientation_tolerance);
+  EXPECT_TRUE(areAlmostEqual(arm.endEffector(q), target, 1e-5));
+
+  // Warm starting from the solution takes no iterations, and from a
+  // nearby one takes fewer than from scratch.
+  result = solver.solve(target, q);
+  EXPECT_TRUE(result.converged);
+  EXPECT_EQ(result.iterations, 0u);
+  const double nearby[]{0.45, -0.6, 0.3, -1.8, 0.2, 1.4, 0.5};
+  double seed[]{0., 0., 0., -1.5, 0., 1.5, 0.};
+  const std::size_t cold =
+      solver.solve(arm.endEffector(nearby), seed).iterations;
+  result = solver.solve(arm.endEffector(nearby), q);
+  EXPECT_TRUE(result.converged);
+  EXPECT_LT(result.iterations, cold);
+}
+
+GTEST_TEST(IkSolverTest, JointLimits) {
+  const KinematicChain arm{makeArm()};
+  IkSolver solver{arm};
+  const double lower[]{-0.2, -1., -1., -2.5, -1., 0.5, -1.};
+  const double upper[]{0.2, 1., 1., -0.5, 1., 2.5, 1.};
+  EXPECT_THROW(solver.setJointLimits(upper, lower), std::invalid_argument);
+  solver.setJointLimits(lower, upper);
+
+  // Reachable within the limits.
+  const double goal[]{0.1, 0.5, -0.3, -1.2, 0.4, 1.1, -0.2};
+  double q[]{0., 0., 0., -1.5, 0., 1.5, 0.};
+  IkResult result{solver.solve(arm.endEffector(goal), q)};
+  EXPECT_TRUE(result.converged);
+
+  // Out of reach of the first joint, the solution stays within limits.
+  const double out[]{1.5, 0.5, -0.3, -1.2, 0.4, 1.1, -0.2};
+  result = solver.solve(arm.endEffector(out), q);
+  for (int i = 0; i < 7; ++i) {
+    EXPECT_GE(q[i], lower[i]);
+    EXPECT_LE(q[i], upper[i]);
+  }
+}
+
+GTEST_TEST(IkSolverTest, UnreachableTarget) {
+  const KinematicChain arm{makeArm()};
+  IkOptions options;
+  options.max_iterations = 30;
+  IkSolver solver{arm, options};
+  double q[]{0., 0., 0., -1.5, 0., 1.5, 0.};
+  const IkResult result{solver.solve(
+      Isometry::fromTranslation(Vector3(3., 0., 0.)), q)};
+  EXPECT_FALSE(result.converged);
+  EXPECT_EQ(result.iterations, 30u);
+  EXPECT_GT(result.position_error, 1.);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace math
+}  // namespace ekumen
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,80 @@
+/* Copyright 2020, Ekumen
+ * Planar isometry library tests
+ * Author: Steven Desvars, 2020
+ */
+
+#include <cmath>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <isometry/isometry2.hpp>
+#include "gtest/gtest.h"
+#include "test_utils.hpp"
+
+namespace ekumen {
+namespace math {
+namespace test {
+namespace {
+
+GTEST_TEST(Isometry2Test, Isometry2FullTests) {
+  const double kTolerance{1e-12};
+  const Isometry2 t1 = Isometry2::fromTranslation(1., 2.);
+  const Isometry2 t2 = Isometry2::fromRotation(M_PI / 2.);
+  const Isometry2 t3{1., 2., M_PI / 4.};
+
+  EXPECT_EQ(Isometry2(), Isometry2(0., 0., 0.));
+  EXPECT_EQ(t1 * Vector3(1., 1., 5.), Vector3(2., 3., 5.));
+  EXPECT_TRUE((t2 * Vector3(1., 0., 0.) - Vector3(0., 1., 0.)).norm() <
+              kTolerance);
+  EXPECT_NEAR(Isometry2(0., 0., 3. * M_PI).theta(), M_PI, kTolerance);
+  EXPECT_NEAR(Isometry2(0., 0., -3. * M_PI / 2.).theta(), M_PI / 2.,
+              kTolerance);
+
+  // Composition and inversion agree with the lifted 3D isometries.
+  EXPECT_TRUE(areAlmostEqual((t1 * t2 * t3).toIsometry(),
+                             t1.toIsometry() * t2.toIsometry() *
+                                 t3.toIsometry(),
+                             kTolerance));
+  EXPECT_TRUE(areAlmostEqual(t3.inverse().toIsometry(),
+                             t3.toIsometry().inverse(), kTolerance));
+  EXPECT_TRUE(areAlmostEqual((t3 * t3.inverse()).toIsometry(), Isometry(),
+                             kTolerance));
+  EXPECT_TRUE(areAlmostEqual(t3.compose(t2).toIsometry(),
+                             Isometry2(1., 2., 3. * M_PI / 4.).toIsometry(),
+                             kTolerance));
+  EXPECT_TRUE(areAlmostEqual(
+      Isometry2(1., 2., 0.3).toIsometry(),
+      Isometry::fromTranslation(Vector3(1., 2., 0.)) *
+          Isometry::rotateAround(Vector3::kUnitZ, 0.3),
+      kTolerance));
+
+  Isometry2 t4 = t1;
+  EXPECT_EQ(t4 *= t2, t1 * t2);
+  EXPECT_NE(t4, t1);
+
+  const std::vector<Vector3> points{
+      Vector3(1., 0., 0.), Vector3(0., 1., 2.), Vector3(-3., 4., -1.)};
+  std::vector<Vector3> transformed(points.size());
+  t3.transform(points.data(), points.size(), transformed.data());
+  for (std::size_t i = 0; i < points.size(); ++i) {
+    EXPECT_TRUE((transformed[i] - t3.toIsometry() * points[i]).norm() <
+                kTolerance);
+    EXPECT_TRUE((transformed[i] - t3.transform(points[i])).norm() <
+                kTolerance);
+  }
+
+  std::stringstream ss;
+  ss << Isometry2(1., 2., 0.5);
+  EXPECT_EQ(ss.str(), "[x: 1, y: 2, theta: 0.5]");
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace math
+}  // namespace ekumen
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
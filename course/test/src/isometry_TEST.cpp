@@ -15,49 +15,13 @@
 
 #include <isometry/isometry.hpp>
 #include "gtest/gtest.h"
+#include "test_utils.hpp"
 
 namespace ekumen {
 namespace math {
 namespace test {
 namespace {
 
-testing::AssertionResult areAlmostEqual(const Isometry &obj1,
-                                        const Isometry &obj2,
-                                        const double tolerance) {
-  if (std::abs(obj1.translation()[0] - obj2.translation()[0]) > tolerance ||
-      std::abs(obj1.translation()[1] - obj2.translation()[1]) > tolerance ||
-      std::abs(obj1.translation()[2] - obj2.translation()[2]) > tolerance ||
-      std::abs(obj1.rotation()[0][0] - obj2.rotation()[0][0]) > tolerance ||
-      std::abs(obj1.rotation()[0][1] - obj2.rotation()[0][1]) > tolerance ||
-      std::abs(obj1.rotation()[0][2] - obj2.rotation()[0][2]) > tolerance ||
-      std::abs(obj1.rotation()[1][0] - obj2.rotation()[1][0]) > tolerance ||
-      std::abs(obj1.rotation()[1][1] - obj2.rotation()[1][1]) > tolerance ||
-      std::abs(obj1.rotation()[1][2] - obj2.rotation()[1][2]) > tolerance ||
-      std::abs(obj1.rotation()[2][0] - obj2.rotation()[2][0]) > tolerance ||
-      std::abs(obj1.rotation()[2][1] - obj2.rotation()[2][1]) > tolerance ||
-      std::abs(obj1.rotation()[2][2] - obj2.rotation()[2][2]) > tolerance) {
-    return testing::AssertionFailure() << "The isometries are not almost equal";
-  }
-  return testing::AssertionSuccess();
-}
-
-testing::AssertionResult areAlmostEqual(const Matrix3 &obj1,
-                                        const Matrix3 &obj2,
-                                        const double tolerance) {
-  if (std::abs(obj1[0][0] - obj2[0][0]) > tolerance ||
-      std::abs(obj1[0][1] - obj2[0][1]) > tolerance ||
-      std::abs(obj1[0][2] - obj2[0][2]) > tolerance ||
-      std::abs(obj1[1][0] - obj2[1][0]) > tolerance ||
-      std::abs(obj1[1][1] - obj2[1][1]) > tolerance ||
-      std::abs(obj1[1][2] - obj2[1][2]) > tolerance ||
-      std::abs(obj1[2][0] - obj2[2][0]) > tolerance ||
-      std::abs(obj1[2][1] - obj2[2][1]) > tolerance ||
-      std::abs(obj1[2][2] - obj2[2][2]) > tolerance) {
-    return testing::AssertionFailure() << "The isometries are not almost equal";
-  }
-  return testing::AssertionSuccess();
-}
-
 GTEST_TEST(IsometryTest, IsometryFullTests) {
   const double kTolerance{1e-12};
   const Isometry t1 = Isometry::fromTranslation(Vector3{1., 2., 3.});
@@ -80,6 +44,15 @@ GTEST_TEST(IsometryTest, IsometryFullTests) {
   const Isometry t6{Isometry::fromEulerAngles(M_PI / 2., M_PI / 4., M_PI / 8.)};
   EXPECT_TRUE(areAlmostEqual(t6, t3 * t4 * t5, kTolerance));
 
+  // Composes translations and rotations.
+  const Isometry t11{Vector3{1., 2., 3.}, t5.rotation()};
+  EXPECT_EQ((t11 * t1) * Vector3(1., 1., 1.),
+            t11 * (t1 * Vector3(1., 1., 1.)));
+  EXPECT_EQ((t1 * t11) * Vector3(1., 1., 1.),
+            t1 * (t11 * Vector3(1., 1., 1.)));
+  EXPECT_TRUE(areAlmostEqual(t11 * t11.inverse(), Isometry(), kTolerance));
+  EXPECT_TRUE(areAlmostEqual(t6.inverse() * t6, Isometry(), kTolerance));
+
   EXPECT_EQ(t3.translation(), Vector3::kZero);
   const double pi_8{M_PI / 8.};
   const double cpi_8{std::cos(pi_8)};  // 0.923879532
@@ -95,6 +68,51 @@ GTEST_TEST(IsometryTest, IsometryFullTests) {
   answer += " [0.382683432, 0.923879533, 0], [0, 0, 1]]]";
   EXPECT_EQ(ss.str(), answer);
 
+  // Rotation vectors and interpolation.
+  const Vector3 axis{Vector3(1., -2., 2.) / 3.};
+  EXPECT_TRUE((Isometry::rotateAround(axis, 0.7).toRotationVector() -
+               axis * 0.7)
+                  .norm() < kTolerance);
+  EXPECT_TRUE(areAlmostEqual(Isometry::fromRotationVector(axis * 2.5),
+                             Isometry::rotateAround(axis, 2.5), kTolerance));
+  EXPECT_TRUE(areAlmostEqual(
+      Isometry::fromRotationVector(
+          Isometry::rotateAround(axis, M_PI - 1e-9).toRotationVector()),
+      Isometry::rotateAround(axis, M_PI - 1e-9), 1e-9));
+  EXPECT_TRUE(areAlmostEqual(
+      Isometry::fromRotationVector(
+          Isometry::rotateAround(axis, M_PI).toRotationVector()),
+      Isometry::rotateAround(axis, M_PI), kTolerance));
+  EXPECT_EQ(Isometry().toRotationVector(), Vector3::kZero);
+  const Isometry from{Vector3(1., 0., 0.), t5.rotation()};
+  const Isometry to{Vector3(3., 2., -2.), t6.rotation()};
+  EXPECT_TRUE(areAlmostEqual(Isometry::interpolate(from, to, 0.), from,
+                             kTolerance));
+  EXPECT_TRUE(
+      areAlmostEqual(Isometry::interpolate(from, to, 1.), to, kTolerance));
+  const Isometry half{Isometry::interpolate(from, to, 0.5)};
+  EXPECT_EQ(half.translation(), Vector3(2., 1., -1.));
+  EXPECT_TRUE(areAlmostEqual(Isometry::interpolate(from, half, 2.), to,
+                             kTolerance));
+  const double fractions[]{-0.2, 0., 0.3, 0.5, 1., 1.7};
+  Isometry interpolated[6];
+  Isometry::interpolate(from, to, fractions, 6, interpolated);
+  for (int i = 0; i < 6; ++i) {
+    EXPECT_TRUE(areAlmostEqual(interpolated[i],
+                               Isometry::interpolate(from, to, fractions[i]),
+                               kTolerance));
+  }
+  Isometry::interpolate(from, from, fractions, 6, interpolated);
+  EXPECT_TRUE(areAlmostEqual(interpolated[5], from, kTolerance));
+
+  const Vector3 points[]{Vector3(1., 0., 0.), Vector3(0., -2., 3.),
+                         Vector3(4., 5., -6.)};
+  Vector3 transformed[3];
+  to.transform(points, 3, transformed);
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_TRUE((transformed[i] - to * points[i]).norm() < kTolerance);
+  }
+
   Isometry t7;
   EXPECT_EQ(t7.rotation()[2][2], 1);
   EXPECT_EQ(t7.translation()[2], 0);
@@ -0,0 +1,134 @@
+/* Copyright 2020, Ekumen
+ * Kinematic chain library tests
+ * Author: Steven Desvars, 2020
+ */
+
+#include <cmath>
+#include <vector>
+
+#include <isometry/kinematic_chain.hpp>
+#include "gtest/gtest.h"
+#include "test_utils.hpp"
+
+namespace ekumen {
+namespace math {
+namespace test {
+namespace {
+
+// Classic Denavit-Hartenberg link transform.
+Isometry dhLink(const double a, const double alpha, const double d,
+                const double theta) {
+  return Isometry::rotateAround(Vector3::kUnitZ, theta) *
+         Isometry::fromTranslation(Vector3(0., 0., d)) *
+         Isometry::fromTranslation(Vector3(a, 0., 0.)) *
+         Isometry::rotateAround(Vector3::kUnitX, alpha);
+}
+
+GTEST_TEST(KinematicChainTest, UrdfJoints) {
+  const double kTolerance{1e-12};
+  const Isometry origin_1{Isometry::fromTranslation(Vector3(0., 0., 0.3))};
+  const Isometry origin_2{Isometry::fromTranslation(Vector3(0.1, 0., 0.2)) *
+                          Isometry::rotateAround(Vector3::kUnitX, 0.5)};
+  const Isometry origin_3{Isometry::fromTranslation(Vector3(0., 0.4, 0.))};
+  const Vector3 tilted{1., 2., -2.};
+  const Isometry tool{Isometry::fromTranslation(Vector3(0., 0., 0.1))};
+
+  KinematicChain chain;
+  EXPECT_EQ(chain.dof(), 0u);
+  EXPECT_EQ(chain.endEffector(nullptr), Isometry());
+  chain.addJoint(JointType::kRevolute, origin_1, Vector3::kUnitZ);
+  chain.addJoint(JointType::kRevolute, origin_2, tilted);
+  chain.addJoint(JointType::kPrismatic, origin_3, tilted);
+  chain.addTip(tool);
+  ASSERT_EQ(chain.dof(), 3u);
+  EXPECT_THROW(chain.addJoint(JointType::kRevolute, Isometry(), Vector3()),
+               std::invalid_argument);
+
+  const Vector3 axis{1. / 3., 2. / 3., -2. / 3.};
+  const double q[]{0.7, -1.2, 0.25};
+  const Isometry link_1{origin_1 * Isometry::rotateAround(Vector3::kUnitZ,
+                                                          q[0])};
+  const Isometry link_2{link_1 * origin_2 *
+                        Isometry::rotateAround(axis, q[1])};
+  const Isometry link_3{link_2 * origin_3 *
+                        Isometry::fromTranslation(axis * q[2])};
+  Isometry poses[3];
+  chain.forwardKinematics(q, poses);
+  EXPECT_TRUE(areAlmostEqual(poses[0], link_1, kTolerance));
+  EXPECT_TRUE(areAlmostEqual(poses[1], link_2, kTolerance));
+  EXPECT_TRUE(areAlmostEqual(poses[2], link_3, kTolerance));
+  EXPECT_TRUE(areAlmostEqual(chain.endEffector(q), link_3 * tool, kTolerance));
+}
+
+GTEST_TEST(KinematicChainTest, DenavitHartenberg) {
+  const double kTolerance{1e-12};
+  // Planar arm with two unit links.
+  KinematicChain planar;
+  planar.addDHJoint(JointType::kRevolute, 1., 0., 0., 0.);
+  planar.addDHJoint(JointType::kRevolute, 1., 0., 0., 0.);
+  const double bent[]{M_PI / 2., -M_PI / 2.};
+  EXPECT_TRUE(areAlmostEqual(planar.endEffector(bent),
+                             Isometry::fromTranslation(Vector3(1., 1., 0.)),
+                             kTolerance));
+
+  // PUMA 560 like parameters, plus a prismatic joint with offsets.
+  const double a[]{0., 0.4318, 0.0203, 0., 0., 0., 0.05};
+  const double alpha[]{M_PI / 2., 0., -M_PI / 2., M_PI / 2., -M_PI / 2., 0.,
+                       0.3};
+  const double d[]{0., 0., 0.15, 0.4318, 0., 0.1, 0.2};
+  const double theta[]{0., 0.1, 0., 0., 0., 0., -0.4};
+  KinematicChain puma;
+  for (int i = 0; i < 6; ++i) {
+    puma.addDHJoint(JointType::kRevolute, a[i], alpha[i], d[i], theta[i]);
+  }
+  puma.addDHJoint(JointType::kPrismatic, a[6], alpha[6], d[6], theta[6]);
+  ASSERT_EQ(puma.dof(), 7u);
+
+  const double q[]{0.3, -0.8, 1.1, 2.5, -0.4, 0.9, 0.12};
+  Isometry expected;
+  for (int i = 0; i < 6; ++i) {
+    expected *= dhLink(a[i], alpha[i], d[i], theta[i] + q[i]);
+  }
+  expected *= dhLink(a[6], alpha[6], d[6] + q[6], theta[6]);
+  EXPECT_TRUE(areAlmostEqual(puma.endEffector(q), expected, kTolerance));
+}
+
+GTEST_TEST(KinematicChainTest, BatchedConfigurations) {
+  KinematicChain chain;
+  chain.addDHJoint(JointType::kRevolute, 0., M_PI / 2., 0.3, 0.);
+  chain.addDHJoint(JointType::kRevolute, 0.5, 0., 0., 0.2);
+  chain.addDHJoint(JointType::kPrismatic, 0., -M_PI / 2., 0.1, 0.);
+  chain.addDHJoint(JointType::kRevolute, 0., M_PI / 2., 0.4, 0.);
+  chain.addTip(Isometry::fromTranslation(Vector3(0., 0., 0.05)));
+
+  // Spans several chunks, the last one partial.
+  const std::size_t kCount{150};
+  std::vector<double> configurations(kCount * chain.dof());
+  for (std::size_t i = 0; i < configurations.size(); ++i) {
+    configurations[i] = std::sin(0.37 * i) * 3.;
+  }
+  std::vector<Isometry> poses(kCount);
+  chain.endEffectors(configurations.data(), kCount, poses.data());
+  for (std::size_t i = 0; i < kCount; ++i) {
+    EXPECT_TRUE(areAlmostEqual(
+        poses[i], chain.endEffector(&configurations[i * chain.dof()]),
+        1e-12));
+  }
+  chain.endEffectors(configurations.data(), kCount, poses.data(),
+                     SinCosAccuracy::kFast);
+  for (std::size_t i = 0; i < kCount; ++i) {
+    EXPECT_TRUE(areAlmostEqual(
+        poses[i], chain.endEffector(&configurations[i * chain.dof()]),
+        1e-5));
+  }
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace math
+}  // namespace ekumen
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
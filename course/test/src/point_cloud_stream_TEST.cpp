@@ -0,0 +1,203 @@
+/* Copyright 2020, Ekumen
+ * Point cloud streaming library tests
+ * Author: Steven Desvars, 2020
+ */
+
+#include <unistd.h>
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <isometry/point_cloud_stream.hpp>
+#include "gtest/gtest.h"
+#include "test_utils.hpp"
+
+namespace ekumen {
+namespace math {
+namespace test {
+namespace {
+
+void writeFile(const std::string& r_path, const std::string& r_contents) {
+  std::ofstream file{r_path, std::ios::binary};
+  file.write(r_contents.data(), r_contents.size());
+}
+
+std::string readFile(const std::string& r_path) {
+  std::ifstream file{r_path, std::ios::binary};
+  return std::string(std::istreambuf_iterator<char>(file),
+                     std::istreambuf_iterator<char>());
+}
+
+template <class T>
+void put(const T value, std::string* r_out) {
+  char bytes[sizeof(T)];
+  std::memcpy(bytes, &value, sizeof(T));
+  r_out->append(bytes, sizeof(T));
+}
+
+template <class T>
+T get(const std::string& r_bytes, const std::size_t offset) {
+  T value;
+  std::memcpy(&value, r_bytes.data() + offset, sizeof(T));
+  return value;
+}
+
+Vector3 point(const int i) {
+  return Vector3(0.5 * i, std::sin(i), -0.25 * i);
+}
+
+const Isometry kIsometry{Isometry::fromTranslation(Vector3(1., -2., 3.)) *
+                         Isometry::fromEulerAngles(0.3, -0.2, 1.1)};
+
+GTEST_TEST(PointCloudStreamTest, Ply) {
+  const int kPoints{100};
+  const std::string header{
+      "ply\n"
+      "format binary_little_endian 1.0\n"
+      "comment made by hand\n"
+      "element vertex 100\n"
+      "property float x\n"
+      "property uchar red\n"
+      "property double y\n"
+      "property float z\n"
+      "element face 1\n"
+      "property list uchar int vertex_indices\n"
+      "end_header\n"};
+  const std::size_t kStride{4 + 1 + 8 + 4};
+  std::string contents{header};
+  for (int i = 0; i < kPoints; ++i) {
+    const Vector3 p{point(i)};
+    put(static_cast<float>(p.x()), &contents);
+    put(static_cast<unsigned char>(i), &contents);
+    put(p.y(), &contents);
+    put(static_cast<float>(p.z()), &contents);
+  }
+  const std::string face{"\x03\x00\x00\x00\x00\x01\x00\x00\x00\x02\x00\x00\x00",
+                         13};
+  contents += face;
+  const std::string input{temporaryPath("cloud_in.ply")};
+  const std::string output{temporaryPath("cloud_out.ply")};
+  writeFile(input, contents);
+
+  const CloudTransformStats stats{transformCloud(input, output, kIsometry, 7)};
+  EXPECT_EQ(stats.points, 100u);
+  // 15 chunks of points and one with the face.
+  EXPECT_EQ(stats.chunks, 16u);
+
+  const std::string result{readFile(output)};
+  ASSERT_EQ(result.size(), contents.size());
+  EXPECT_EQ(result.substr(0, header.size()), header);
+  EXPECT_EQ(result.substr(result.size() - face.size()), face);
+  for (int i = 0; i < kPoints; ++i) {
+    const std::size_t offset = header.size() + i * kStride;
+    const Vector3 p{point(i)};
+    const Vector3 expected{kIsometry * Vector3(static_cast<float>(p.x()),
+                                               p.y(),
+                                               static_cast<float>(p.z()))};
+    EXPECT_EQ(get<float>(result, offset), static_cast<float>(expected.x()));
+    EXPECT_EQ(get<unsigned char>(result, offset + 4), i % 256);
+    EXPECT_NEAR(get<double>(result, offset + 5), expected.y(), 1e-12);
+    EXPECT_EQ(get<float>(result, offset + 13),
+              static_cast<float>(expected.z()));
+  }
+  std::remove(input.c_str());
+  std::remove(output.c_str());
+}
+
+GTEST_TEST(PointCloudStreamTest, Xyz) {
+  std::string contents;
+  for (int i = 0; i < 1000; ++i) {
+    const Vector3 p{point(i)};
+    put(static_cast<float>(p.x()), &contents);
+    put(static_cast<float>(p.y()), &contents);
+    put(static_cast<float>(p.z()), &contents);
+  }
+  const std::string input{temporaryPath("cloud_in.xyz")};
+  const std::string output{temporaryPath("cloud_out.xyz")};
+  writeFile(input, contents);
+
+  for (const std::size_t chunk_points : {1u, 64u, 1000u, 5000u}) {
+    const CloudTransformStats stats{
+        transformCloud(input, output, kIsometry, chunk_points)};
+    EXPECT_EQ(stats.points, 1000u);
+    EXPECT_EQ(stats.chunks, (1000 + chunk_points - 1) / chunk_points);
+    const std::string result{readFile(output)};
+    ASSERT_EQ(result.size(), contents.size());
+    for (int i = 0; i < 1000; ++i) {
+      const Vector3 expected{
+          kIsometry * Vector3(get<float>(contents, 12 * i),
+                              get<float>(contents, 12 * i + 4),
+                              get<float>(contents, 12 * i + 8))};
+      EXPECT_EQ(get<float>(result, 12 * i), static_cast<float>(expected.x()));
+      EXPECT_EQ(get<float>(result, 12 * i + 4),
+                static_cast<float>(expected.y()));
+      EXPECT_EQ(get<float>(result, 12 * i + 8),
+                static_cast<float>(expected.z()));
+    }
+  }
+
+  // An empty cloud gives an empty cloud.
+  writeFile(input, "");
+  EXPECT_EQ(transformCloud(input, output, kIsometry).points, 0u);
+  EXPECT_TRUE(readFile(output).empty());
+  std::remove(input.c_str());
+  std::remove(output.c_str());
+}
+
+GTEST_TEST(PointCloudStreamTest, Errors) {
+  const std::string input{temporaryPath("bad_in")};
+  const std::string output{temporaryPath("bad_out")};
+  EXPECT_THROW(transformCloud(input, output, kIsometry), std::system_error);
+
+  // A partial point.
+  writeFile(input, std::string(12 * 5 + 4, '\0'));
+  EXPECT_THROW(transformCloud(input, output, kIsometry, 2),
+               std::invalid_argument);
+  EXPECT_THROW(transformCloud(input, output, kIsometry, 0),
+               std::invalid_argument);
+  // Writing over the input, by name or through a hard link, would lose it.
+  EXPECT_THROW(transformCloud(input, input, kIsometry, 5),
+               std::invalid_argument);
+  std::remove(output.c_str());
+  ASSERT_EQ(::link(input.c_str(), output.c_str()), 0);
+  EXPECT_THROW(transformCloud(input, output, kIsometry, 5),
+               std::invalid_argument);
+  EXPECT_EQ(readFile(input).size(), 12u * 5 + 4);
+  std::remove(output.c_str());
+
+  const std::string vertices{"element vertex 3\nproperty float x\n"
+                             "property float y\nproperty float z\n"};
+  writeFile(input, "ply\nformat ascii 1.0\n" + vertices + "end_header\n");
+  EXPECT_THROW(transformCloud(input, output, kIsometry),
+               std::invalid_argument);
+  writeFile(input, "ply\nformat binary_little_endian 1.0\n" + vertices);
+  EXPECT_THROW(transformCloud(input, output, kIsometry),
+               std::invalid_argument);
+  writeFile(input, "ply\nformat binary_little_endian 1.0\nelement vertex 1\n"
+                   "property float x\nproperty float y\nend_header\n" +
+                       std::string(8, '\0'));
+  EXPECT_THROW(transformCloud(input, output, kIsometry),
+               std::invalid_argument);
+  // Fewer points than announced.
+  writeFile(input, "ply\nformat binary_little_endian 1.0\n" + vertices +
+                       "end_header\n" + std::string(12 * 2, '\0'));
+  EXPECT_THROW(transformCloud(input, output, kIsometry),
+               std::invalid_argument);
+  std::remove(input.c_str());
+  std::remove(output.c_str());
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace math
+}  // namespace ekumen
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
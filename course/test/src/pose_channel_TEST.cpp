@@ -0,0 +1,168 @@
+/* Copyright 2020, Ekumen
+ * Pose channel library tests
+ * Author: Steven Desvars, 2020
+ */
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <isometry/pose_channel.hpp>
+#include "gtest/gtest.h"
+#include "test_utils.hpp"
+
+namespace ekumen {
+namespace math {
+namespace test {
+namespace {
+
+std::string channelName(const std::string& r_name) {
+  return "/ekumen_" + r_name + "_" + std::to_string(::getpid());
+}
+
+// Reads a channel while another process publishes to it.
+// @returns Exit status, 0 if every pose read was consistent.
+int readWhilePublished(const std::string& r_name, const int ready_fd,
+                       const std::uint64_t count) {
+  const PoseChannelReader reader{r_name};
+  const char ready{'r'};
+  if (::write(ready_fd, &ready, 1) != 1) {
+    return 1;
+  }
+  double last{-1.};
+  std::uint64_t reads{0};
+  while (reader.published() < count) {
+    double timestamp;
+    Isometry pose;
+    if (!reader.latest(&timestamp, &pose)) {
+      continue;
+    }
+    if (timestamp < last || !areEqual(pose, motion(timestamp))) {
+      return 2;
+    }
+    last = timestamp;
+    ++reads;
+  }
+  std::vector<double> timestamps(reader.history());
+  std::vector<Isometry> poses(reader.history());
+  const std::size_t read =
+      reader.recent(reader.history(), timestamps.data(), poses.data());
+  if (read != reader.history()) {
+    return 3;
+  }
+  for (std::size_t i = 0; i < read; ++i) {
+    const double expected{static_cast<double>(count - read + i)};
+    if (timestamps[i] != expected || !areEqual(poses[i], motion(expected))) {
+      return 4;
+    }
+  }
+  return reads > 0 ? 0 : 5;
+}
+
+GTEST_TEST(PoseChannelTest, AnotherProcessReadsConsistentPoses) {
+  const std::uint64_t kCount{200000};
+  const std::string name{channelName("processes")};
+  PoseChannelWriter writer{name, 256};
+  int ready[2];
+  ASSERT_EQ(::pipe(ready), 0);
+  const pid_t child = ::fork();
+  ASSERT_GE(child, 0);
+  if (child == 0) {
+    ::close(ready[0]);
+    ::_exit(readWhilePublished(name, ready[1], kCount));
+  }
+  ::close(ready[1]);
+  char byte;
+  ASSERT_EQ(::read(ready[0], &byte, 1), 1);
+  ::close(ready[0]);
+  for (std::uint64_t i = 0; i < kCount; ++i) {
+    writer.publish(static_cast<double>(i), motion(static_cast<double>(i)));
+  }
+  int status;
+  ASSERT_EQ(::waitpid(child, &status, 0), child);
+  ASSERT_TRUE(WIFEXITED(status));
+  EXPECT_EQ(WEXITSTATUS(status), 0);
+}
+
+GTEST_TEST(PoseChannelTest, KeepsTheMostRecentPosesInItsHistory) {
+  const std::string name{channelName("history")};
+  PoseChannelWriter writer{name, 4};
+  const PoseChannelReader reader{name};
+  EXPECT_EQ(reader.history(), 4u);
+  double timestamp;
+  Isometry pose;
+  EXPECT_FALSE(reader.latest(&timestamp, &pose));
+  EXPECT_FALSE(reader.at(0, &timestamp, &pose));
+
+  for (int i = 0; i < 10; ++i) {
+    writer.publish(i, motion(i));
+  }
+  EXPECT_EQ(writer.published(), 10u);
+  EXPECT_EQ(reader.published(), 10u);
+  ASSERT_TRUE(reader.latest(&timestamp, &pose));
+  EXPECT_EQ(timestamp, 9.);
+  EXPECT_TRUE(areEqual(pose, motion(9.)));
+  EXPECT_FALSE(reader.at(5, &timestamp, &pose));
+  EXPECT_FALSE(reader.at(10, &timestamp, &pose));
+  for (int i = 6; i < 10; ++i) {
+    ASSERT_TRUE(reader.at(i, &timestamp, &pose));
+    EXPECT_EQ(timestamp, i);
+    EXPECT_TRUE(areEqual(pose, motion(i)));
+  }
+
+  double timestamps[8];
+  Isometry poses[8];
+  ASSERT_EQ(reader.recent(8, timestamps, poses), 4u);
+  EXPECT_EQ(timestamps[0], 6.);
+  EXPECT_EQ(timestamps[3], 9.);
+  ASSERT_EQ(reader.recent(2, timestamps, poses), 2u);
+  EXPECT_EQ(timestamps[0], 8.);
+  EXPECT_TRUE(areEqual(poses[1], motion(9.)));
+}
+
+GTEST_TEST(PoseChannelTest, ReadersOutliveTheWriter) {
+  const std::string name{channelName("outlive")};
+  std::unique_ptr<PoseChannelWriter> writer{new PoseChannelWriter(name, 8)};
+  writer->publish(1., motion(1.));
+  const PoseChannelReader reader{name};
+  writer.reset();
+  double timestamp;
+  Isometry pose;
+  ASSERT_TRUE(reader.latest(&timestamp, &pose));
+  EXPECT_EQ(timestamp, 1.);
+  EXPECT_THROW(PoseChannelReader{name}, std::system_error);
+}
+
+GTEST_TEST(PoseChannelTest, RejectsInvalidChannels) {
+  EXPECT_THROW(PoseChannelWriter("no_slash"), std::invalid_argument);
+  EXPECT_THROW(PoseChannelWriter("/two/slashes"), std::invalid_argument);
+  EXPECT_THROW(PoseChannelWriter("/"), std::invalid_argument);
+  EXPECT_THROW(PoseChannelWriter(channelName("empty"), 0),
+               std::invalid_argument);
+  EXPECT_THROW(PoseChannelReader{channelName("missing")}, std::system_error);
+
+  const std::string name{channelName("foreign")};
+  const int fd = ::shm_open(name.c_str(), O_CREAT | O_RDWR, 0600);
+  ASSERT_GE(fd, 0);
+  ASSERT_EQ(::ftruncate(fd, 4096), 0);
+  ::close(fd);
+  EXPECT_THROW(PoseChannelReader{name}, std::invalid_argument);
+  ::shm_unlink(name.c_str());
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace math
+}  // namespace ekumen
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
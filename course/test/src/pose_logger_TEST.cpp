@@ -0,0 +1,222 @@
+/* Copyright 2020, Ekumen
+ * Pose logger library tests
+ * Author: Steven Desvars, 2020
+ */
+
+#include <unistd.h>
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <isometry/binary.hpp>
+#include <isometry/format.hpp>
+#include <isometry/pose_logger.hpp>
+#include "gtest/gtest.h"
+#include "test_utils.hpp"
+
+namespace ekumen {
+namespace math {
+namespace test {
+namespace {
+
+std::vector<unsigned char> readFile(const std::string& r_path) {
+  std::ifstream file{r_path, std::ios::binary};
+  return std::vector<unsigned char>(std::istreambuf_iterator<char>(file),
+                                    std::istreambuf_iterator<char>());
+}
+
+struct LoggedRecord {
+  double timestamp;
+  std::uint64_t channel;
+  Isometry pose;
+};
+
+std::vector<LoggedRecord> readBinaryLog(const std::string& r_path) {
+  const std::vector<unsigned char> bytes{readFile(r_path)};
+  EXPECT_EQ(bytes.size() % kPoseLogRecordSize, 0u);
+  std::vector<LoggedRecord> records(bytes.size() / kPoseLogRecordSize);
+  for (std::size_t i = 0; i < records.size(); ++i) {
+    const unsigned char* record = bytes.data() + i * kPoseLogRecordSize;
+    internal::loadDoubles(record, 1, &records[i].timestamp);
+    records[i].channel = internal::loadInteger(record + 8, 8);
+    internal::load(record + 16, &records[i].pose);
+  }
+  return records;
+}
+
+GTEST_TEST(PoseLoggerTest, WritesBinaryRecords) {
+  const std::string path{temporaryPath("binary")};
+  {
+    PoseLoggerOptions options;
+    options.capacity = 64;
+    options.batch_size = 7;
+    PoseLogger logger{path, options};
+    for (int i = 0; i < 1000; ++i) {
+      ASSERT_TRUE(logger.log(0.01 * i, motion(0.01 * i), i % 3));
+    }
+    logger.close();
+    const PoseLoggerStats stats{logger.stats()};
+    EXPECT_EQ(stats.logged, 1000u);
+    EXPECT_EQ(stats.dropped, 0u);
+    EXPECT_EQ(stats.written, 1000u);
+    EXPECT_GT(stats.max_enqueue_ns, 0u);
+    EXPECT_FALSE(logger.log(10., Isometry()));
+  }
+  const std::vector<LoggedRecord> records{readBinaryLog(path)};
+  ASSERT_EQ(records.size(), 1000u);
+  for (int i = 0; i < 1000; ++i) {
+    EXPECT_EQ(records[i].timestamp, 0.01 * i);
+    EXPECT_EQ(records[i].channel, static_cast<std::uint64_t>(i % 3));
+    EXPECT_TRUE(areEqual(records[i].pose, motion(0.01 * i)));
+  }
+  std::remove(path.c_str());
+}
+
+GTEST_TEST(PoseLoggerTest, WritesTextLinesThatRoundTrip) {
+  const std::string path{temporaryPath("text")};
+  {
+    PoseLoggerOptions options;
+    options.format = PoseLogFormat::kText;
+    PoseLogger logger{path, options};
+    for (int i = 0; i < 100; ++i) {
+      logger.log(0.1 * i + 1e-7, motion(0.37 * i), 18446744073709551615u);
+    }
+  }
+  std::ifstream file{path};
+  std::string line;
+  int count = 0;
+  while (std::getline(file, line)) {
+    char* end;
+    EXPECT_EQ(std::strtod(line.c_str(), &end), 0.1 * count + 1e-7);
+    EXPECT_EQ(std::string(end + 1, 21), "18446744073709551615 ");
+    const char* pose = end + 22;
+    Isometry parsed;
+    EXPECT_EQ(parse(pose, line.size() - (pose - line.c_str()), &parsed),
+              line.size() - (pose - line.c_str()));
+    EXPECT_TRUE(areEqual(parsed, motion(0.37 * count)));
+    ++count;
+  }
+  EXPECT_EQ(count, 100);
+  std::remove(path.c_str());
+}
+
+GTEST_TEST(PoseLoggerTest, BlockingKeepsEveryRecordOfEveryThread) {
+  const int kThreads{4};
+  const int kRecords{20000};
+  const std::string path{temporaryPath("block")};
+  PoseLoggerOptions options;
+  options.capacity = 16;
+  options.overflow = PoseLogOverflow::kBlock;
+  PoseLogger logger{path, options};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([&logger, t]() {
+      for (int i = 0; i < kRecords; ++i) {
+        logger.log(i, motion(0.001 * i), t);
+      }
+    });
+  }
+  for (std::thread& r_thread : threads) {
+    r_thread.join();
+  }
+  logger.flush();
+  EXPECT_EQ(logger.stats().written, static_cast<std::uint64_t>(kThreads) *
+                                        kRecords);
+  logger.close();
+  EXPECT_EQ(logger.stats().dropped, 0u);
+
+  // Records of a thread keep their order.
+  const std::vector<LoggedRecord> records{readBinaryLog(path)};
+  ASSERT_EQ(records.size(), static_cast<std::size_t>(kThreads * kRecords));
+  std::vector<double> last(kThreads, -1.);
+  for (const LoggedRecord& r_record : records) {
+    ASSERT_LT(r_record.channel, static_cast<std::uint64_t>(kThreads));
+    EXPECT_EQ(r_record.timestamp, last[r_record.channel] + 1.);
+    last[r_record.channel] = r_record.timestamp;
+  }
+  std::remove(path.c_str());
+}
+
+GTEST_TEST(PoseLoggerTest, DropPoliciesAccountForEveryRecord) {
+  const int kRecords{50000};
+  const std::string path{temporaryPath("drop")};
+  {
+    PoseLoggerOptions options;
+    options.capacity = 2;
+    options.overflow = PoseLogOverflow::kDropNewest;
+    PoseLogger logger{path, options};
+    int accepted = 0;
+    for (int i = 0; i < kRecords; ++i) {
+      accepted += logger.log(i, motion(0.001 * i)) ? 1 : 0;
+    }
+    logger.close();
+    const PoseLoggerStats stats{logger.stats()};
+    EXPECT_EQ(stats.logged, static_cast<std::uint64_t>(accepted));
+    EXPECT_EQ(stats.logged + stats.dropped,
+              static_cast<std::uint64_t>(kRecords));
+    EXPECT_EQ(stats.written, stats.logged);
+    EXPECT_EQ(readBinaryLog(path).size(), stats.written);
+  }
+  {
+    PoseLoggerOptions options;
+    options.capacity = 2;
+    options.overflow = PoseLogOverflow::kDropOldest;
+    PoseLogger logger{path, options};
+    for (int i = 0; i < kRecords; ++i) {
+      EXPECT_TRUE(logger.log(i, motion(0.001 * i)));
+    }
+    logger.flush();
+    logger.close();
+    const PoseLoggerStats stats{logger.stats()};
+    EXPECT_EQ(stats.logged, static_cast<std::uint64_t>(kRecords));
+    EXPECT_EQ(stats.written + stats.dropped, stats.logged);
+
+    // The newest record always survives.
+    const std::vector<LoggedRecord> records{readBinaryLog(path)};
+    ASSERT_EQ(records.size(), stats.written);
+    EXPECT_EQ(records.back().timestamp, kRecords - 1.);
+  }
+  std::remove(path.c_str());
+}
+
+GTEST_TEST(PoseLoggerTest, RejectsInvalidConfigurations) {
+  const std::string path{temporaryPath("invalid")};
+  PoseLoggerOptions options;
+  options.capacity = 100;
+  EXPECT_THROW(PoseLogger(path, options), std::invalid_argument);
+  options.capacity = 64;
+  options.batch_size = 0;
+  EXPECT_THROW(PoseLogger(path, options), std::invalid_argument);
+  EXPECT_THROW(PoseLogger("/nonexistent/directory/poses.log"),
+               std::system_error);
+  std::remove(path.c_str());
+}
+
+GTEST_TEST(PoseLoggerTest, DropsRecordsAfterAWriteError) {
+  PoseLogger logger{"/dev/full"};
+  EXPECT_TRUE(logger.log(0., Isometry(), 0));
+  EXPECT_THROW(logger.flush(), std::system_error);
+  // The queue has room, but nothing would write the record.
+  EXPECT_FALSE(logger.log(1., Isometry(), 0));
+  EXPECT_EQ(logger.stats().logged, 1u);
+  EXPECT_EQ(logger.stats().dropped, 1u);
+  EXPECT_THROW(logger.close(), std::system_error);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace math
+}  // namespace ekumen
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,139 @@
+/* Copyright 2020, Ekumen
+ * Quantized point cloud library tests
+ * Author: Steven Desvars, 2020
+ */
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include <isometry/quantized_cloud.hpp>
+#include "gtest/gtest.h"
+
+namespace ekumen {
+namespace math {
+namespace test {
+namespace {
+
+double distance(const Vector3& r_a, const Vector3& r_b) {
+  return std::sqrt((r_a.x() - r_b.x()) * (r_a.x() - r_b.x()) +
+                   (r_a.y() - r_b.y()) * (r_a.y() - r_b.y()) +
+                   (r_a.z() - r_b.z()) * (r_a.z() - r_b.z()));
+}
+
+// Scan-like cloud: consecutive points are close, the whole cloud spans a
+// 200 m tile far from the origin.
+std::vector<Vector3> mapTile(const std::size_t count) {
+  std::mt19937 generator{7};
+  std::uniform_real_distribution<double> noise{-0.5, 0.5};
+  std::vector<Vector3> points;
+  for (std::size_t i = 0; i < count; ++i) {
+    const double t = 1e-3 * i;
+    points.emplace_back(4000. + 100. * std::cos(t) + noise(generator),
+                        -2500. + 100. * std::sin(3. * t) + noise(generator),
+                        12. + noise(generator));
+  }
+  return points;
+}
+
+const Isometry kPose{Isometry::fromTranslation(Vector3(-4000., 2500., 1.)) *
+                     Isometry::fromEulerAngles(0.1, -0.2, 2.5)};
+
+template <class Cloud>
+void checkCloud(const double max_error) {
+  const std::vector<Vector3> points{mapTile(10000)};
+  const Cloud cloud{points.data(), points.size(), 512};
+  ASSERT_EQ(cloud.size(), points.size());
+  EXPECT_EQ(cloud.blocks(), 20u);
+  EXPECT_LT(cloud.maxError(), max_error);
+
+  std::vector<Vector3> decoded(points.size());
+  cloud.decode(0, points.size(), decoded.data());
+  for (std::size_t i = 0; i < points.size(); ++i) {
+    ASSERT_LE(distance(decoded[i], points[i]), cloud.maxError()) << i;
+  }
+  EXPECT_EQ(distance(cloud.point(777), decoded[777]), 0.);
+
+  // The fused kernel matches decoding then transforming, on a range that
+  // straddles blocks.
+  std::vector<Vector3> transformed(3000);
+  cloud.transform(kPose, 1000, 3000, transformed.data());
+  for (std::size_t i = 0; i < transformed.size(); ++i) {
+    ASSERT_LT(distance(transformed[i], kPose * decoded[1000 + i]), 1e-9);
+    ASSERT_LE(distance(transformed[i], kPose * points[1000 + i]),
+              cloud.maxError());
+  }
+
+  const Cloud moved{cloud.transformed(kPose)};
+  ASSERT_EQ(moved.size(), cloud.size());
+  EXPECT_GE(moved.maxError(), cloud.maxError());
+  for (std::size_t i = 0; i < points.size(); ++i) {
+    ASSERT_LE(distance(moved.point(i), kPose * points[i]), moved.maxError())
+        << i;
+  }
+}
+
+GTEST_TEST(QuantizedCloudTest, Int16RoundTripsWithinItsBound) {
+  checkCloud<QuantizedCloud16>(1e-2);
+}
+
+GTEST_TEST(QuantizedCloudTest, Int32RoundTripsWithinItsBound) {
+  checkCloud<QuantizedCloud32>(1e-6);
+}
+
+GTEST_TEST(QuantizedCloudTest, UsesLessMemory) {
+  const std::vector<Vector3> points{mapTile(100000)};
+  const QuantizedCloud16 cloud16{points.data(), points.size()};
+  const QuantizedCloud32 cloud32{points.data(), points.size()};
+  const double full = points.size() * sizeof(Vector3);
+  EXPECT_GT(full / cloud16.memory(), 3.9);
+  EXPECT_GT(full / cloud32.memory(), 1.95);
+}
+
+GTEST_TEST(QuantizedCloudTest, HandlesDegenerateClouds) {
+  const QuantizedCloud16 empty;
+  EXPECT_TRUE(empty.empty());
+  EXPECT_EQ(empty.blocks(), 0u);
+  EXPECT_EQ(empty.transformed(kPose).size(), 0u);
+
+  const std::vector<Vector3> same(100, Vector3(1.5, -2., 3.));
+  const QuantizedCloud16 flat{same.data(), same.size(), 64};
+  EXPECT_EQ(flat.blocks(), 2u);
+  for (std::size_t i = 0; i < same.size(); ++i) {
+    EXPECT_EQ(distance(flat.point(i), same[i]), 0.);
+  }
+}
+
+GTEST_TEST(QuantizedCloudTest, RejectsInvalidInput) {
+  std::vector<Vector3> points{mapTile(10)};
+  EXPECT_THROW(QuantizedCloud16(points.data(), points.size(), 0),
+               std::invalid_argument);
+  EXPECT_THROW(QuantizedCloud16(nullptr, 0, 0), std::invalid_argument);
+  const QuantizedCloud16 single{
+      points.data(), points.size(), std::numeric_limits<std::size_t>::max()};
+  EXPECT_EQ(single.blocks(), 1u);
+  EXPECT_LE(distance(single.point(3), points[3]), single.maxError());
+  points[5] = Vector3(std::numeric_limits<double>::quiet_NaN(), 0., 0.);
+  EXPECT_THROW(QuantizedCloud16(points.data(), points.size()),
+               std::invalid_argument);
+
+  const std::vector<Vector3> valid{mapTile(10)};
+  const QuantizedCloud32 cloud{valid.data(), valid.size()};
+  Vector3 out[10];
+  EXPECT_THROW(cloud.point(10), std::out_of_range);
+  EXPECT_THROW(cloud.decode(5, 6, out), std::out_of_range);
+  EXPECT_THROW(cloud.transform(kPose, 11, 0, out), std::out_of_range);
+  EXPECT_NO_THROW(cloud.transform(kPose, 10, 0, out));
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace math
+}  // namespace ekumen
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
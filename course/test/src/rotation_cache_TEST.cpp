@@ -0,0 +1,97 @@
+/* Copyright 2020, Ekumen
+ * Rotation cache library tests
+ * Author: Steven Desvars, 2020
+ */
+
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <isometry/rotation_cache.hpp>
+#include "gtest/gtest.h"
+#include "test_utils.hpp"
+
+namespace ekumen {
+namespace math {
+namespace test {
+namespace {
+
+GTEST_TEST(RotationCacheTest, RotationCacheFullTests) {
+  const double kTolerance{1e-12};
+  const std::size_t kResolution{4096};
+  const Vector3 tilted = Vector3(1., 1., 0.) / Vector3(1., 1., 0.).norm();
+  const RotationCache cache{{Vector3::kUnitZ, tilted}, kResolution};
+
+  EXPECT_EQ(cache.resolution(), kResolution);
+  EXPECT_EQ(cache.axisCount(), 2u);
+  EXPECT_EQ(cache.memoryFootprint(), 2 * kResolution * sizeof(Matrix3));
+
+  const double step = 2. * M_PI / kResolution;
+  for (const long tick : {0l, 1l, 17l, 1024l, 4095l}) {
+    EXPECT_TRUE(areAlmostEqual(
+        cache.rotation(0, tick),
+        Isometry::rotateAround(Vector3::kUnitZ, tick * step).rotation(),
+        kTolerance));
+    EXPECT_TRUE(areAlmostEqual(
+        cache.rotation(1, tick),
+        Isometry::rotateAround(tilted, tick * step).rotation(), kTolerance));
+  }
+
+  // Ticks wrap around every revolution.
+  EXPECT_TRUE(areAlmostEqual(cache.rotation(0, -1),
+                             cache.rotation(0, kResolution - 1), kTolerance));
+  EXPECT_TRUE(areAlmostEqual(cache.rotation(0, kResolution + 3),
+                             cache.rotation(0, 3), kTolerance));
+
+  // Angles are rounded to the nearest step.
+  EXPECT_TRUE(areAlmostEqual(
+      cache.rotateAround(0, 17.4 * step).rotation(),
+      cache.rotation(0, 17), kTolerance));
+  EXPECT_TRUE(areAlmostEqual(
+      cache.rotateAround(1, -2. * M_PI - 3. * step).rotation(),
+      cache.rotation(1, -3), kTolerance));
+  EXPECT_EQ(cache.rotateAround(0, 1.).translation(), Vector3::kZero);
+
+  EXPECT_ANY_THROW(cache.rotation(2, 0));
+  for (const double angle : {INFINITY, -INFINITY, NAN}) {
+    EXPECT_THROW(cache.rotateAround(0, angle), std::invalid_argument);
+  }
+  EXPECT_ANY_THROW(RotationCache({}, kResolution));
+  EXPECT_ANY_THROW(RotationCache({Vector3::kUnitX}, 0));
+  EXPECT_ANY_THROW(
+      RotationCache({Vector3::kUnitX}, RotationCache::kMaxEntries + 1));
+}
+
+GTEST_TEST(RotationCacheTest, SharedAcrossThreads) {
+  const std::shared_ptr<const RotationCache> cache =
+      std::make_shared<const RotationCache>(
+          std::vector<Vector3>{Vector3::kUnitX}, 1000);
+  std::vector<std::thread> readers;
+  std::vector<double> traces(4, 0.);
+  for (std::size_t i = 0; i < traces.size(); ++i) {
+    readers.emplace_back([&cache, &traces, i]() {
+      for (long tick = 0; tick < 1000; ++tick) {
+        const Matrix3 &rotation = cache->rotation(0, tick);
+        traces[i] += rotation[0][0] + rotation[1][1] + rotation[2][2];
+      }
+    });
+  }
+  for (std::thread &reader : readers) {
+    reader.join();
+  }
+  for (const double trace : traces) {
+    EXPECT_NEAR(trace, traces[0], 1e-9);
+  }
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace math
+}  // namespace ekumen
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,106 @@
+/* Copyright 2020, Ekumen
+ * Sine and cosine kernels tests
+ * Author: Steven Desvars, 2020
+ */
+
+#include <cmath>
+#include <vector>
+
+#include <isometry/internal/sincos.hpp>
+#include <isometry/isometry.hpp>
+#include "gtest/gtest.h"
+
+namespace ekumen {
+namespace math {
+namespace test {
+namespace {
+
+double maxError(const SinCosAccuracy accuracy,
+                const std::vector<double> &angles) {
+  std::vector<double> sines(angles.size());
+  std::vector<double> cosines(angles.size());
+  internal::sincos(angles.data(), angles.size(), sines.data(), cosines.data(),
+                   accuracy);
+  double error{0.};
+  for (std::size_t i = 0; i < angles.size(); ++i) {
+    error = std::max(error, std::abs(sines[i] - std::sin(angles[i])));
+    error = std::max(error, std::abs(cosines[i] - std::cos(angles[i])));
+  }
+  return error;
+}
+
+GTEST_TEST(SinCosTest, AccuracyTiers) {
+  std::vector<double> angles;
+  for (int i = -20000; i <= 20000; ++i) {
+    angles.push_back(i * 1e-3 * M_PI);
+  }
+  angles.push_back(M_PI / 4.);
+  angles.push_back(-M_PI / 4.);
+  angles.push_back(12345.678);
+  angles.push_back(-1e7);
+  angles.push_back(3e12);
+
+  EXPECT_LT(maxError(SinCosAccuracy::kFull, angles), 1e-15);
+  EXPECT_LT(maxError(SinCosAccuracy::kHigh, angles), 1e-9);
+  EXPECT_LT(maxError(SinCosAccuracy::kFast, angles), 1e-6);
+
+  double sine{0.};
+  double cosine{0.};
+  internal::sincos(M_PI / 2., &sine, &cosine, SinCosAccuracy::kFull);
+  EXPECT_NEAR(sine, 1., 1e-16);
+  EXPECT_NEAR(cosine, 0., 1e-16);
+  internal::sincos(NAN, &sine, &cosine, SinCosAccuracy::kFast);
+  EXPECT_TRUE(std::isnan(sine));
+  EXPECT_TRUE(std::isnan(cosine));
+}
+
+GTEST_TEST(SinCosTest, BatchRotationBuilders) {
+  const double kTolerance{1e-12};
+  std::vector<double> rolls;
+  std::vector<double> pitches;
+  std::vector<double> yaws;
+  for (int i = 0; i < 150; ++i) {
+    rolls.push_back(0.1 * i - 7.);
+    pitches.push_back(0.05 * i);
+    yaws.push_back(-0.03 * i + 1.);
+  }
+  const Vector3 axis = Vector3(1., -2., 2.) / 3.;
+
+  std::vector<Isometry> rotations(rolls.size());
+  Isometry::rotateAround(axis, rolls.data(), rolls.size(), rotations.data());
+  std::vector<Isometry> eulers(rolls.size());
+  Isometry::fromEulerAngles(rolls.data(), pitches.data(), yaws.data(),
+                            rolls.size(), eulers.data());
+  std::vector<Isometry> fast_eulers(rolls.size());
+  Isometry::fromEulerAngles(rolls.data(), pitches.data(), yaws.data(),
+                            rolls.size(), fast_eulers.data(),
+                            SinCosAccuracy::kFast);
+
+  for (std::size_t i = 0; i < rolls.size(); ++i) {
+    const Matrix3 expected_rotation =
+        Isometry::rotateAround(axis, rolls[i]).rotation();
+    const Matrix3 expected_euler =
+        Isometry::fromEulerAngles(rolls[i], pitches[i], yaws[i]).rotation();
+    for (int row = 0; row < 3; ++row) {
+      for (int col = 0; col < 3; ++col) {
+        EXPECT_NEAR(rotations[i].rotation()[row][col],
+                    expected_rotation[row][col], kTolerance);
+        EXPECT_NEAR(eulers[i].rotation()[row][col], expected_euler[row][col],
+                    kTolerance);
+        EXPECT_NEAR(fast_eulers[i].rotation()[row][col],
+                    expected_euler[row][col], 1e-5);
+      }
+    }
+    EXPECT_EQ(eulers[i].translation(), Vector3::kZero);
+  }
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace math
+}  // namespace ekumen
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,82 @@
+/* Copyright 2020, Ekumen
+ * Static transform library tests
+ * Author: Steven Desvars, 2020
+ */
+
+#include <cmath>
+
+#include <isometry/static_transform.hpp>
+#include "gtest/gtest.h"
+#include "test_utils.hpp"
+
+namespace ekumen {
+namespace math {
+namespace test {
+namespace {
+
+namespace st = static_transform;
+
+constexpr bool isNear(const double value, const double expected) {
+  return st::internal::abs(value - expected) < 1e-15;
+}
+
+// Base to mount to sensor, folded at compile time.
+constexpr Isometry kBaseToMount{st::chain(
+    st::fromTranslation(Vector3(0.2, 0., 0.5)),
+    st::rotateAround(Vector3(0., 0., 1.), M_PI / 2.))};
+constexpr Isometry kMountToSensor{st::chain(
+    st::fromTranslation(Vector3(0., 0.1, 0.)),
+    st::fromEulerAngles(0.1, -0.2, 0.3))};
+constexpr Isometry kBaseToSensor{st::chain(kBaseToMount, kMountToSensor)};
+
+static_assert(isNear(st::sin(M_PI / 6.), 0.5), "sin(pi / 6)");
+static_assert(isNear(st::cos(M_PI / 3.), 0.5), "cos(pi / 3)");
+static_assert(isNear(st::sin(-7. * M_PI / 2.), 1.), "sin(-7 pi / 2)");
+static_assert(isNear(st::cos(3. * M_PI), -1.), "cos(3 pi)");
+constexpr Vector3 kTranslation{kBaseToSensor.translation()};
+static_assert(isNear(kTranslation.x(), 0.1), "Folded translation");
+static_assert(isNear(kTranslation.z(), 0.5), "Folded translation");
+constexpr Vector3 kRoundTrip{st::transform(
+    st::chain(kBaseToMount, st::inverse(kBaseToMount)), Vector3(1., 2., 3.))};
+static_assert(isNear(kRoundTrip.y(), 2.), "Inverse");
+constexpr Vector3 kVector(1., 2., 3.);
+static_assert(kVector[2] == 3., "Vector3 subscript");
+constexpr Matrix3 kMatrix{Vector3(1., 2., 3.), Vector3(4., 5., 6.),
+                          Vector3(7., 8., 9.)};
+static_assert(st::internal::entry(kMatrix.row(1), 1) == 5., "Matrix3 row");
+
+GTEST_TEST(StaticTransformTest, MatchesRuntimeIsometry) {
+  const double kTolerance{1e-15};
+  for (double angle = -20.; angle < 20.; angle += 0.01) {
+    EXPECT_NEAR(st::sin(angle), std::sin(angle), 4 * kTolerance);
+    EXPECT_NEAR(st::cos(angle), std::cos(angle), 4 * kTolerance);
+  }
+
+  const Isometry base_to_sensor{
+      Isometry::fromTranslation(Vector3(0.2, 0., 0.5)) *
+      Isometry::rotateAround(Vector3::kUnitZ, M_PI / 2.) *
+      Isometry::fromTranslation(Vector3(0., 0.1, 0.)) *
+      Isometry::fromEulerAngles(0.1, -0.2, 0.3)};
+  EXPECT_TRUE(areAlmostEqual(kBaseToSensor, base_to_sensor, kTolerance));
+  EXPECT_TRUE(areAlmostEqual(st::inverse(kBaseToSensor),
+                             base_to_sensor.inverse(), kTolerance));
+  EXPECT_TRUE((st::transform(kBaseToSensor, Vector3(1., -2., 3.)) -
+               base_to_sensor * Vector3(1., -2., 3.))
+                  .norm() < kTolerance);
+  EXPECT_TRUE(areAlmostEqual(st::identity(), Isometry(), 0.));
+
+  // The folded value composes with runtime isometries like any other.
+  const Isometry pose{Isometry::rotateAround(Vector3::kUnitX, 0.4)};
+  EXPECT_TRUE(areAlmostEqual(pose * kBaseToSensor, pose * base_to_sensor,
+                             kTolerance));
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace math
+}  // namespace ekumen
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,170 @@
+/* Copyright 2020, Ekumen
+ * Trajectory codec library tests
+ * Author: Steven Desvars, 2020
+ */
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include <isometry/trajectory_codec.hpp>
+#include "gtest/gtest.h"
+
+namespace ekumen {
+namespace math {
+namespace test {
+namespace {
+
+// Angle of the rotation between two isometries.
+double angleBetween(const Isometry& r_a, const Isometry& r_b) {
+  return Isometry{Vector3::kZero,
+                  r_a.rotation().transpose().product(r_b.rotation())}
+      .toRotationVector()
+      .norm();
+}
+
+std::vector<Isometry> trajectory(const std::size_t count) {
+  std::vector<Isometry> poses;
+  for (std::size_t i = 0; i < count; ++i) {
+    const double t = 1e-3 * i;
+    poses.push_back(
+        Isometry::fromTranslation(Vector3(10. * std::sin(t), 2. * t, -0.5)) *
+        Isometry::fromEulerAngles(std::sin(3. * t), 0.7 * t, 5. * t));
+  }
+  // Rotations around each axis by pi, and the identity.
+  poses.push_back(Isometry::rotateAround(Vector3::kUnitX, M_PI));
+  poses.push_back(Isometry::rotateAround(Vector3::kUnitY, M_PI));
+  poses.push_back(Isometry::rotateAround(Vector3::kUnitZ, -M_PI));
+  poses.push_back(Isometry());
+  return poses;
+}
+
+GTEST_TEST(TrajectoryCodecTest, RoundTrip) {
+  const std::vector<Isometry> poses{trajectory(5000)};
+  std::vector<double> timestamps;
+  for (std::size_t i = 0; i < poses.size(); ++i) {
+    timestamps.push_back(1.6e9 + 1e-3 * i + (i % 7 == 0 ? 3e-6 : 0.));
+  }
+  const std::vector<std::uint8_t> encoded{
+      encodeTrajectory(poses.data(), timestamps.data(), poses.size())};
+  // Far below the 104 bytes of a raw timestamp and Isometry.
+  EXPECT_LT(encoded.size(), 14 * poses.size());
+
+  TrajectoryDecoder decoder{encoded.data(), encoded.size()};
+  EXPECT_EQ(decoder.size(), poses.size());
+  EXPECT_TRUE(decoder.hasTimestamps());
+  std::vector<Isometry> decoded(poses.size());
+  std::vector<double> decoded_timestamps(poses.size());
+  // Uneven batches.
+  std::size_t done{0};
+  for (std::size_t batch = 1; decoder.remaining() > 0; batch = batch * 3 + 1) {
+    done += decoder.decode(batch, decoded.data() + done,
+                           decoded_timestamps.data() + done);
+  }
+  EXPECT_EQ(done, poses.size());
+  EXPECT_EQ(decoder.decode(10, decoded.data()), 0u);
+
+  for (std::size_t i = 0; i < poses.size(); ++i) {
+    EXPECT_LE((decoded[i].translation() - poses[i].translation()).norm(),
+              1e-4);
+    EXPECT_LT(angleBetween(decoded[i], poses[i]), 1e-4);
+    EXPECT_NEAR(decoded_timestamps[i], timestamps[i], 5e-7);
+    EXPECT_NEAR(decoded[i].rotation().det(), 1., 1e-12);
+  }
+}
+
+GTEST_TEST(TrajectoryCodecTest, Precision) {
+  const std::vector<Isometry> poses{trajectory(1000)};
+  for (const int bits : {4, 8, 12, 20}) {
+    TrajectoryCodecOptions options;
+    options.rotation_bits = bits;
+    options.translation_resolution = 1e-6;
+    const std::vector<std::uint8_t> encoded{
+        encodeTrajectory(poses.data(), nullptr, poses.size(), options)};
+    TrajectoryDecoder decoder{encoded.data(), encoded.size()};
+    EXPECT_FALSE(decoder.hasTimestamps());
+    std::vector<Isometry> decoded(poses.size());
+    double timestamp;
+    EXPECT_THROW(decoder.decode(1, decoded.data(), &timestamp),
+                 std::logic_error);
+    ASSERT_EQ(decoder.decode(poses.size(), decoded.data()), poses.size());
+    // Each bit halves the step of the quantized components.
+    const double tolerance = 4. * std::sqrt(2.) / ((1 << bits) - 1);
+    for (std::size_t i = 0; i < poses.size(); ++i) {
+      EXPECT_LE((decoded[i].translation() - poses[i].translation()).norm(),
+                1e-6);
+      EXPECT_LT(angleBetween(decoded[i], poses[i]), tolerance) << bits;
+    }
+  }
+}
+
+GTEST_TEST(TrajectoryCodecTest, ExtremeTimestamps) {
+  // Steps between these span more than 63 bits once quantized.
+  const std::vector<Isometry> poses(4);
+  const double timestamps[]{0., 4.6e12, -4.6e12, 4.6e12};
+  const std::vector<std::uint8_t> encoded{
+      encodeTrajectory(poses.data(), timestamps, poses.size())};
+  TrajectoryDecoder decoder{encoded.data(), encoded.size()};
+  std::vector<Isometry> decoded(poses.size());
+  double decoded_timestamps[4];
+  ASSERT_EQ(decoder.decode(poses.size(), decoded.data(), decoded_timestamps),
+            poses.size());
+  for (std::size_t i = 0; i < poses.size(); ++i) {
+    EXPECT_EQ(decoded_timestamps[i], timestamps[i]);
+  }
+}
+
+GTEST_TEST(TrajectoryCodecTest, Validation) {
+  const std::vector<Isometry> poses{trajectory(10)};
+  TrajectoryCodecOptions options;
+  options.rotation_bits = 21;
+  EXPECT_THROW(encodeTrajectory(poses.data(), nullptr, poses.size(), options),
+               std::invalid_argument);
+  options.rotation_bits = 16;
+  options.translation_resolution = 0.;
+  EXPECT_THROW(encodeTrajectory(poses.data(), nullptr, poses.size(), options),
+               std::invalid_argument);
+  const Isometry far{Isometry::fromTranslation(Vector3(1e20, 0., 0.))};
+  EXPECT_THROW(encodeTrajectory(&far, nullptr, 1), std::invalid_argument);
+  const double nan{NAN};
+  EXPECT_THROW(encodeTrajectory(poses.data(), &nan, 1),
+               std::invalid_argument);
+  const Isometry nan_rotation{Vector3::kZero,
+                              Matrix3{Vector3(nan, 0., 0.),
+                                      Vector3(0., 1., 0.),
+                                      Vector3(0., 0., 1.)}};
+  EXPECT_THROW(encodeTrajectory(&nan_rotation, nullptr, 1),
+               std::invalid_argument);
+
+  const std::vector<std::uint8_t> empty{
+      encodeTrajectory(poses.data(), nullptr, 0)};
+  EXPECT_EQ(empty.size(), kTrajectoryCodecHeaderSize);
+  EXPECT_EQ(TrajectoryDecoder(empty.data(), empty.size()).size(), 0u);
+
+  std::vector<std::uint8_t> encoded{
+      encodeTrajectory(poses.data(), nullptr, poses.size())};
+  EXPECT_THROW(TrajectoryDecoder(encoded.data(), encoded.size() - 1),
+               std::invalid_argument);
+  EXPECT_THROW(TrajectoryDecoder(encoded.data(), 10), std::invalid_argument);
+  encoded[0] = 'X';
+  EXPECT_THROW(TrajectoryDecoder(encoded.data(), encoded.size()),
+               std::invalid_argument);
+
+  // A varint cut short by the end of its stream.
+  encoded = encodeTrajectory(poses.data(), nullptr, poses.size());
+  encoded.back() |= 0x80;
+  TrajectoryDecoder decoder{encoded.data(), encoded.size()};
+  std::vector<Isometry> decoded(poses.size());
+  EXPECT_THROW(decoder.decode(poses.size(), decoded.data()),
+               std::invalid_argument);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace math
+}  // namespace ekumen
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,207 @@
+/* Copyright 2020, Ekumen
+ * Trajectory file library tests
+ * Author: Steven Desvars, 2020
+ */
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <system_error>
+
+#include <isometry/trajectory_file.hpp>
+#include "gtest/gtest.h"
+#include "test_utils.hpp"
+
+namespace ekumen {
+namespace math {
+namespace test {
+namespace {
+
+GTEST_TEST(TrajectoryFileTest, WriteAndRead) {
+  const double kTolerance{1e-12};
+  const std::string path{temporaryPath("write_and_read")};
+  {
+    TrajectoryWriter writer{path, 16, 8};
+    for (int i = 0; i < 100; ++i) {
+      writer.append(0.01 * i, motion(0.01 * i));
+    }
+    EXPECT_EQ(writer.size(), 100u);
+    EXPECT_EQ(writer.committed(), 96u);
+    EXPECT_THROW(writer.append(0.5, motion(0.5)), std::invalid_argument);
+    EXPECT_THROW(writer.append(NAN, motion(0.5)), std::invalid_argument);
+    writer.close();
+    EXPECT_EQ(writer.committed(), 100u);
+    EXPECT_THROW(writer.append(2., motion(2.)), std::logic_error);
+  }
+
+  const TrajectoryReader reader{path};
+  ASSERT_EQ(reader.size(), 100u);
+  for (std::size_t i = 0; i < reader.size(); ++i) {
+    EXPECT_EQ(reader.timestamp(i), 0.01 * i);
+    const Isometry expected{motion(0.01 * i)};
+    const Isometry pose{reader.pose(i)};
+    EXPECT_EQ(pose.translation(), expected.translation());
+    EXPECT_EQ(pose.rotation(), expected.rotation());
+  }
+  EXPECT_THROW(reader.pose(100), std::out_of_range);
+  EXPECT_THROW(reader.timestamp(100), std::out_of_range);
+
+  EXPECT_EQ(reader.seek(-1.), 0u);
+  EXPECT_EQ(reader.seek(0.), 0u);
+  EXPECT_EQ(reader.seek(0.125), 13u);
+  EXPECT_EQ(reader.seek(0.01 * 64), 64u);
+  EXPECT_EQ(reader.seek(0.01 * 99), 99u);
+  EXPECT_EQ(reader.seek(1.), 100u);
+  for (std::size_t i = 1; i < reader.size(); ++i) {
+    EXPECT_EQ(reader.seek(0.01 * i - 0.005), i);
+  }
+
+  EXPECT_TRUE(areAlmostEqual(reader.lookup(0.123), motion(0.123),
+                             kTolerance));
+  EXPECT_TRUE(areAlmostEqual(reader.lookup(0.), motion(0.), kTolerance));
+  EXPECT_TRUE(areAlmostEqual(reader.lookup(0.99), motion(0.99), kTolerance));
+  EXPECT_THROW(reader.lookup(0.995), std::out_of_range);
+  EXPECT_THROW(reader.lookup(-0.001), std::out_of_range);
+  std::remove(path.c_str());
+}
+
+GTEST_TEST(TrajectoryFileTest, AppendAfterCrash) {
+  const std::string path{temporaryPath("append_after_crash")};
+  {
+    TrajectoryWriter writer{path, 10, 4};
+    for (int i = 0; i < 25; ++i) {
+      writer.append(i, motion(i));
+    }
+  }
+
+  // A writer that dies without closing loses only what it did not flush.
+  const pid_t child = ::fork();
+  ASSERT_GE(child, 0);
+  if (child == 0) {
+    TrajectoryWriter writer{path, 10, 4};
+    for (int i = 25; i < 50; ++i) {
+      writer.append(i, motion(i));
+    }
+    writer.flush();
+    for (int i = 50; i < 55; ++i) {
+      writer.append(i, motion(i));
+    }
+    ::_exit(0);
+  }
+  int status;
+  ASSERT_EQ(::waitpid(child, &status, 0), child);
+  ASSERT_TRUE(WIFEXITED(status));
+  {
+    // The index was not written, the reader rebuilds it.
+    const TrajectoryReader reader{path};
+    ASSERT_EQ(reader.size(), 50u);
+    EXPECT_EQ(reader.seek(33.5), 34u);
+    EXPECT_EQ(reader.timestamp(49), 49.);
+  }
+
+  // Appending resumes after the last committed record.
+  {
+    TrajectoryWriter writer{path, 10, 4};
+    EXPECT_EQ(writer.size(), 50u);
+    EXPECT_THROW(writer.append(48., motion(48.)), std::invalid_argument);
+    for (int i = 50; i < 60; ++i) {
+      writer.append(i, motion(i));
+    }
+  }
+  const TrajectoryReader reader{path};
+  ASSERT_EQ(reader.size(), 60u);
+  for (std::size_t i = 0; i < reader.size(); ++i) {
+    EXPECT_EQ(reader.timestamp(i), static_cast<double>(i));
+    EXPECT_EQ(reader.seek(i - 0.5), i);
+  }
+  std::remove(path.c_str());
+}
+
+GTEST_TEST(TrajectoryFileTest, RetriesFailedFlushes) {
+  const std::string path{temporaryPath("failed_flush")};
+  // Room for the header and six records: the second flush of four fails.
+  struct rlimit limit;
+  ASSERT_EQ(::getrlimit(RLIMIT_FSIZE, &limit), 0);
+  const rlim_t previous_limit{limit.rlim_cur};
+  limit.rlim_cur = kTrajectoryHeaderSize + 6 * kTrajectoryRecordSize;
+  void (*const previous_handler)(int) = std::signal(SIGXFSZ, SIG_IGN);
+  ASSERT_EQ(::setrlimit(RLIMIT_FSIZE, &limit), 0);
+  {
+    TrajectoryWriter writer{path, 4, 4};
+    for (int i = 0; i < 7; ++i) {
+      writer.append(i, motion(i));
+    }
+    EXPECT_THROW(writer.append(7., motion(7.)), std::system_error);
+    EXPECT_EQ(writer.committed(), 4u);
+    EXPECT_EQ(writer.size(), 8u);
+    // The buffer is full, the retried flush fails before storing anything.
+    EXPECT_THROW(writer.append(8., motion(8.)), std::system_error);
+    EXPECT_EQ(writer.size(), 8u);
+
+    limit.rlim_cur = previous_limit;
+    ASSERT_EQ(::setrlimit(RLIMIT_FSIZE, &limit), 0);
+    writer.append(8., motion(8.));
+    EXPECT_EQ(writer.committed(), 8u);
+    writer.close();
+  }
+  std::signal(SIGXFSZ, previous_handler);
+
+  const TrajectoryReader reader{path};
+  ASSERT_EQ(reader.size(), 9u);
+  for (std::size_t i = 0; i < reader.size(); ++i) {
+    EXPECT_EQ(reader.timestamp(i), static_cast<double>(i));
+    EXPECT_TRUE(areEqual(reader.pose(i), motion(i)));
+  }
+  std::remove(path.c_str());
+}
+
+GTEST_TEST(TrajectoryFileTest, Validation) {
+  const std::string path{temporaryPath("validation")};
+  EXPECT_THROW(TrajectoryReader{path}, std::system_error);
+  EXPECT_THROW(TrajectoryWriter(path, 0), std::invalid_argument);
+  {
+    std::ofstream file{path};
+    file << "not a trajectory file, but long enough to hold a header......";
+  }
+  EXPECT_THROW(TrajectoryReader{path}, std::invalid_argument);
+  EXPECT_THROW(TrajectoryWriter{path}, std::invalid_argument);
+  std::remove(path.c_str());
+
+  {
+    TrajectoryWriter writer{path};
+    writer.append(1., Isometry());
+  }
+  // A count beyond the records is rejected.
+  {
+    std::fstream file{path, std::ios::in | std::ios::out | std::ios::binary};
+    file.seekp(16);
+    file.put(2);
+  }
+  EXPECT_THROW(TrajectoryReader{path}, std::invalid_argument);
+  std::remove(path.c_str());
+
+  {
+    TrajectoryWriter writer{path};
+  }
+  const TrajectoryReader reader{path};
+  EXPECT_TRUE(reader.empty());
+  EXPECT_EQ(reader.seek(0.), 0u);
+  EXPECT_THROW(reader.lookup(0.), std::out_of_range);
+  std::remove(path.c_str());
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace math
+}  // namespace ekumen
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,158 @@
+/* Copyright 2020, Ekumen
+ * Text trajectory library tests
+ * Author: Steven Desvars, 2020
+ */
+
+#include <unistd.h>
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <isometry/trajectory_text.hpp>
+#include "gtest/gtest.h"
+#include "test_utils.hpp"
+
+namespace ekumen {
+namespace math {
+namespace test {
+namespace {
+
+void writeFile(const std::string& r_path, const std::string& r_text) {
+  std::ofstream file{r_path, std::ios::binary | std::ios::trunc};
+  file << r_text;
+}
+
+std::string malformedMessage(const std::string& r_path,
+                             const TrajectoryTextFormat format,
+                             const std::size_t threads) {
+  try {
+    loadTrajectoryText(r_path, format, threads);
+  } catch (const std::invalid_argument& r_error) {
+    return r_error.what();
+  }
+  return "";
+}
+
+GTEST_TEST(TrajectoryTextTest, TumRoundTripsOnAnyNumberOfThreads) {
+  const std::string path{temporaryPath("tum")};
+  std::vector<double> timestamps;
+  std::vector<Isometry> poses;
+  for (int i = 0; i < 1000; ++i) {
+    timestamps.push_back(1305031102.175304 + 0.01 * i);
+    poses.push_back(motion(0.037 * i));
+  }
+  saveTrajectoryText(path, TrajectoryTextFormat::kTum, poses.data(),
+                     timestamps.data(), poses.size(), 3);
+  for (const std::size_t threads : {1u, 2u, 7u, 0u}) {
+    const TextTrajectory trajectory{
+        loadTrajectoryText(path, TrajectoryTextFormat::kTum, threads)};
+    ASSERT_EQ(trajectory.poses.size(), poses.size());
+    ASSERT_EQ(trajectory.timestamps.size(), poses.size());
+    for (std::size_t i = 0; i < poses.size(); ++i) {
+      EXPECT_EQ(trajectory.timestamps[i], timestamps[i]);
+      EXPECT_TRUE(areAlmostEqual(trajectory.poses[i], poses[i], 1e-14));
+    }
+  }
+  std::remove(path.c_str());
+}
+
+GTEST_TEST(TrajectoryTextTest, KittiRoundTripsExactly) {
+  const std::string path{temporaryPath("kitti")};
+  std::vector<Isometry> poses;
+  for (int i = 0; i < 500; ++i) {
+    poses.push_back(motion(0.11 * i));
+  }
+  saveTrajectoryText(path, TrajectoryTextFormat::kKitti, poses.data(),
+                     nullptr, poses.size(), 4);
+  const TextTrajectory trajectory{
+      loadTrajectoryText(path, TrajectoryTextFormat::kKitti, 5)};
+  EXPECT_TRUE(trajectory.timestamps.empty());
+  ASSERT_EQ(trajectory.poses.size(), poses.size());
+  for (std::size_t i = 0; i < poses.size(); ++i) {
+    EXPECT_TRUE(areAlmostEqual(trajectory.poses[i], poses[i], 0.));
+  }
+  std::remove(path.c_str());
+}
+
+GTEST_TEST(TrajectoryTextTest, SkipsHeadersCommentsAndBlankLines) {
+  const std::string path{temporaryPath("csv")};
+  writeFile(path,
+            "timestamp,tx,ty,tz,qx,qy,qz,qw\r\n"
+            "# recorded on the test track\r\n"
+            "\r\n"
+            "1.5, 1, 2, 3, 0, 0, 0, 2\r\n"
+            "2.5,-1,0,0,0,0,1,0");
+  const TextTrajectory csv{
+      loadTrajectoryText(path, TrajectoryTextFormat::kCsv, 2)};
+  ASSERT_EQ(csv.poses.size(), 2u);
+  EXPECT_EQ(csv.timestamps[0], 1.5);
+  EXPECT_TRUE(areAlmostEqual(
+      csv.poses[0], Isometry::fromTranslation(Vector3(1., 2., 3.)), 0.));
+  EXPECT_EQ(csv.timestamps[1], 2.5);
+  EXPECT_TRUE(areAlmostEqual(
+      csv.poses[1],
+      Isometry::fromTranslation(Vector3(-1., 0., 0.)) *
+          Isometry::rotateAround(Vector3(0., 0., 1.), M_PI),
+      1e-15));
+
+  writeFile(path,
+            "P0: 7 0 6 0 0 7 1 0 0 0 1 0\n"
+            "Tr: 1 0 0 0.5\t0 1 0 -0.25 0 0 1 2\n");
+  const TextTrajectory calibration{
+      loadTrajectoryText(path, TrajectoryTextFormat::kKitti)};
+  ASSERT_EQ(calibration.poses.size(), 2u);
+  EXPECT_TRUE(areAlmostEqual(
+      calibration.poses[1],
+      Isometry::fromTranslation(Vector3(0.5, -0.25, 2.)), 0.));
+
+  writeFile(path, "");
+  EXPECT_TRUE(
+      loadTrajectoryText(path, TrajectoryTextFormat::kTum).poses.empty());
+  std::remove(path.c_str());
+}
+
+GTEST_TEST(TrajectoryTextTest, ReportsTheMalformedLine) {
+  const std::string path{temporaryPath("malformed")};
+  std::string text;
+  for (int i = 0; i < 200; ++i) {
+    text += std::to_string(i) + " 0 0 0 0 0 0 1\n";
+  }
+  writeFile(path, text + "200 0 0 0 0 0 0\n");
+  EXPECT_EQ(malformedMessage(path, TrajectoryTextFormat::kTum, 4),
+            "Malformed trajectory line 201");
+  writeFile(path, text + "200 0 0 0 0 0 0 1 9\n");
+  EXPECT_EQ(malformedMessage(path, TrajectoryTextFormat::kTum, 3),
+            "Malformed trajectory line 201");
+  writeFile(path, "# zero quaternion\n0 0 0 0 0 0 0 0\n");
+  EXPECT_EQ(malformedMessage(path, TrajectoryTextFormat::kTum, 1),
+            "Malformed trajectory line 2");
+  writeFile(path, "P0 1 0 0 0 0 1 0 0 0 0 1 0\n");
+  EXPECT_EQ(malformedMessage(path, TrajectoryTextFormat::kKitti, 1),
+            "Malformed trajectory line 1");
+  writeFile(path, "0;0;0;0;0;0;0;1\n");
+  EXPECT_EQ(malformedMessage(path, TrajectoryTextFormat::kCsv, 1),
+            "Malformed trajectory line 1");
+  std::remove(path.c_str());
+
+  EXPECT_THROW(loadTrajectoryText(path, TrajectoryTextFormat::kTum),
+               std::system_error);
+  const Isometry pose;
+  EXPECT_THROW(saveTrajectoryText(path, TrajectoryTextFormat::kTum, &pose,
+                                  nullptr, 1),
+               std::invalid_argument);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace math
+}  // namespace ekumen
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,134 @@
+/* Copyright 2020, Ekumen
+ * Transform buffer library tests
+ * Author: Steven Desvars, 2020
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <isometry/transform_buffer.hpp>
+#include "gtest/gtest.h"
+#include "test_utils.hpp"
+
+namespace ekumen {
+namespace math {
+namespace test {
+namespace {
+
+GTEST_TEST(TransformBufferTest, Interpolation) {
+  const double kTolerance{1e-12};
+  TransformBuffer buffer{8, 0.05};
+  EXPECT_TRUE(buffer.empty());
+  EXPECT_ANY_THROW(buffer.lookup(0.));
+
+  buffer.insert(1., motion(1.));
+  EXPECT_TRUE(areAlmostEqual(buffer.lookup(1.02), motion(1.), kTolerance));
+  for (int i = 1; i < 5; ++i) {
+    buffer.insert(1. + 0.1 * i, motion(1. + 0.1 * i));
+  }
+  EXPECT_EQ(buffer.size(), 5u);
+  EXPECT_EQ(buffer.oldestTime(), 1.);
+  EXPECT_NEAR(buffer.newestTime(), 1.4, kTolerance);
+
+  for (const double time : {1., 1.05, 1.1, 1.234, 1.3999, 1.4}) {
+    EXPECT_TRUE(areAlmostEqual(buffer.lookup(time), motion(time), kTolerance));
+  }
+  // Extrapolation within the horizon only.
+  EXPECT_TRUE(areAlmostEqual(buffer.lookup(1.44), motion(1.44), kTolerance));
+  EXPECT_TRUE(areAlmostEqual(buffer.lookup(0.96), motion(0.96), kTolerance));
+  EXPECT_ANY_THROW(buffer.lookup(1.46));
+  EXPECT_ANY_THROW(buffer.lookup(0.94));
+
+  EXPECT_ANY_THROW(buffer.insert(1.2, motion(1.2)));
+  buffer.insert(1.4, motion(0.));
+  EXPECT_EQ(buffer.size(), 5u);
+  EXPECT_TRUE(areAlmostEqual(buffer.lookup(1.4), motion(0.), kTolerance));
+
+  buffer.clear();
+  EXPECT_TRUE(buffer.empty());
+  EXPECT_ANY_THROW(TransformBuffer(0));
+  EXPECT_ANY_THROW(TransformBuffer(4, -1.));
+}
+
+GTEST_TEST(TransformBufferTest, RingBuffer) {
+  const double kTolerance{1e-12};
+  TransformBuffer buffer{4};
+  for (int i = 0; i < 11; ++i) {
+    buffer.insert(i, motion(i));
+  }
+  EXPECT_EQ(buffer.size(), 4u);
+  EXPECT_EQ(buffer.capacity(), 4u);
+  EXPECT_EQ(buffer.oldestTime(), 7.);
+  EXPECT_EQ(buffer.newestTime(), 10.);
+  for (std::size_t i = 0; i < buffer.size(); ++i) {
+    EXPECT_EQ(buffer.timestamp(i), 7. + i);
+    EXPECT_EQ(buffer.transform(i), motion(7. + i));
+  }
+  EXPECT_TRUE(areAlmostEqual(buffer.lookup(8.5), motion(8.5), kTolerance));
+  EXPECT_ANY_THROW(buffer.lookup(6.5));
+  EXPECT_ANY_THROW(buffer.timestamp(4));
+}
+
+GTEST_TEST(TransformBufferTest, BatchLookup) {
+  const double kTolerance{1e-12};
+  TransformBuffer buffer{16, 0.05};
+  std::vector<Isometry> out(4);
+  EXPECT_THROW(buffer.lookup(std::vector<double>{0.}.data(), 1, out.data()),
+               std::out_of_range);
+  buffer.insert(1., motion(1.));
+  const std::vector<double> single{0.97, 1., 1.03};
+  buffer.lookup(single.data(), single.size(), out.data());
+  for (std::size_t i = 0; i < single.size(); ++i) {
+    EXPECT_EQ(out[i], motion(1.));
+  }
+  for (int i = 1; i < 10; ++i) {
+    buffer.insert(1. + 0.1 * i, motion(1. + 0.1 * i));
+  }
+
+  // Sorted, spanning many samples with several queries per interval, exact
+  // sample times, repeated times and extrapolation at both ends.
+  std::vector<double> times;
+  for (double time = 0.96; time <= 1.94; time += 0.0037) {
+    times.push_back(time);
+  }
+  times.push_back(1.94);
+  times.insert(times.begin() + 40, times[40]);
+  times.insert(times.begin() + 41, 1.1);
+  std::sort(times.begin(), times.end());
+  out.resize(times.size());
+  buffer.lookup(times.data(), times.size(), out.data());
+  for (std::size_t i = 0; i < times.size(); ++i) {
+    EXPECT_TRUE(areAlmostEqual(out[i], buffer.lookup(times[i]), kTolerance));
+    EXPECT_TRUE(areAlmostEqual(out[i], motion(times[i]), kTolerance));
+  }
+  buffer.lookup(times.data(), times.size(), out.data(),
+                SinCosAccuracy::kFast);
+  for (std::size_t i = 0; i < times.size(); ++i) {
+    EXPECT_TRUE(areAlmostEqual(out[i], motion(times[i]), 1e-6));
+  }
+
+  // Unsorted times are answered in their own order.
+  const std::vector<double> shuffled{1.55, 1.02, 1.9, 1.3, 1.02, 0.99};
+  buffer.lookup(shuffled.data(), shuffled.size(), out.data());
+  for (std::size_t i = 0; i < shuffled.size(); ++i) {
+    EXPECT_TRUE(areAlmostEqual(out[i], motion(shuffled[i]), kTolerance));
+  }
+
+  // Nothing is written when a time is out of range.
+  const std::vector<double> beyond{1.2, 1.3, 2.};
+  out.assign(beyond.size(), Isometry());
+  EXPECT_THROW(buffer.lookup(beyond.data(), beyond.size(), out.data()),
+               std::out_of_range);
+  EXPECT_EQ(out[0], Isometry());
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace math
+}  // namespace ekumen
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,175 @@
+/* Copyright 2020, Ekumen
+ * Transform snapshot library tests
+ * Author: Steven Desvars, 2020
+ */
+
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <isometry/binary.hpp>
+#include <isometry/transform_snapshot.hpp>
+#include "gtest/gtest.h"
+#include "test_utils.hpp"
+
+namespace ekumen {
+namespace math {
+namespace test {
+namespace {
+
+std::vector<char> readFile(const std::string& r_path) {
+  std::ifstream file{r_path, std::ios::binary};
+  return std::vector<char>(std::istreambuf_iterator<char>(file),
+                           std::istreambuf_iterator<char>());
+}
+
+void writeFile(const std::string& r_path, const std::vector<char>& r_bytes) {
+  std::ofstream file{r_path, std::ios::binary | std::ios::trunc};
+  file.write(r_bytes.data(), static_cast<std::streamsize>(r_bytes.size()));
+}
+
+// Recomputes the checksum of an edited snapshot, 64-bit FNV-1a over the
+// little-endian words after the header, then over the trailing bytes.
+void resign(std::vector<char>* r_bytes) {
+  const unsigned char* bytes =
+      reinterpret_cast<const unsigned char*>(r_bytes->data());
+  std::uint64_t hash{14695981039346656037ull};
+  std::size_t i = kTransformSnapshotHeaderSize;
+  for (; i + 8 <= r_bytes->size(); i += 8) {
+    hash = (hash ^ internal::loadInteger(bytes + i, 8)) * 1099511628211ull;
+  }
+  for (; i < r_bytes->size(); ++i) {
+    hash = (hash ^ bytes[i]) * 1099511628211ull;
+  }
+  internal::storeInteger(hash, 8,
+                         reinterpret_cast<unsigned char*>(r_bytes->data()) +
+                             40);
+}
+
+FrameTree robotTree() {
+  FrameTree tree{"map"};
+  tree.addFrame("odom", "map", Isometry::fromTranslation(Vector3(1., 2., 0.)));
+  tree.addFrame("base", "odom", Isometry::fromEulerAngles(0., 0., 0.3));
+  tree.addFrame("lidar", "base",
+                Isometry::fromTranslation(Vector3(0.2, 0., 0.5)) *
+                    Isometry::rotateAround(Vector3(0., 0.6, 0.8), 0.1));
+  tree.addFrame("camera", "base", Isometry::fromEulerAngles(-1.5, 0.1, 0.7));
+  return tree;
+}
+
+GTEST_TEST(TransformSnapshotTest, RestoresTreeAndBuffers) {
+  const std::string path{temporaryPath("restore")};
+  const FrameTree tree{robotTree()};
+  TransformBuffer odometry{4, 0.25};
+  for (int i = 0; i < 7; ++i) {
+    odometry.insert(0.1 * i, Isometry::fromEulerAngles(0., 0., 0.05 * i));
+  }
+  const TransformBuffer empty{16};
+  saveTransformSnapshot(path, tree, {{"odom", &odometry}, {"arm", &empty}});
+
+  const TransformSnapshot snapshot{loadTransformSnapshot(path)};
+  ASSERT_EQ(snapshot.tree.size(), tree.size());
+  EXPECT_FALSE(snapshot.tree.stale());
+  for (std::size_t i = 0; i < tree.size(); ++i) {
+    const FrameId frame{i};
+    EXPECT_EQ(snapshot.tree.name(frame), tree.name(frame));
+    EXPECT_TRUE(
+        areEqual(snapshot.tree.transform(frame), tree.transform(frame)));
+    if (frame != tree.root()) {
+      EXPECT_EQ(snapshot.tree.parent(frame), tree.parent(frame));
+    }
+  }
+  EXPECT_TRUE(areEqual(snapshot.tree.lookup("camera", "lidar"),
+                       tree.lookup("camera", "lidar")));
+
+  ASSERT_EQ(snapshot.buffers.size(), 2u);
+  EXPECT_EQ(snapshot.buffer_names[0], "odom");
+  EXPECT_EQ(snapshot.buffer_names[1], "arm");
+  const TransformBuffer& r_restored = snapshot.buffers[0];
+  EXPECT_EQ(r_restored.capacity(), 4u);
+  EXPECT_EQ(r_restored.maxExtrapolation(), 0.25);
+  ASSERT_EQ(r_restored.size(), odometry.size());
+  for (std::size_t i = 0; i < odometry.size(); ++i) {
+    EXPECT_EQ(r_restored.timestamp(i), odometry.timestamp(i));
+    EXPECT_TRUE(areEqual(r_restored.transform(i), odometry.transform(i)));
+  }
+  EXPECT_EQ(snapshot.buffers[1].capacity(), 16u);
+  EXPECT_TRUE(snapshot.buffers[1].empty());
+  std::remove(path.c_str());
+}
+
+GTEST_TEST(TransformSnapshotTest, ReplacesPreviousSnapshots) {
+  const std::string path{temporaryPath("replace")};
+  saveTransformSnapshot(path, robotTree());
+  saveTransformSnapshot(path, FrameTree("world"));
+  const TransformSnapshot snapshot{loadTransformSnapshot(path)};
+  EXPECT_EQ(snapshot.tree.size(), 1u);
+  EXPECT_EQ(snapshot.tree.name(snapshot.tree.root()), "world");
+  EXPECT_TRUE(snapshot.buffers.empty());
+  std::ifstream temporary{path + ".tmp"};
+  EXPECT_FALSE(temporary.good());
+  std::remove(path.c_str());
+}
+
+GTEST_TEST(TransformSnapshotTest, RejectsDamagedFiles) {
+  const std::string path{temporaryPath("damaged")};
+  EXPECT_THROW(loadTransformSnapshot(path), std::system_error);
+  EXPECT_THROW(saveTransformSnapshot(path, robotTree(), {{"null", nullptr}}),
+               std::invalid_argument);
+
+  saveTransformSnapshot(path, robotTree());
+  const std::vector<char> bytes{readFile(path)};
+  std::vector<char> damaged{bytes};
+  damaged[kTransformSnapshotHeaderSize + 20] ^= 1;
+  writeFile(path, damaged);
+  EXPECT_THROW(loadTransformSnapshot(path), std::invalid_argument);
+
+  damaged = bytes;
+  damaged.pop_back();
+  writeFile(path, damaged);
+  EXPECT_THROW(loadTransformSnapshot(path), std::invalid_argument);
+
+  damaged = bytes;
+  damaged[0] = 'X';
+  writeFile(path, damaged);
+  EXPECT_THROW(loadTransformSnapshot(path), std::invalid_argument);
+
+  // A buffer larger than any snapshot holds, with a valid checksum.
+  const FrameTree tree{robotTree()};
+  const TransformBuffer buffer{4};
+  saveTransformSnapshot(path, tree, {{"odom", &buffer}});
+  damaged = readFile(path);
+  resign(&damaged);
+  ASSERT_EQ(damaged, readFile(path));
+  const std::size_t capacity_offset{kTransformSnapshotHeaderSize +
+                                    tree.size() * (16 + 12 * sizeof(double)) +
+                                    8};
+  internal::storeInteger(
+      std::uint64_t{1} << 60, 8,
+      reinterpret_cast<unsigned char*>(damaged.data()) + capacity_offset);
+  resign(&damaged);
+  writeFile(path, damaged);
+  EXPECT_THROW(loadTransformSnapshot(path), std::invalid_argument);
+
+  damaged.resize(10);
+  writeFile(path, damaged);
+  EXPECT_THROW(loadTransformSnapshot(path), std::invalid_argument);
+  std::remove(path.c_str());
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace math
+}  // namespace ekumen
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
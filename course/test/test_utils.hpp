@@ -0,0 +1,70 @@
+/* Copyright 2020, Ekumen
+ * Helpers shared by the library tests
+ * Author: Steven Desvars, 2020
+ */
+
+#pragma once
+
+#include <unistd.h>
+
+#include <cmath>
+#include <cstdio>
+#include <string>
+
+#include <isometry/isometry.hpp>
+#include "gtest/gtest.h"
+
+namespace ekumen {
+namespace math {
+namespace test {
+
+inline testing::AssertionResult areAlmostEqual(const Matrix3 &obj1,
+                                               const Matrix3 &obj2,
+                                               const double tolerance) {
+  for (int i = 0; i < 3; ++i) {
+    for (int j = 0; j < 3; ++j) {
+      if (std::abs(obj1[i][j] - obj2[i][j]) > tolerance) {
+        return testing::AssertionFailure() << "The matrices differ";
+      }
+    }
+  }
+  return testing::AssertionSuccess();
+}
+
+inline testing::AssertionResult areAlmostEqual(const Isometry &obj1,
+                                               const Isometry &obj2,
+                                               const double tolerance) {
+  for (int i = 0; i < 3; ++i) {
+    if (std::abs(obj1.translation()[i] - obj2.translation()[i]) > tolerance) {
+      return testing::AssertionFailure() << "The translations differ";
+    }
+  }
+  if (!areAlmostEqual(obj1.rotation(), obj2.rotation(), tolerance)) {
+    return testing::AssertionFailure() << "The rotations differ";
+  }
+  return testing::AssertionSuccess();
+}
+
+/// Exact comparison, for poses that must round trip bit for bit.
+inline bool areEqual(const Isometry &obj1, const Isometry &obj2) {
+  return static_cast<bool>(areAlmostEqual(obj1, obj2, 0.));
+}
+
+/// Pose at @p time of a constant linear and angular velocity motion.
+inline Isometry motion(const double time) {
+  return Isometry{Vector3(2. * time, -time, 0.5),
+                  Isometry::rotateAround(Vector3(0., 0.6, 0.8), 0.9 * time)
+                      .rotation()};
+}
+
+/// Path of a file under /tmp unique to this process, removed if it exists.
+inline std::string temporaryPath(const std::string &r_name) {
+  const std::string path{"/tmp/" + r_name + "_" +
+                         std::to_string(::getpid())};
+  std::remove(path.c_str());
+  return path;
+}
+
+}  // namespace test
+}  // namespace math
+}  // namespace ekumen
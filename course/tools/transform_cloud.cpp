@@ -0,0 +1,70 @@
+/* Copyright 2020, Ekumen
+ * Point cloud transform tool
+ * Author: Steven Desvars, 2020
+ *
+ * Streams a binary PLY or XYZ point cloud through an isometry:
+ *   transform_cloud <input> <output> <x> <y> <z> <roll> <pitch> <yaw>
+ *                   [chunk points]
+ * Angles are in radians, applied as in Isometry::fromEulerAngles().
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+
+#include <isometry/internal/parse_double.hpp>
+#include <isometry/point_cloud_stream.hpp>
+
+namespace {
+
+using ekumen::math::CloudTransformStats;
+using ekumen::math::Isometry;
+using ekumen::math::Vector3;
+
+// Largest chunk accepted, far more than any useful one.
+const double kMaxChunkPoints{1073741824.};
+
+bool parseNumber(const char* text, double* r_value) {
+  const char* end = text + std::strlen(text);
+  return ekumen::math::internal::parseDouble(text, end, r_value) == end;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc != 9 && argc != 10) {
+    std::fprintf(stderr,
+                 "Usage: %s <input> <output> <x> <y> <z> <roll> <pitch> "
+                 "<yaw> [chunk points]\n",
+                 argv[0]);
+    return 2;
+  }
+  double values[7]{0., 0., 0., 0., 0., 0.,
+                   static_cast<double>(ekumen::math::kDefaultCloudChunkPoints)};
+  for (int i = 3; i < argc; ++i) {
+    if (!parseNumber(argv[i], &values[i - 3])) {
+      std::fprintf(stderr, "Not a number: %s\n", argv[i]);
+      return 2;
+    }
+  }
+  if (!(values[6] >= 1. && values[6] <= kMaxChunkPoints) ||
+      values[6] != std::floor(values[6])) {
+    std::fprintf(stderr, "Chunks must hold a whole number of points, from 1 "
+                         "to %.0f\n",
+                 kMaxChunkPoints);
+    return 2;
+  }
+  const Isometry isometry{
+      Isometry::fromTranslation(Vector3(values[0], values[1], values[2])) *
+      Isometry::fromEulerAngles(values[3], values[4], values[5])};
+  try {
+    const CloudTransformStats stats{ekumen::math::transformCloud(
+        argv[1], argv[2], isometry, static_cast<std::size_t>(values[6]))};
+    std::printf("%zu points in %zu chunks\n", stats.points, stats.chunks);
+  } catch (const std::exception& r_error) {
+    std::fprintf(stderr, "%s\n", r_error.what());
+    return 1;
+  }
+  return 0;
+}